@@ -43,11 +43,13 @@ public:
 
   QWidget *GetControlWidget() noexcept final { return nullptr; }
 
-  void NextTick() noexcept final {
+  bool NextTick() noexcept final {
+    std::uint8_t previousFrameId = TauntFrameSequence[m_CurrentTick / 3];
     m_CurrentTick += 1;
     if (m_CurrentTick / 3 >= cw::countof(TauntFrameSequence)) {
       m_CurrentTick = 0;
     }
+    return TauntFrameSequence[m_CurrentTick / 3] != previousFrameId;
   }
 
   void Rewind() noexcept final {
@@ -62,7 +64,10 @@ public:
     return true;
   }
 
-  void Draw(GLFunctions* f) noexcept final {
+  void Draw(GLFunctions* f, wgc0310::WGAPIScreenViewport const& viewport) noexcept final {
+    // a full screen quad looks the same at any resolution
+    Q_UNUSED(viewport)
+
     std::uint8_t frameId = TauntFrameSequence[m_CurrentTick / 3];
     cw::Texture2D *texture = m_TexturePack[frameId].get();
 
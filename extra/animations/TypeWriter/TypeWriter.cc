@@ -19,7 +19,7 @@ public:
 
   QWidget *GetControlWidget() noexcept final { return m_ControlWidget.get(); }
 
-  void NextTick() noexcept final {}
+  bool NextTick() noexcept final { return m_NeedsUpdate; }
 
   void Rewind() noexcept final {}
 
@@ -28,7 +28,10 @@ public:
     return true;
   }
 
-  void Draw(GLFunctions* f) noexcept final {
+  void Draw(GLFunctions* f, wgc0310::WGAPIScreenViewport const& viewport) noexcept final {
+    // a full screen quad looks the same at any resolution
+    Q_UNUSED(viewport)
+
     if (m_NeedsUpdate) {
       m_Texture->UpdateContent(f, m_ControlWidget->capture());
       m_NeedsUpdate = false;
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "cwglx/Object/ObjParser.h"
+#include "util/FileUtil.h"
+
+// Parses the way `cw::LoadObject` did before `cw::ParseObj`: a `QString` for
+// the whole file, a `QStringList` per line and per face vertex
+static std::size_t LegacyParse(QByteArray const& source) {
+  std::vector<glm::vec3> vertexCoords;
+  std::vector<glm::vec3> vertexNormals;
+  std::vector<glm::vec2> texCoords;
+  std::vector<int> indices;
+
+  QString fileContent = QString::fromUtf8(source);
+  QStringList fileLines = fileContent.split('\n');
+  for (QString const& line : fileLines) {
+    QString trimmed = line.trimmed();
+    if (trimmed.isEmpty() || trimmed.startsWith('#')) {
+      continue;
+    }
+
+    QStringList parts = trimmed.split(' ');
+    QString command = parts[0].toLower();
+    if (command == "v" && parts.length() == 4) {
+      vertexCoords.emplace_back(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat());
+    } else if (command == "vn" && parts.length() == 4) {
+      vertexNormals.emplace_back(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat());
+    } else if (command == "vt" && parts.length() == 3) {
+      texCoords.emplace_back(parts[1].toFloat(), parts[2].toFloat());
+    } else if (command == "f" && parts.length() == 4) {
+      for (int i = 1; i < 4; ++i) {
+        QStringList vertexParts = parts[i].split('/');
+        for (QString const& vertexPart : vertexParts) {
+          indices.push_back(vertexPart.toInt() - 1);
+        }
+      }
+    }
+  }
+
+  return indices.size() / 9;
+}
+
+// A (columns x rows) grid of quads, two triangles each, in the layout the
+// usual exporters produce
+static QByteArray GenerateObj(int columns, int rows) {
+  std::string ret;
+  char buffer[128];
+
+  for (int row = 0; row <= rows; row++) {
+    for (int column = 0; column <= columns; column++) {
+      int length = std::snprintf(buffer, sizeof(buffer),
+                                 "v %.6f %.6f %.6f\n",
+                                 column * 0.01, row * 0.01, (column ^ row) % 7 * 0.001);
+      ret.append(buffer, static_cast<std::size_t>(length));
+    }
+  }
+  for (int row = 0; row <= rows; row++) {
+    for (int column = 0; column <= columns; column++) {
+      int length = std::snprintf(buffer, sizeof(buffer),
+                                 "vt %.6f %.6f\n",
+                                 static_cast<double>(column) / columns,
+                                 static_cast<double>(row) / rows);
+      ret.append(buffer, static_cast<std::size_t>(length));
+    }
+  }
+  ret.append("vn 0.000000 0.000000 1.000000\n");
+
+  for (int row = 0; row < rows; row++) {
+    for (int column = 0; column < columns; column++) {
+      int v0 = row * (columns + 1) + column + 1;
+      int v1 = v0 + 1;
+      int v2 = v0 + columns + 1;
+      int v3 = v2 + 1;
+      int length = std::snprintf(buffer, sizeof(buffer),
+                                 "f %d/%d/1 %d/%d/1 %d/%d/1\n"
+                                 "f %d/%d/1 %d/%d/1 %d/%d/1\n",
+                                 v0, v0, v1, v1, v3, v3,
+                                 v0, v0, v3, v3, v2, v2);
+      ret.append(buffer, static_cast<std::size_t>(length));
+    }
+  }
+
+  return QByteArray(ret.data(), static_cast<qsizetype>(ret.size()));
+}
+
+int main(int argc, char *argv[]) {
+  QByteArray source;
+  if (argc > 1) {
+    std::unique_ptr<cw::MappedFile> file = cw::MappedFile::Open(QString::fromLocal8Bit(argv[1]));
+    if (!file) {
+      return 1;
+    }
+    source = QByteArray(file->GetView().data(), static_cast<qsizetype>(file->GetView().size()));
+  } else {
+    // 1000 x 500 quads, 1M triangles
+    source = GenerateObj(1000, 500);
+  }
+  std::printf("source: %.1f MiB\n", static_cast<double>(source.size()) / (1024.0 * 1024.0));
+
+  std::string_view view { source.constData(), static_cast<std::size_t>(source.size()) };
+  QElapsedTimer timer;
+
+  timer.start();
+  std::size_t legacyTriangles = LegacyParse(source);
+  std::printf("QString parser:       %6lld ms, %zu triangles\n",
+              static_cast<long long>(timer.elapsed()),
+              legacyTriangles);
+
+  for (std::size_t threadCount : { std::size_t(1), std::size_t(0) }) {
+    timer.restart();
+    cw::ObjData data = cw::ParseObj(view, threadCount);
+    std::printf("ParseObj (%s): %6lld ms, %zu triangles\n",
+                threadCount == 1 ? "1 thread " : "all cores",
+                static_cast<long long>(timer.elapsed()),
+                data.faceVertices.size() / 3);
+  }
+
+  return 0;
+}
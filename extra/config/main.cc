@@ -154,6 +154,14 @@ public:
         hBox->addWidget(msaa8);
       }
 
+      QCheckBox *fxaa = new QCheckBox("使用后处理抗锯齿 (FXAA) 代替多重采样");
+      fxaa->setToolTip("开销远低于多重采样，适合集成显卡，画面略微模糊");
+      fxaa->setChecked(cw::GlobalConfig::Instance.fxaa);
+      connect(fxaa, &QCheckBox::toggled, this, [] (bool enabled) {
+        cw::GlobalConfig::Instance.fxaa = enabled;
+      });
+      vBox->addWidget(fxaa);
+
       QCheckBox *lineSmooth = new QCheckBox("启用线条平滑");
       lineSmooth->setChecked(cw::GlobalConfig::Instance.lineSmoothHint);
       connect(lineSmooth, &QCheckBox::toggled, this, [] (bool enabled) {
@@ -188,6 +196,81 @@ public:
         hBox->addWidget(linearSampling);
         hBox->addWidget(nearestSampling);
       }
+
+      {
+        QHBoxLayout *hBox = new QHBoxLayout();
+        vBox->addLayout(hBox);
+
+        hBox->addWidget(new QLabel("画面无变化时的最低刷新率 (0=不刷新)"));
+        hBox->addStretch();
+
+        QSpinBox *keepAliveFps = new QSpinBox();
+        keepAliveFps->setMinimum(0);
+        keepAliveFps->setMaximum(90);
+        keepAliveFps->setFixedWidth(64);
+        keepAliveFps->setValue(cw::GlobalConfig::Instance.keepAliveFrameRate);
+        connect(keepAliveFps, &QSpinBox::valueChanged, this, [] (int value) {
+          cw::GlobalConfig::Instance.keepAliveFrameRate = value;
+        });
+        hBox->addWidget(keepAliveFps);
+      }
+
+      QCheckBox *directPresent = new QCheckBox("直接输出到窗口 (不经过 QOpenGLWidget)");
+      directPresent->setChecked(cw::GlobalConfig::Instance.directPresent);
+      connect(directPresent, &QCheckBox::toggled, this, [] (bool enabled) {
+        cw::GlobalConfig::Instance.directPresent = enabled;
+      });
+      vBox->addWidget(directPresent);
+
+      {
+        QHBoxLayout *hBox = new QHBoxLayout();
+        vBox->addLayout(hBox);
+
+        hBox->addWidget(new QLabel("静态画面最多占用的显存 (MiB)"));
+        hBox->addStretch();
+
+        QSpinBox *screenImageBudget = new QSpinBox();
+        screenImageBudget->setMinimum(8);
+        screenImageBudget->setMaximum(4096);
+        screenImageBudget->setFixedWidth(64);
+        screenImageBudget->setValue(cw::GlobalConfig::Instance.screenImageBudget);
+        connect(screenImageBudget, &QSpinBox::valueChanged, this, [] (int value) {
+          cw::GlobalConfig::Instance.screenImageBudget = value;
+        });
+        hBox->addWidget(screenImageBudget);
+      }
+
+      {
+        QHBoxLayout *hBox = new QHBoxLayout();
+        vBox->addLayout(hBox);
+
+        hBox->addWidget(new QLabel("最多同时加载的动画数量"));
+        hBox->addStretch();
+
+        QSpinBox *maxLoadedAnimations = new QSpinBox();
+        maxLoadedAnimations->setMinimum(1);
+        maxLoadedAnimations->setMaximum(64);
+        maxLoadedAnimations->setFixedWidth(64);
+        maxLoadedAnimations->setValue(cw::GlobalConfig::Instance.maxLoadedAnimations);
+        connect(maxLoadedAnimations, &QSpinBox::valueChanged, this, [] (int value) {
+          cw::GlobalConfig::Instance.maxLoadedAnimations = value;
+        });
+        hBox->addWidget(maxLoadedAnimations);
+      }
+
+      QCheckBox *proceduralScreen = new QCheckBox("在着色器中生成屏幕曲面");
+      proceduralScreen->setChecked(cw::GlobalConfig::Instance.proceduralScreen);
+      connect(proceduralScreen, &QCheckBox::toggled, this, [] (bool enabled) {
+        cw::GlobalConfig::Instance.proceduralScreen = enabled;
+      });
+      vBox->addWidget(proceduralScreen);
+
+      QCheckBox *dynamicQuality = new QCheckBox("GPU 跟不上时自动降低渲染分辨率与多重采样");
+      dynamicQuality->setChecked(cw::GlobalConfig::Instance.dynamicQuality);
+      connect(dynamicQuality, &QCheckBox::toggled, this, [] (bool enabled) {
+        cw::GlobalConfig::Instance.dynamicQuality = enabled;
+      });
+      vBox->addWidget(dynamicQuality);
     }
 
     // 控制器配置
@@ -396,30 +479,44 @@ background_b=%5
 multisampling=%6
 # 多重采样抗锯齿样本数
 multisampling_samples=%7
+# 后处理抗锯齿 (FXAA)，开启后不再使用多重采样
+fxaa=%8
 # 线条平滑
-line_smooth=%8
+line_smooth=%9
 # 各向异性过滤
-anisotropy_filter=%9
+anisotropy_filter=%10
 # 纹理采样方式，true=线性采样，false=临近采样
-linear_sampling=%10
+linear_sampling=%11
+# 画面无变化时的最低刷新率，0=画面无变化时不刷新
+keep_alive_fps=%12
+# 由渲染线程直接输出到窗口，不经过 QOpenGLWidget
+direct_present=%13
+# 静态画面最多占用的显存 (MiB)，超出时卸载最久未使用的画面
+screen_image_budget_mb=%14
+# 最多同时加载的动画数量，超出时卸载最久未播放的动画
+max_loaded_animations=%15
+# 在着色器中生成屏幕曲面，false=使用顶点缓冲
+procedural_screen=%16
+# GPU 跟不上刷新率时自动降低渲染分辨率与多重采样样本数
+dynamic_quality=%17
 
 [control]
 # 默认模式
-default_mode=%11
+default_mode=%18
 
 [control.vts]
 # WebSocket 端口
-websocket_port=%12
+websocket_port=%19
 
 [control.osf]
 # UDP 端口
-udp_port=%13
+udp_port=%20
 # XYZ 校正
-correction_x=%14
-correction_y=%15
-correction_z=%16
+correction_x=%21
+correction_y=%22
+correction_z=%23
 # 平滑
-smooth=%17
+smooth=%24
 )abc123")
           // common
           .arg(cw::GlobalConfig::Instance.stayOnTop ? "true" : "false")
@@ -430,9 +527,16 @@ smooth=%17
           // render
           .arg(cw::GlobalConfig::Instance.multisampling ? "true" : "false")
           .arg(cw::GlobalConfig::Instance.multisamplingSamples)
+          .arg(cw::GlobalConfig::Instance.fxaa ? "true" : "false")
           .arg(cw::GlobalConfig::Instance.lineSmoothHint ? "true" : "false")
           .arg(cw::GlobalConfig::Instance.anisotropyFilter ? "true" : "false")
           .arg(cw::GlobalConfig::Instance.linearSampling ? "true" : "false")
+          .arg(cw::GlobalConfig::Instance.keepAliveFrameRate)
+          .arg(cw::GlobalConfig::Instance.directPresent ? "true" : "false")
+          .arg(cw::GlobalConfig::Instance.screenImageBudget)
+          .arg(cw::GlobalConfig::Instance.maxLoadedAnimations)
+          .arg(cw::GlobalConfig::Instance.proceduralScreen ? "true" : "false")
+          .arg(cw::GlobalConfig::Instance.dynamicQuality ? "true" : "false")
           // control
           .arg(cw::GlobalConfig::ControlModeToString(cw::GlobalConfig::Instance.defaultControlMode))
           // control.vts
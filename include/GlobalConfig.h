@@ -12,9 +12,31 @@ struct GlobalConfig {
 
   bool multisampling = true;
   int multisamplingSamples = 8;
+  // anti-alias the finished frame with FXAA instead, much cheaper than MSAA
+  // but a bit blurrier. Multisampling is off while this is on
+  bool fxaa = false;
   bool lineSmoothHint = true;
   bool anisotropyFilter = true;
   bool linearSampling = true;
+  // frames are only rendered when something changed, but still at least this
+  // many times per second so that compositors don't consider us dead.
+  // 0 disables the keep-alive frames
+  int keepAliveFrameRate = 10;
+  // let the render thread draw into a plain QWindow and swap it directly,
+  // instead of handing frames over to a QOpenGLWidget
+  bool directPresent = false;
+  // static screen images are loaded when first shown, least recently used
+  // ones get evicted once they take more video memory than this, in MiB
+  int screenImageBudget = 64;
+  // animations are loaded when first played, least recently played ones get
+  // unloaded once more than this many are loaded
+  int maxLoadedAnimations = 4;
+  // generate the curved screen surface in the vertex shader, instead of
+  // drawing it from indexed vertex buffers
+  bool proceduralScreen = true;
+  // lower the scene resolution and MSAA samples while the GPU cannot keep up
+  // with the frame rate, `multisamplingSamples` is the upper limit then
+  bool dynamicQuality = true;
 
   enum class ControlMode {
     None,
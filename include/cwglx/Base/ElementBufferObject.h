@@ -19,6 +19,11 @@ public:
                   std::size_t size,
                   GLenum drawHint = GL_STATIC_DRAW) const noexcept;
 
+  void BufferData(GLFunctions *f,
+                  const GLushort *data,
+                  std::size_t size,
+                  GLenum drawHint = GL_STATIC_DRAW) const noexcept;
+
   void Delete(GLFunctions *f);
 
   CW_DERIVE_UNCOPYABLE(ElementBufferObject)
@@ -1,6 +1,7 @@
 #ifndef PROJECT_GL2_CWGLX_SHADER_PROGRAM_H
 #define PROJECT_GL2_CWGLX_SHADER_PROGRAM_H
 
+#include <QByteArray>
 #include <QString>
 #include "include/cwglx/GL/GL.h"
 #include "util/Derive.h"
@@ -9,7 +10,8 @@ namespace cw {
 
 class Shader {
 public:
-  Shader(QString programText, GLenum shaderType);
+  // `programText` is UTF-8
+  Shader(QByteArray programText, GLenum shaderType);
 
   ~Shader();
 
@@ -27,7 +29,7 @@ public:
   CW_DERIVE_UNMOVABLE(Shader)
 
 private:
-  QString m_ProgramText;
+  QByteArray m_ProgramText;
   GLenum m_ShaderType;
   GLuint m_ShaderId;
 
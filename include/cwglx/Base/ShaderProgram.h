@@ -1,16 +1,41 @@
 #ifndef PROJECT_GL2_SHADER_PROGRAM_H
 #define PROJECT_GL2_SHADER_PROGRAM_H
 
+#include <cstdint>
+#include <QByteArray>
 #include <QString>
-#include <QMap>
 #include <glm/fwd.hpp>
 #include "include/cwglx/GL/GL.h"
 #include "util/Derive.h"
+#include "util/Wife.h"
 
 namespace cw {
 
 class Shader;
 
+// Location of a uniform holding a `T`, resolved once after linking. Setting
+// an unresolved uniform does nothing
+template <Wife T>
+class Uniform {
+public:
+  constexpr inline Uniform() noexcept : m_Location(-1) {}
+
+  constexpr inline explicit Uniform(GLint location) noexcept
+    : m_Location(location)
+  {}
+
+  [[nodiscard]] constexpr inline GLint GetLocation() const noexcept {
+    return m_Location;
+  }
+
+  [[nodiscard]] constexpr inline bool IsResolved() const noexcept {
+    return m_Location >= 0;
+  }
+
+private:
+  GLint m_Location;
+};
+
 class ShaderProgram {
 public:
   ShaderProgram();
@@ -23,31 +48,68 @@ public:
 
   bool Link(GLFunctions *f);
 
+  // The following two need program binary support, see
+  // `cw::IsProgramBinarySupported`. `LinkBinary` initialises the program from
+  // a binary retrieved by `GetBinary` earlier, it fails if the driver rejects
+  // the binary, e.g. after a driver update
+  bool LinkBinary(GLFunctions *f, GLenum format, void const* binary, GLsizei length);
+  // Returns an empty array if the program is not linked
+  [[nodiscard]] QByteArray GetBinary(GLFunctions *f, GLenum *format) const;
+
   void UseProgram(GLFunctions *f) const;
 
   void Delete(GLFunctions *f);
 
   [[nodiscard]] QString GetCompileError() const;
 
-  GLint GetUniformLocation(GLFunctions *f, QString const& uniformName) const;
+  // Binds uniform block `blockName` to `bindingPoint`, returns false if the
+  // program does not declare such a block
+  bool BindUniformBlock(GLFunctions *f, char const* blockName, GLuint bindingPoint);
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, GLint value);
+  [[nodiscard]] bool HasUniformBlock(GLuint bindingPoint) const noexcept;
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, GLuint value);
+  // Returns -1 if the program has no active uniform named `uniformName`.
+  // Only meant to be called after linking, never on the draw path
+  [[nodiscard]] GLint GetUniformLocation(GLFunctions *f, char const* uniformName) const;
+  [[nodiscard]] GLint GetRequiredUniformLocation(GLFunctions *f, char const* uniformName) const;
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, GLfloat value);
+  template <Wife T>
+  [[nodiscard]] inline Uniform<T> ResolveUniform(GLFunctions *f,
+                                                 char const* uniformName) const {
+    return Uniform<T>(GetUniformLocation(f, uniformName));
+  }
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, glm::vec3 const& value);
+  // Same as `ResolveUniform`, but warns if `uniformName` cannot be found. For
+  // uniforms the program is known to use, so that a misspelt name does not
+  // go unnoticed
+  template <Wife T>
+  [[nodiscard]] inline Uniform<T> RequireUniform(GLFunctions *f,
+                                                 char const* uniformName) const {
+    return Uniform<T>(GetRequiredUniformLocation(f, uniformName));
+  }
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, glm::vec4 const& value);
+  // The following operate on the program currently in use
+  static void SetUniform(GLFunctions *f, Uniform<GLint> uniform, GLint value) noexcept;
 
-  void SetUniform(GLFunctions *f, QString const& uniformName, glm::mat4 const& value);
+  static void SetUniform(GLFunctions *f, Uniform<GLuint> uniform, GLuint value) noexcept;
 
-  void SetUniform3fv(GLFunctions *f, QString const& uniformName, GLfloat const* value);
+  static void SetUniform(GLFunctions *f, Uniform<GLfloat> uniform, GLfloat value) noexcept;
 
-  void SetUniform4fv(GLFunctions *f, QString const& uniformName, GLfloat const* value);
+  static void SetUniform(GLFunctions *f,
+                         Uniform<glm::vec2> uniform,
+                         glm::vec2 const& value) noexcept;
 
-  void SetUniformMatrix4fv(GLFunctions *f, QString const& uniformName, GLfloat const* value);
+  static void SetUniform(GLFunctions *f,
+                         Uniform<glm::vec3> uniform,
+                         glm::vec3 const& value) noexcept;
+
+  static void SetUniform(GLFunctions *f,
+                         Uniform<glm::vec4> uniform,
+                         glm::vec4 const& value) noexcept;
+
+  static void SetUniform(GLFunctions *f,
+                         Uniform<glm::mat4> uniform,
+                         glm::mat4 const& value) noexcept;
 
   CW_DERIVE_UNCOPYABLE(ShaderProgram)
   CW_DERIVE_UNMOVABLE(ShaderProgram)
@@ -58,8 +120,7 @@ private:
   bool m_Initialised;
   bool m_Linked;
   QString m_CompileError;
-
-  mutable QMap<QString, GLint> m_CachedUniforms;
+  std::uint32_t m_UniformBlocks;
 };
 
 } // namespace cw
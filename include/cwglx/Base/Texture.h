@@ -11,6 +11,24 @@ class QImage;
 
 namespace cw {
 
+// Converts `image` to the layout textures are uploaded from: RGB888 for
+// opaque images and RGBA8888 otherwise. Images already in that layout are
+// returned without copying
+QImage PrepareTextureImage(QImage const& image);
+
+// Sets up filtering of the bound texture, `linearSampling` uses its mip chain
+void SetTexture2DSampling(GLFunctions *f,
+                          bool linearSampling,
+                          bool anisotropyFilter);
+
+// Sets up sampling and uploads a prepared image into the bound texture.
+// `pixels` may also be an offset into the bound pixel unpack buffer
+void TexImage2D(GLFunctions *f,
+                QImage const& prepared,
+                void const* pixels,
+                bool linearSampling,
+                bool anisotropyFilter);
+
 class Texture2D {
 public:
   Texture2D(const QImage &image,
@@ -18,6 +36,9 @@ public:
             bool linearSampling,
             bool anisotropyFilter);
 
+  // Takes over a texture created elsewhere, e.g. on a shared context
+  explicit Texture2D(GLuint textureId) noexcept;
+
   [[nodiscard]] GLuint GetTextureId() const noexcept;
 
   void ActivateTexture(GLFunctions *f,
@@ -0,0 +1,35 @@
+#ifndef PROJECT_GL2_UBO_GLM_H
+#define PROJECT_GL2_UBO_GLM_H
+
+#include <glm/fwd.hpp>
+#include "include/cwglx/GL/GL.h"
+#include "util/Wife.h"
+
+namespace cw::impl {
+
+template <Wife T> struct Std140Probe;
+
+template<> struct Std140Probe<glm::vec2> {
+  static constexpr std::size_t Alignment = 8;
+  static constexpr std::size_t Size = 8;
+};
+
+template<> struct Std140Probe<glm::vec3> {
+  static constexpr std::size_t Alignment = 16;
+  static constexpr std::size_t Size = 12;
+};
+
+template<> struct Std140Probe<glm::vec4> {
+  static constexpr std::size_t Alignment = 16;
+  static constexpr std::size_t Size = 16;
+};
+
+// column major, 4 columns of vec4
+template<> struct Std140Probe<glm::mat4> {
+  static constexpr std::size_t Alignment = 16;
+  static constexpr std::size_t Size = 64;
+};
+
+} // namespace cw::impl
+
+#endif // PROJECT_GL2_UBO_GLM_H
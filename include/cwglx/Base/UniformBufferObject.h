@@ -0,0 +1,187 @@
+#ifndef PROJECT_GL2_UBO_H
+#define PROJECT_GL2_UBO_H
+
+#include <array>
+#include <cstddef>
+#include "include/cwglx/GL/GL.h"
+#include "util/Wife.h"
+#include "util/Derive.h"
+
+namespace cw {
+
+namespace impl {
+
+constexpr inline std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <std::size_t Offset_, std::size_t Size_, std::size_t Alignment_, std::size_t HostSize_>
+struct UniformFieldDescriptor {
+  static constexpr std::size_t Offset = Offset_;
+  static constexpr std::size_t Size = Size_;
+  static constexpr std::size_t Alignment = Alignment_;
+  static constexpr std::size_t HostSize = HostSize_;
+};
+
+// std140 base alignment and size of a uniform block member
+template <Wife T>
+struct Std140Probe {};
+
+template<> struct Std140Probe<GLfloat> {
+  static constexpr std::size_t Alignment = 4;
+  static constexpr std::size_t Size = 4;
+};
+
+template<> struct Std140Probe<GLint> {
+  static constexpr std::size_t Alignment = 4;
+  static constexpr std::size_t Size = 4;
+};
+
+template<> struct Std140Probe<GLuint> {
+  static constexpr std::size_t Alignment = 4;
+  static constexpr std::size_t Size = 4;
+};
+
+// array elements are rounded up to the size of a vec4
+template <Wife T, std::size_t N>
+struct Std140Probe<T[N]> {
+  static constexpr std::size_t Alignment = AlignUp(Std140Probe<T>::Alignment, 16);
+  static constexpr std::size_t Size = AlignUp(Std140Probe<T>::Size, 16) * N;
+};
+
+template <Wife T, std::size_t N>
+struct Std140Probe<std::array<T, N>> : Std140Probe<T[N]> {};
+
+template <std::size_t Expected>
+constexpr inline bool CheckStd140Layout() {
+  return true;
+}
+
+// every field must sit exactly where a std140 block would place it, given the
+// fields before it, and occupy as many bytes as std140 says (this rejects
+// things like `float[N]`, whose std140 array stride is 16)
+template <std::size_t Expected, Wife UFD, Wife ...UFDs>
+constexpr inline bool CheckStd140Layout() {
+  if constexpr (UFD::Offset != AlignUp(Expected, UFD::Alignment)
+                || UFD::Size != UFD::HostSize) {
+    return false;
+  } else {
+    return CheckStd140Layout<UFD::Offset + UFD::Size, UFDs...>();
+  }
+}
+
+} // namespace impl
+
+// A uniform buffer holding `count` consecutive `T` blocks, each of them
+// starting at an offset usable with `glBindBufferRange`
+template <Wife T, Wife ...UFDs>
+class UniformBufferObject {
+public:
+  static_assert(impl::CheckStd140Layout<0, UFDs...>(),
+                "uniform block type does not follow std140 layout");
+  static_assert(sizeof(T) % 16 == 0,
+                "uniform block type size must be padded to a multiple of 16");
+
+  explicit UniformBufferObject(GLFunctions *f);
+
+  ~UniformBufferObject();
+
+  void Allocate(GLFunctions *f, std::size_t count, GLenum drawHint = GL_DYNAMIC_DRAW);
+
+  void BufferSubData(GLFunctions *f, T const& data, std::size_t index = 0);
+
+  void BindBase(GLFunctions *f, GLuint bindingPoint) const;
+
+  void BindRange(GLFunctions *f, GLuint bindingPoint, std::size_t index) const;
+
+  [[nodiscard]] constexpr inline std::size_t GetCount() const noexcept {
+    return m_Count;
+  }
+
+  void Delete(GLFunctions *f);
+
+  CW_DERIVE_UNCOPYABLE(UniformBufferObject)
+  CW_DERIVE_UNMOVABLE(UniformBufferObject)
+
+private:
+  GLuint m_UBO;
+  GLsizeiptr m_Stride;
+  std::size_t m_Count;
+  bool m_Deleted;
+};
+
+} // namespace cw
+
+#define CW_IMPL_UFD_PROBE(T, FIELD) \
+  cw::impl::UniformFieldDescriptor< \
+    offsetof(T, FIELD), \
+    cw::impl::Std140Probe<decltype(std::declval<T>().FIELD)>::Size, \
+    cw::impl::Std140Probe<decltype(std::declval<T>().FIELD)>::Alignment, \
+    sizeof(std::declval<T>().FIELD) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE1(T, F1) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE2(T, F1, F2) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1), \
+    CW_IMPL_UFD_PROBE(T, F2) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE3(T, F1, F2, F3) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1), \
+    CW_IMPL_UFD_PROBE(T, F2), \
+    CW_IMPL_UFD_PROBE(T, F3) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE4(T, F1, F2, F3, F4) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1), \
+    CW_IMPL_UFD_PROBE(T, F2), \
+    CW_IMPL_UFD_PROBE(T, F3), \
+    CW_IMPL_UFD_PROBE(T, F4) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE5(T, F1, F2, F3, F4, F5) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1), \
+    CW_IMPL_UFD_PROBE(T, F2), \
+    CW_IMPL_UFD_PROBE(T, F3), \
+    CW_IMPL_UFD_PROBE(T, F4), \
+    CW_IMPL_UFD_PROBE(T, F5) \
+  >
+
+#define CW_IMPL_DEFINE_UBO_TYPE6(T, F1, F2, F3, F4, F5, F6) \
+  cw::UniformBufferObject< \
+    T, \
+    CW_IMPL_UFD_PROBE(T, F1), \
+    CW_IMPL_UFD_PROBE(T, F2), \
+    CW_IMPL_UFD_PROBE(T, F3), \
+    CW_IMPL_UFD_PROBE(T, F4), \
+    CW_IMPL_UFD_PROBE(T, F5), \
+    CW_IMPL_UFD_PROBE(T, F6) \
+  >
+
+#define CW_IMPL_SELECT_DEFINE_UBO_MACRO(_1, _2, _3, _4, _5, _6, _7, NAME, ...) NAME
+
+#define CW_DEFINE_UBO_TYPE(...) \
+  CW_IMPL_SELECT_DEFINE_UBO_MACRO( \
+    __VA_ARGS__, \
+    CW_IMPL_DEFINE_UBO_TYPE6, \
+    CW_IMPL_DEFINE_UBO_TYPE5, \
+    CW_IMPL_DEFINE_UBO_TYPE4, \
+    CW_IMPL_DEFINE_UBO_TYPE3, \
+    CW_IMPL_DEFINE_UBO_TYPE2, \
+    CW_IMPL_DEFINE_UBO_TYPE1, \
+  )(__VA_ARGS__)
+
+#endif // PROJECT_GL2_UBO_H
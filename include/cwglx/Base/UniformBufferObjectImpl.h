@@ -0,0 +1,112 @@
+#ifndef PROJECT_GL2_UBO_IMPL_H
+#define PROJECT_GL2_UBO_IMPL_H
+
+#include "UniformBufferObject.h"
+#include "include/cwglx/GL/GLImpl.h"
+
+namespace cw {
+
+template <Wife T, Wife ...UFDs>
+UniformBufferObject<T, UFDs...>::UniformBufferObject(GLFunctions *f)
+  : m_UBO(0),
+    m_Stride(sizeof(T)),
+    m_Count(0),
+    m_Deleted(false)
+{
+  f->glGenBuffers(1, &m_UBO);
+
+  GLint alignment = 0;
+  f->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  if (alignment > 0) {
+    m_Stride = static_cast<GLsizeiptr>(
+      impl::AlignUp(sizeof(T), static_cast<std::size_t>(alignment))
+    );
+  }
+}
+
+template <Wife T, Wife ...UFDs>
+UniformBufferObject<T, UFDs...>::~UniformBufferObject() {
+  if (!m_Deleted) {
+    qWarning() << "UniformBufferObject::~UniformBufferObject():"
+               << "uniform buffer object deleted before releasing relevant OpenGL resources";
+  }
+}
+
+template <Wife T, Wife ...UFDs>
+void UniformBufferObject<T, UFDs...>::Allocate(GLFunctions *f,
+                                               std::size_t count,
+                                               GLenum drawHint)
+{
+  if (m_Deleted) {
+    qWarning() << "UniformBufferObject::Allocate(GLFunctions*, std::size_t, GLenum):"
+               << "cannot allocate an already deleted uniform buffer object";
+    return;
+  }
+
+  f->glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+  f->glBufferData(GL_UNIFORM_BUFFER,
+                  m_Stride * static_cast<GLsizeiptr>(count),
+                  nullptr,
+                  drawHint);
+  f->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  m_Count = count;
+}
+
+template <Wife T, Wife ...UFDs>
+void UniformBufferObject<T, UFDs...>::BufferSubData(GLFunctions *f,
+                                                    T const& data,
+                                                    std::size_t index)
+{
+  if (index >= m_Count) {
+    qWarning() << "UniformBufferObject::BufferSubData(GLFunctions*, T const&, std::size_t):"
+               << "index"
+               << index
+               << "out of range";
+    return;
+  }
+
+  f->glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+  f->glBufferSubData(GL_UNIFORM_BUFFER,
+                     m_Stride * static_cast<GLintptr>(index),
+                     sizeof(T),
+                     &data);
+  // left bound, binding points are set through `BindRange` which does not
+  // depend on the generic binding
+}
+
+template <Wife T, Wife ...UFDs>
+void UniformBufferObject<T, UFDs...>::BindBase(GLFunctions *f, GLuint bindingPoint) const {
+  BindRange(f, bindingPoint, 0);
+}
+
+template <Wife T, Wife ...UFDs>
+void UniformBufferObject<T, UFDs...>::BindRange(GLFunctions *f,
+                                                GLuint bindingPoint,
+                                                std::size_t index) const
+{
+  if (m_Deleted) {
+    qWarning() << "UniformBufferObject::BindRange(GLFunctions*, GLuint, std::size_t):"
+               << "cannot bind to an already deleted uniform buffer object";
+    return;
+  }
+
+  f->glBindBufferRange(GL_UNIFORM_BUFFER,
+                       bindingPoint,
+                       m_UBO,
+                       m_Stride * static_cast<GLintptr>(index),
+                       sizeof(T));
+}
+
+template <Wife T, Wife ...UFDs>
+void UniformBufferObject<T, UFDs...>::Delete(GLFunctions *f) {
+  if (m_Deleted) {
+    return;
+  }
+
+  f->glDeleteBuffers(1, &m_UBO);
+  m_Deleted = true;
+}
+
+} // namespace cw
+
+#endif // PROJECT_GL2_UBO_IMPL_H
@@ -12,21 +12,25 @@ template <Wife T> struct VFDProbe;
 template<> struct VFDProbe<glm::vec1> {
   static constexpr GLenum GLTypeEnum = GL_FLOAT;
   static constexpr std::size_t ComponentCount = 1;
+  static constexpr bool Normalized = false;
 };
 
 template<> struct VFDProbe<glm::vec2> {
   static constexpr GLenum GLTypeEnum = GL_FLOAT;
   static constexpr std::size_t ComponentCount = 2;
+  static constexpr bool Normalized = false;
 };
 
 template<> struct VFDProbe<glm::vec3> {
   static constexpr GLenum GLTypeEnum = GL_FLOAT;
   static constexpr std::size_t ComponentCount = 3;
+  static constexpr bool Normalized = false;
 };
 
 template<> struct VFDProbe<glm::vec4> {
   static constexpr GLenum GLTypeEnum = GL_FLOAT;
   static constexpr std::size_t ComponentCount = 4;
+  static constexpr bool Normalized = false;
 };
 
 } // namespace cw::impl
@@ -34,18 +34,40 @@ private:
   bool m_Deleted;
 };
 
+// Integer components the shader reads as floats in [-1, 1] (signed) or
+// [0, 1] (unsigned)
+template <Wife T, std::size_t N>
+struct NormalizedVec {
+  T values[N];
+};
+
+// IEEE 754 half precision components, see `glm::packHalf1x16`
+template <std::size_t N>
+struct HalfVec {
+  GLushort values[N];
+};
+
+// Four signed normalised components packed as 10-10-10-2 bits, with x in the
+// lowest bits, see `glm::packSnorm3x10_1x2`
+struct PackedInt2101010 {
+  GLuint bits;
+};
+
 namespace impl {
-template <std::size_t Offset_, GLenum GLTypeEnum_, std::size_t ComponentCount_>
+template <std::size_t Offset_, GLenum GLTypeEnum_, std::size_t ComponentCount_, bool Normalized_>
 struct VertexFieldDescriptor {
   static constexpr GLenum GLTypeEnum = GLTypeEnum_;
   static constexpr std::size_t Offset = Offset_;
   static constexpr std::size_t ComponentCount = ComponentCount_;
+  static constexpr bool Normalized = Normalized_;
 };
 
 template<Wife T> constexpr inline GLenum GetGLTypeEnum();
 
 template<> constexpr inline GLenum GetGLTypeEnum<GLbyte>() { return GL_BYTE; }
 template<> constexpr inline GLenum GetGLTypeEnum<GLubyte>() { return GL_UNSIGNED_BYTE; }
+template<> constexpr inline GLenum GetGLTypeEnum<GLshort>() { return GL_SHORT; }
+template<> constexpr inline GLenum GetGLTypeEnum<GLushort>() { return GL_UNSIGNED_SHORT; }
 template<> constexpr inline GLenum GetGLTypeEnum<GLint>() { return GL_INT; }
 template<> constexpr inline GLenum GetGLTypeEnum<GLuint>() { return GL_UNSIGNED_INT; }
 template<> constexpr inline GLenum GetGLTypeEnum<GLfloat>() { return GL_FLOAT; }
@@ -61,12 +83,36 @@ template <Wife T, std::size_t N>
 struct VFDProbe<std::array<T, N>> {
   static constexpr GLenum GLTypeEnum = GetGLTypeEnum<T>();
   static constexpr std::size_t ComponentCount = N;
+  static constexpr bool Normalized = false;
 };
 
 template <Wife T, std::size_t N>
 struct VFDProbe<T[N]> {
   static constexpr GLenum GLTypeEnum = GetGLTypeEnum<T>();
   static constexpr std::size_t ComponentCount = N;
+  static constexpr bool Normalized = false;
+};
+
+template <Wife T, std::size_t N>
+struct VFDProbe<NormalizedVec<T, N>> {
+  static_assert(sizeof(T) <= 2, "only 8 and 16 bit integers make sense here");
+  static constexpr GLenum GLTypeEnum = GetGLTypeEnum<T>();
+  static constexpr std::size_t ComponentCount = N;
+  static constexpr bool Normalized = true;
+};
+
+template <std::size_t N>
+struct VFDProbe<HalfVec<N>> {
+  static constexpr GLenum GLTypeEnum = GL_HALF_FLOAT;
+  static constexpr std::size_t ComponentCount = N;
+  static constexpr bool Normalized = false;
+};
+
+template <>
+struct VFDProbe<PackedInt2101010> {
+  static constexpr GLenum GLTypeEnum = GL_INT_2_10_10_10_REV;
+  static constexpr std::size_t ComponentCount = 4;
+  static constexpr bool Normalized = true;
 };
 
 } // namespace impl
@@ -76,7 +122,8 @@ struct VFDProbe<T[N]> {
   cw::impl::VertexFieldDescriptor< \
     offsetof(T, FIELD), \
     cw::impl::VFDProbe<decltype(std::declval<T>().FIELD)>::GLTypeEnum, \
-    cw::impl::VFDProbe<decltype(std::declval<T>().FIELD)>::ComponentCount \
+    cw::impl::VFDProbe<decltype(std::declval<T>().FIELD)>::ComponentCount, \
+    cw::impl::VFDProbe<decltype(std::declval<T>().FIELD)>::Normalized \
   >
 
 #define CW_IMPL_DEFINE_VBO_TYPE1(T, F1) \
@@ -18,7 +18,7 @@ inline void BindVBOImpl(GLFunctions * f, GLuint baseIndex) {
   f->glVertexAttribPointer(N,
                            VFD::ComponentCount,
                            VFD::GLTypeEnum,
-                           GL_FALSE,
+                           VFD::Normalized ? GL_TRUE : GL_FALSE,
                            sizeof(T),
                            (void*)VFD::Offset);
   f->glEnableVertexAttribArray(N);
@@ -19,6 +19,8 @@ public:
   const QString renderer;
   const QString extensions;
 
+  [[nodiscard]] bool HasExtension(QString const& extension) const;
+
   static GLInfo AutoDetect(GLFunctions *f);
 };
 
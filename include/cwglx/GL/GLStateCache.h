@@ -0,0 +1,103 @@
+#ifndef PROJECT_GL2_STATE_CACHE_H
+#define PROJECT_GL2_STATE_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include "cwglx/GL/GL.h"
+#include "util/Derive.h"
+
+namespace cw {
+
+// Shadows the bits of OpenGL state the renderer touches most, so that calls
+// which would not change anything are never issued. Like an OpenGL context,
+// a cache is made current on one thread and the free functions below go
+// through it; with no cache current they simply forward to OpenGL.
+//
+// Code that changes the tracked state behind the cache's back (raw OpenGL
+// calls, plugins) must call `Invalidate` afterwards.
+class GLStateCache {
+public:
+  struct Counters {
+    std::uint32_t issued = 0;
+    std::uint32_t elided = 0;
+  };
+
+  GLStateCache() noexcept;
+
+  [[nodiscard]] static GLStateCache *Current() noexcept;
+  void MakeCurrent() noexcept;
+  static void DoneCurrent() noexcept;
+
+  // Forgets everything, the next call of each kind will be issued
+  void Invalidate() noexcept;
+
+  void UseProgram(GLFunctions *f, GLuint program) noexcept;
+  void BindVertexArray(GLFunctions *f, GLuint vao) noexcept;
+  void ActiveTexture(GLFunctions *f, GLenum textureUnit) noexcept;
+  // Binds to the currently active texture unit
+  void BindTexture2D(GLFunctions *f, GLuint texture) noexcept;
+  // `GL_FRAMEBUFFER` sets both the read and the draw binding
+  void BindFramebuffer(GLFunctions *f, GLenum target, GLuint fbo) noexcept;
+  // Only `GL_BLEND`, `GL_DEPTH_TEST` and `GL_CULL_FACE` are tracked, other
+  // capabilities are always forwarded
+  void SetCapability(GLFunctions *f, GLenum capability, bool enabled) noexcept;
+  // Answered from the cache when known, queried from OpenGL otherwise
+  [[nodiscard]] bool IsCapabilityEnabled(GLFunctions *f, GLenum capability) noexcept;
+  void DepthMask(GLFunctions *f, GLboolean mask) noexcept;
+  void BlendFunc(GLFunctions *f, GLenum srcFactor, GLenum dstFactor) noexcept;
+
+  // Deleting a bound object reverts the binding to 0 and frees the name for
+  // reuse, so the cache must be told about it
+  void ForgetProgram(GLuint program) noexcept;
+  void ForgetVertexArray(GLuint vao) noexcept;
+  void ForgetTexture(GLuint texture) noexcept;
+  void ForgetFramebuffer(GLuint fbo) noexcept;
+
+  // Returns the counters collected since the last call and resets them
+  Counters TakeCounters() noexcept;
+
+  CW_DERIVE_UNCOPYABLE(GLStateCache)
+  CW_DERIVE_UNMOVABLE(GLStateCache)
+
+private:
+  bool Elide(bool unchanged) noexcept;
+  static std::size_t CapabilityToIndex(GLenum capability) noexcept;
+
+  static constexpr std::size_t TrackedTextureUnits = 16;
+
+  enum CapabilityIndex : std::size_t {
+    BlendIndex = 0,
+    DepthTestIndex = 1,
+    CullFaceIndex = 2,
+    CapabilityCount = 3
+  };
+
+  GLuint m_Program;
+  GLuint m_VAO;
+  GLenum m_ActiveTexture;
+  std::array<GLuint, TrackedTextureUnits> m_Textures;
+  GLuint m_ReadFramebuffer;
+  GLuint m_DrawFramebuffer;
+  // -1 = unknown, 0 = disabled, 1 = enabled
+  std::array<std::int8_t, CapabilityCount> m_Capabilities;
+  std::int8_t m_DepthMask;
+  GLenum m_BlendSrc;
+  GLenum m_BlendDst;
+
+  Counters m_Counters;
+};
+
+// The following go through the current `GLStateCache`, if any
+void UseProgram(GLFunctions *f, GLuint program) noexcept;
+void BindVertexArray(GLFunctions *f, GLuint vao) noexcept;
+void ActiveTexture(GLFunctions *f, GLenum textureUnit) noexcept;
+void BindTexture2D(GLFunctions *f, GLuint texture) noexcept;
+void BindFramebuffer(GLFunctions *f, GLenum target, GLuint fbo) noexcept;
+void SetCapability(GLFunctions *f, GLenum capability, bool enabled) noexcept;
+[[nodiscard]] bool IsCapabilityEnabled(GLFunctions *f, GLenum capability) noexcept;
+void DepthMask(GLFunctions *f, GLboolean mask) noexcept;
+void BlendFunc(GLFunctions *f, GLenum srcFactor, GLenum dstFactor) noexcept;
+
+} // namespace cw
+
+#endif // PROJECT_GL2_STATE_CACHE_H
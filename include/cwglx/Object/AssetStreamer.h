@@ -0,0 +1,137 @@
+#ifndef PROJECT_GL2_ASSET_STREAMER_H
+#define PROJECT_GL2_ASSET_STREAMER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include "cwglx/GL/GL.h"
+#include "cwglx/Object/Object.h"
+#include "cwglx/Object/ObjParser.h"
+#include "util/Derive.h"
+
+class QObject;
+class QOffscreenSurface;
+class QOpenGLContext;
+class QThread;
+
+namespace cw {
+
+class Texture2D;
+struct ObjectData;
+struct TextureData;
+
+// An object uploaded by `AssetStreamer`. Its material libraries are parsed
+// but not loaded, the object has no material yet
+struct StreamedObject {
+  GLObject object;
+  QString materialName;
+  std::vector<MtlData> materialLibraries;
+};
+
+// Loads assets without stalling the render thread. Files are decoded on a
+// pool of workers, uploaded on a background OpenGL context sharing objects
+// with the renderer, and handed over to the render thread once the fences
+// put after the uploads signal.
+//
+// Requests may be made from any thread. Callbacks are always invoked on the
+// render thread, from `Poll`
+class AssetStreamer final {
+public:
+  // the texture is nullptr if the image could not be decoded
+  using TextureCallback =
+    std::function<void(GLFunctions*, std::unique_ptr<Texture2D>&&)>;
+  using ObjectCallback = std::function<void(GLFunctions*, StreamedObject&&)>;
+  // the image is null if it could not be decoded
+  using ImageCallback = std::function<void(GLFunctions*, QImage&&)>;
+
+  // What an upload task hands over to the render thread. `complete` runs
+  // from `Poll` once the GPU finished everything the task issued, `discard`
+  // releases what the task created instead if nobody is going to pick it up.
+  // Either may be empty
+  struct UploadResult {
+    std::function<void(GLFunctions*)> complete;
+    std::function<void(GLFunctions*)> discard;
+  };
+  using UploadTask = std::function<UploadResult(GLFunctions*)>;
+
+  AssetStreamer();
+  ~AssetStreamer();
+
+  // Called from the GUI thread, `shareContext` must have been created already
+  void Start(QOpenGLContext *shareContext);
+  // Called from the render thread. Waits for outstanding work, then deletes
+  // everything not picked up by `Poll` yet without invoking its callback
+  void Shutdown(GLFunctions *f);
+
+  void RequestTexture(QString const& fileName,
+                      bool linearSampling,
+                      bool anisotropyFilter,
+                      TextureCallback done);
+
+  void RequestObject(QString const& basePath,
+                     QString const& fileName,
+                     ObjectCallback done);
+
+  // Decodes `fileName` into an RGBA image scaled to `size`, for images the
+  // render thread places into storage of its own. Nothing gets uploaded
+  void RequestImage(QString const& fileName,
+                    QSize size,
+                    ImageCallback done);
+
+  // Runs `task` on the upload thread with the upload context current, for
+  // work too slow for the render thread that is not loading a file, e.g.
+  // compiling shader programs. Tasks run one after another, in order
+  void RequestUpload(UploadTask task);
+
+  // Called from the render thread every tick. Returns whether any callback
+  // was invoked, i.e. whether the picture may have changed
+  bool Poll(GLFunctions *f);
+
+  CW_DERIVE_UNCOPYABLE(AssetStreamer)
+  CW_DERIVE_UNMOVABLE(AssetStreamer)
+
+private:
+  // `complete` runs on the render thread once `fence` signalled, `discard`
+  // releases the uploaded objects instead if nobody is going to pick them up
+  struct FinishedUpload {
+    GLsync fence;
+    std::function<void(GLFunctions*)> complete;
+    std::function<void(GLFunctions*)> discard;
+  };
+
+  // the following four run on the upload thread
+  void InitializeUploader();
+  void DeleteUploader();
+  void UploadTexture(std::shared_ptr<TextureData> const& data,
+                     bool linearSampling,
+                     bool anisotropyFilter,
+                     TextureCallback const& done);
+  void UploadObject(std::shared_ptr<ObjectData> const& data,
+                    ObjectCallback const& done);
+
+  void PushFinished(FinishedUpload &&upload);
+
+private:
+  QThreadPool m_Workers;
+  QThread *m_UploadThread;
+  QObject *m_Uploader;
+  QOpenGLContext *m_UploadContext;
+  QOffscreenSurface *m_UploadSurface;
+  GLFunctions *m_UploadGL;
+  // the vertex array state of a context is not shared, this one only exists
+  // so that buffers may be bound on the upload context
+  GLuint m_ScratchVAO;
+  GLuint m_PixelBuffer;
+
+  QMutex m_FinishedMutex;
+  std::vector<FinishedUpload> m_Finished;
+};
+
+} // namespace cw
+
+#endif // PROJECT_GL2_ASSET_STREAMER_H
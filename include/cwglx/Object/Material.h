@@ -5,6 +5,7 @@
 #include <glm/vec4.hpp>
 #include "cwglx/GL/GL.h"
 #include "cwglx/Base/Texture.h"
+#include "cwglx/Object/UniformBlock.h"
 #include "util/Sinkrate.h"
 
 namespace cw {
@@ -21,6 +22,10 @@ struct Material {
   cw::Texture2D const* specularTexture;
   cw::Texture2D const* normalTexture;
 
+  // set by `GLObjectContext::UploadMaterials`
+  MaterialUBO const* uniformBuffer = nullptr;
+  std::size_t uniformIndex = 0;
+
   constexpr inline Material(glm::vec4 const& ambient,
                             glm::vec4 const& diffuse,
                             glm::vec4 const& specular,
@@ -0,0 +1,72 @@
+#ifndef PROJECT_GL2_MESH_CACHE_H
+#define PROJECT_GL2_MESH_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <QFile>
+#include <QStringList>
+#include "cwglx/GL/GL.h"
+#include "cwglx/Object/Vertex.h"
+#include "util/Derive.h"
+
+namespace cw {
+
+// Everything `LoadObject` needs to create a `GLObject`, already in the layout
+// the GPU wants
+struct MeshCacheContent {
+  std::uint64_t sourceHash = 0;
+  QStringList materialLibraries;
+  QString materialName;
+
+  CompactVertex const* vertices = nullptr;
+  std::size_t vertexCount = 0;
+  // `GLushort` or `GLuint`, depending on `indexType`
+  void const* indices = nullptr;
+  std::size_t indexCount = 0;
+  GLenum indexType = GL_UNSIGNED_INT;
+};
+
+// A mesh cache file mapped into memory. The pointers in its content point
+// into the mapping and stay valid until the `MeshCacheFile` is destroyed
+class MeshCacheFile {
+public:
+  // Returns nullptr if the file does not exist, is corrupted, was written by
+  // an incompatible version, or was made from a source other than the one
+  // hashing to `sourceHash`
+  static std::unique_ptr<MeshCacheFile> Open(QString const& path, std::uint64_t sourceHash);
+
+  ~MeshCacheFile();
+
+  [[nodiscard]] MeshCacheContent const& GetContent() const noexcept {
+    return m_Content;
+  }
+
+  CW_DERIVE_UNCOPYABLE(MeshCacheFile)
+  CW_DERIVE_UNMOVABLE(MeshCacheFile)
+
+private:
+  explicit MeshCacheFile(QString const& path);
+
+  QFile m_File;
+  uchar *m_Mapped;
+  MeshCacheContent m_Content;
+};
+
+bool WriteMeshCache(QString const& path, MeshCacheContent const& content);
+
+// ./cache/model/<hash of basePath>-<fileName>.cwmesh, files of the same name
+// from different directories (patches and builtin resources) must not share
+// one cache
+QString GetMeshCachePath(QString const& basePath, QString const& fileName);
+
+constexpr std::uint64_t HashSeed = 14695981039346656037ull;
+
+// 64-bit FNV-1a, only meant for telling whether a source file changed. Hashing
+// may be continued by passing the result of a previous call as `seed`
+std::uint64_t HashBytes(char const* data,
+                        std::size_t size,
+                        std::uint64_t seed = HashSeed) noexcept;
+
+} // namespace cw
+
+#endif // PROJECT_GL2_MESH_CACHE_H
@@ -0,0 +1,51 @@
+#ifndef PROJECT_GL2_MESH_OPTIMIZER_H
+#define PROJECT_GL2_MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "cwglx/GL/GL.h"
+
+namespace cw {
+
+struct Vertex;
+
+// Size of the simulated FIFO post-transform cache. Real hardware caches
+// differ, but orderings good for 16 entries are good for most of them
+constexpr std::size_t DefaultVertexCacheSize = 16;
+
+struct MeshOptimizeStats {
+  // average cache miss ratio: vertices transformed per triangle, 0.5 is the
+  // theoretical best for large regular meshes, 3.0 the worst
+  float acmrBefore;
+  float acmrAfter;
+};
+
+[[nodiscard]] float ComputeACMR(std::vector<GLuint> const& indices,
+                                std::size_t vertexCount,
+                                std::size_t cacheSize = DefaultVertexCacheSize);
+
+// Reorders triangles for post-transform cache locality (Tipsify, Sander et
+// al. 2007). `clusters` receives the index offsets where the algorithm had to
+// jump to a non-adjacent part of the mesh, starting with 0
+void OptimizeVertexCache(std::vector<GLuint> &indices,
+                         std::size_t vertexCount,
+                         std::vector<std::size_t> *clusters = nullptr,
+                         std::size_t cacheSize = DefaultVertexCacheSize);
+
+// Reorders the clusters produced by `OptimizeVertexCache` so that those
+// facing outwards, which are more likely to occlude the rest, get drawn
+// first. The new order is dropped if it makes ACMR worse than `threshold`
+// times the input's
+void OptimizeOverdraw(std::vector<GLuint> &indices,
+                      std::vector<Vertex> const& vertices,
+                      std::vector<std::size_t> const& clusters,
+                      float threshold = 1.05f,
+                      std::size_t cacheSize = DefaultVertexCacheSize);
+
+// Runs both passes above
+MeshOptimizeStats OptimizeMesh(std::vector<GLuint> &indices,
+                               std::vector<Vertex> const& vertices);
+
+} // namespace cw
+
+#endif // PROJECT_GL2_MESH_OPTIMIZER_H
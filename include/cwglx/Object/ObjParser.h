@@ -0,0 +1,72 @@
+#ifndef PROJECT_GL2_OBJ_PARSER_H
+#define PROJECT_GL2_OBJ_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace cw {
+
+// Indices are already zero based and absolute, -1 if not present
+struct ObjFaceVertex {
+  std::int32_t vertexCoord;
+  std::int32_t texCoord;
+  std::int32_t normal;
+};
+
+// Parsing never stops at bad input, bad lines are skipped and reported here.
+// `message` always points to a string literal
+struct ObjDiagnostic {
+  std::size_t lineNo;
+  char const* message;
+};
+
+struct ObjData {
+  std::vector<glm::vec3> vertexCoords;
+  std::vector<glm::vec3> vertexNormals;
+  std::vector<glm::vec2> texCoords;
+  // three per triangle, polygons are triangulated as fans
+  std::vector<ObjFaceVertex> faceVertices;
+
+  std::vector<std::string> materialLibraries;
+  // one material per object, the last `usemtl` wins
+  std::string materialName;
+
+  std::vector<ObjDiagnostic> diagnostics;
+};
+
+struct MtlMaterial {
+  std::string name;
+  glm::vec4 ambient { 0.0f, 0.0f, 0.0f, 1.0f };
+  glm::vec4 diffuse { 0.0f, 0.0f, 0.0f, 1.0f };
+  glm::vec4 specular { 0.0f, 0.0f, 0.0f, 1.0f };
+  float shine = 0.0f;
+
+  std::string diffuseMap;
+  std::string specularMap;
+  std::string normalMap;
+};
+
+struct MtlData {
+  std::vector<MtlMaterial> materials;
+  std::vector<ObjDiagnostic> diagnostics;
+};
+
+// Sources smaller than this are never split
+constexpr std::size_t ObjParallelThreshold = 1 << 20;
+
+// Parses a UTF-8 Wavefront object. Sources larger than `ObjParallelThreshold`
+// are split into line aligned chunks which are parsed on up to `threadCount`
+// threads (0 for the hardware concurrency) and merged in order
+ObjData ParseObj(std::string_view source, std::size_t threadCount = 0);
+
+MtlData ParseMtl(std::string_view source);
+
+} // namespace cw
+
+#endif // PROJECT_GL2_OBJ_PARSER_H
@@ -1,15 +1,18 @@
 #ifndef PROJECT_GL2_OBJECT_H
 #define PROJECT_GL2_OBJECT_H
 
+#include <functional>
 #include <memory>
+#include <vector>
 #include <QMap>
 #include "cwglx/Object/Material.h"
 #include "cwglx/Base/VertexArrayObject.h"
+#include "cwglx/Base/ElementBufferObject.h"
 #include "cwglx/Object/Vertex.h"
 
 namespace cw {
 
-class ShaderProgram;
+struct ObjectShaderInterface;
 
 class GLObjectContext final {
 public:
@@ -30,23 +33,49 @@ public:
   Texture2D const* GetTexture(QString const& texturePath) const;
   Material const* GetMaterial(QString const& materialName) const;
 
+  // Puts all materials into one uniform buffer, one `MaterialBlock` each.
+  // Must be called again after adding materials
+  void UploadMaterials(GLFunctions *f);
+
+  // Lets objects streamed into this context share texture requests. `ready`
+  // runs from `NotifyTextureArrived` once `texturePath` has been loaded or
+  // failed to. Returns true if the caller has to request the texture, false
+  // if a request for it is in flight already
+  bool WaitForTexture(QString const& texturePath,
+                      std::function<void(GLFunctions*)> ready);
+  void NotifyTextureArrived(GLFunctions *f, QString const& texturePath);
+
 private:
   std::unordered_map<QString, std::unique_ptr<Material>> m_MaterialLibrary;
   std::unordered_map<QString, std::unique_ptr<Texture2D>> m_TextureLibrary;
+  std::unique_ptr<MaterialUBO> m_MaterialBuffer;
+  // cleared by `Delete`, the callbacks may keep this context alive
+  std::unordered_map<QString, std::vector<std::function<void(GLFunctions*)>>>
+    m_TextureWaiters;
 };
 
 struct GLObject final {
   std::unique_ptr<VertexArrayObject> vao;
-  std::unique_ptr<VertexVBO> vbo;
-  GLsizei vertexCount;
+  std::unique_ptr<CompactVertexVBO> vbo;
+  std::unique_ptr<ElementBufferObject> ebo;
+  GLsizei indexCount;
+  // `GL_UNSIGNED_SHORT` if all vertices are addressable with 16 bits
+  GLenum indexType;
   Material const* material;
 
   GLObject(std::unique_ptr<VertexArrayObject> &&vao,
-           std::unique_ptr<VertexVBO> &&vbo,
-           GLsizei vertexCount,
+           std::unique_ptr<CompactVertexVBO> &&vbo,
+           std::unique_ptr<ElementBufferObject> &&ebo,
+           GLsizei indexCount,
+           GLenum indexType,
            Material const* material);
 
-  void Draw(GLFunctions *f, ShaderProgram *shaderProgram) const;
+  void Draw(GLFunctions *f, ObjectShaderInterface const& uniforms) const;
+
+  // `Draw` split in two, so that objects sharing a material only need to
+  // apply it once
+  void ApplyMaterial(GLFunctions *f, ObjectShaderInterface const& uniforms) const;
+  void DrawVertices(GLFunctions *f) const;
 
   void Delete(GLFunctions *f) const;
 
@@ -0,0 +1,41 @@
+#ifndef PROJECT_GL2_PROGRAM_CACHE_H
+#define PROJECT_GL2_PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <QByteArray>
+#include <QString>
+#include "cwglx/GL/GL.h"
+
+namespace cw {
+
+class ShaderProgram;
+
+// Must be called once with a context current before compiling any program.
+// Needs OpenGL 4.1 or GL_ARB_get_program_binary, as reported by `GLInfo`,
+// and a driver offering at least one binary format. Without them every
+// lookup misses and programs are always compiled from source
+void DetectProgramBinarySupport(GLFunctions *f);
+bool IsProgramBinarySupported() noexcept;
+
+// Binaries only work with the driver that made them, so the driver vendor,
+// renderer and version detected by `DetectProgramBinarySupport` are part of
+// the hash
+std::uint64_t HashProgramSource(QByteArray const& vertexShader,
+                                QByteArray const& fragmentShader);
+
+// Links `program` from the binary cached for `sourceHash`. Returns false if
+// there is none, or the driver rejected it; `program` is left uninitialised
+// then
+bool LoadCachedProgram(GLFunctions *f, ShaderProgram *program, std::uint64_t sourceHash);
+
+// Called after `program` got linked from source
+void StoreCachedProgram(GLFunctions *f,
+                        ShaderProgram const& program,
+                        std::uint64_t sourceHash);
+
+// ./cache/shader/<sourceHash>.cwprog
+QString GetProgramCachePath(std::uint64_t sourceHash);
+
+} // namespace cw
+
+#endif // PROJECT_GL2_PROGRAM_CACHE_H
@@ -0,0 +1,35 @@
+#ifndef PROJECT_GL2_SHADER_INTERFACE_H
+#define PROJECT_GL2_SHADER_INTERFACE_H
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include "cwglx/Base/ShaderProgram.h"
+
+namespace cw {
+
+// Uniforms `GLObject` sets on the shaders it gets drawn with. Resolved once
+// after the program gets linked. The plain matrix and material uniforms are
+// only looked up if the program lacks the matching uniform block, and only
+// the matrices are required then: a shader may well hard-code its material
+// or not sample its textures
+struct ObjectShaderInterface {
+  Uniform<glm::mat4> projection;
+  Uniform<glm::mat4> modelView;
+
+  Uniform<glm::vec4> materialAmbient;
+  Uniform<glm::vec4> materialDiffuse;
+  Uniform<glm::vec4> materialSpecular;
+  Uniform<GLfloat> materialShininess;
+
+  Uniform<GLint> diffuseTex;
+  Uniform<GLint> normalTex;
+
+  bool frameBlock = false;
+  bool materialBlock = false;
+
+  void Resolve(GLFunctions *f, ShaderProgram const& program);
+};
+
+} // namespace cw
+
+#endif // PROJECT_GL2_SHADER_INTERFACE_H
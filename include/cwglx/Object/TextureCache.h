@@ -0,0 +1,109 @@
+#ifndef PROJECT_GL2_TEXTURE_CACHE_H
+#define PROJECT_GL2_TEXTURE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <QFile>
+#include <QImage>
+#include "cwglx/GL/GL.h"
+#include "util/Derive.h"
+
+namespace cw {
+
+class Texture2D;
+
+struct TextureLevel {
+  GLsizei width;
+  GLsizei height;
+  // into the data of all levels, stored back to back
+  std::size_t offset;
+  std::size_t size;
+};
+
+// A texture cache file mapped into memory, holding a block compressed texture
+// with its full mip chain
+class TextureCacheFile {
+public:
+  // Returns nullptr if the file does not exist, is corrupted, was written by
+  // an incompatible version, or was made from a source other than the one
+  // hashing to `sourceHash`
+  static std::unique_ptr<TextureCacheFile> Open(QString const& path, std::uint64_t sourceHash);
+
+  ~TextureCacheFile();
+
+  [[nodiscard]] GLenum GetFormat() const noexcept { return m_Format; }
+  [[nodiscard]] std::vector<TextureLevel> const& GetLevels() const noexcept { return m_Levels; }
+  [[nodiscard]] std::uint8_t const* GetData() const noexcept { return m_Data; }
+  [[nodiscard]] std::size_t GetSize() const noexcept { return m_Size; }
+
+  CW_DERIVE_UNCOPYABLE(TextureCacheFile)
+  CW_DERIVE_UNMOVABLE(TextureCacheFile)
+
+private:
+  explicit TextureCacheFile(QString const& path);
+
+  QFile m_File;
+  uchar *m_Mapped;
+  GLenum m_Format;
+  std::vector<TextureLevel> m_Levels;
+  std::uint8_t const* m_Data;
+  std::size_t m_Size;
+};
+
+// Everything needed to create a texture, either block compressed with all
+// mip levels, or an uncompressed image prepared by `PrepareTextureImage`
+struct TextureData {
+  // 0 if not compressed
+  GLenum compressedFormat = 0;
+  std::vector<TextureLevel> levels;
+  std::uint8_t const* compressedData = nullptr;
+  std::size_t compressedSize = 0;
+
+  QImage image;
+
+  // own whatever `compressedData` points to
+  std::unique_ptr<TextureCacheFile> cache;
+  std::vector<std::uint8_t> compressedBuffer;
+
+  [[nodiscard]] bool IsNull() const noexcept {
+    return compressedFormat == 0 && image.isNull();
+  }
+
+  // what has to be uploaded, for staging in a pixel unpack buffer
+  [[nodiscard]] void const* GetPixels() const noexcept;
+  [[nodiscard]] std::size_t GetPixelsSize() const noexcept;
+};
+
+// Must be called once with a context current before loading any texture.
+// Without S3TC support, as reported by `GLInfo`, textures stay uncompressed
+void DetectTextureCompression(GLFunctions *f);
+bool IsTextureCompressionSupported() noexcept;
+
+// Decodes `fileName`, or takes it from the texture cache. When compression is
+// supported, images not found in the cache get their mip chain generated,
+// block compressed and cached. Touches no OpenGL state, safe to call from any
+// thread. Returns null data if the image cannot be decoded
+TextureData PrepareTexture(QString const& fileName);
+
+// Uploads into the bound texture and sets up sampling. `pixels` is either
+// `data.GetPixels()` or, with `data` staged in the bound pixel unpack buffer,
+// the offset of it in there
+void UploadTextureData(GLFunctions *f,
+                       TextureData const& data,
+                       void const* pixels,
+                       bool linearSampling,
+                       bool anisotropyFilter);
+
+std::unique_ptr<Texture2D> CreateTexture(GLFunctions *f,
+                                         TextureData const& data,
+                                         bool linearSampling,
+                                         bool anisotropyFilter);
+
+// ./cache/texture/<sourceHash>.cwtex
+QString GetTextureCachePath(std::uint64_t sourceHash);
+
+} // namespace cw
+
+#endif // PROJECT_GL2_TEXTURE_CACHE_H
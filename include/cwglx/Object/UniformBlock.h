@@ -0,0 +1,75 @@
+#ifndef PROJECT_GL2_UNIFORM_BLOCK_H
+#define PROJECT_GL2_UNIFORM_BLOCK_H
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include "cwglx/Base/UniformBufferObject.h"
+#include "cwglx/Base/UBOImpl/GLM.h"
+
+namespace cw {
+
+// Binding points shared by all shader programs
+enum UniformBlockBinding : GLuint {
+  FrameBlockBinding = 0,
+  MaterialBlockBinding = 1
+};
+
+// Camera and light data, updated once per frame
+//
+// layout (std140) uniform FrameData {
+//     mat4 projection;
+//     mat4 modelView;
+//     vec4 viewPos;
+//     vec4 light0Pos;
+//     vec4 light1Pos;
+// };
+struct alignas(16) FrameBlock {
+  static constexpr char const* BlockName = "FrameData";
+
+  glm::mat4 projection;
+  glm::mat4 modelView;
+  glm::vec4 viewPos;
+  glm::vec4 light0Pos;
+  glm::vec4 light1Pos;
+};
+
+static_assert(sizeof(FrameBlock) == 2 * sizeof(glm::mat4) + 3 * sizeof(glm::vec4),
+              "FrameBlock is compared bytewise, it must not contain padding");
+
+// One block per material, all of them living in the same buffer
+//
+// layout (std140) uniform MaterialData {
+//     vec4 ambient;
+//     vec4 diffuse;
+//     vec4 specular;
+//     float shininess;
+// } material;
+struct alignas(16) MaterialBlock {
+  static constexpr char const* BlockName = "MaterialData";
+
+  glm::vec4 ambient;
+  glm::vec4 diffuse;
+  glm::vec4 specular;
+  GLfloat shininess;
+};
+
+using FrameUBO = CW_DEFINE_UBO_TYPE(
+  FrameBlock,
+  projection,
+  modelView,
+  viewPos,
+  light0Pos,
+  light1Pos
+);
+
+using MaterialUBO = CW_DEFINE_UBO_TYPE(
+  MaterialBlock,
+  ambient,
+  diffuse,
+  specular,
+  shininess
+);
+
+} // namespace cw
+
+#endif // PROJECT_GL2_UNIFORM_BLOCK_H
@@ -28,6 +28,23 @@ struct Vertex {
   glm::vec3 biTangent;
 };
 
+// `Vertex` squeezed into 24 bytes for drawing. The tangent frame is one unit
+// quaternion rotating (1, 0, 0) to the tangent and (0, 0, 1) to the normal,
+// the sign of its w component tells the handedness of the bitangent:
+//
+//   vec3 normal = QuatRotate(q, vec3(0.0, 0.0, 1.0));
+//   vec3 tangent = QuatRotate(q, vec3(1.0, 0.0, 0.0));
+//   vec3 biTangent = cross(normal, tangent) * sign(q.w);
+struct CompactVertex {
+  glm::vec3 vertexCoord;
+  HalfVec<2> texCoord;
+  NormalizedVec<GLshort, 4> tangentFrame;
+};
+
+static_assert(sizeof(CompactVertex) == 24);
+
+CompactVertex CompressVertex(Vertex const& vertex) noexcept;
+
 using PlainVertexVBO = CW_DEFINE_VBO_TYPE(
   PlainVertex,
   vertexCoord
@@ -48,6 +65,13 @@ using VertexVBO = CW_DEFINE_VBO_TYPE(
   biTangent
 );
 
+using CompactVertexVBO = CW_DEFINE_VBO_TYPE(
+  CompactVertex,
+  vertexCoord,
+  texCoord,
+  tangentFrame
+);
+
 } // namespace cw
 
 #endif // PROJECT_GL2_VERTEX_H
@@ -1,15 +1,42 @@
 #ifndef PROJECT_GL2_WAVEFRONT_LOADER_H
 #define PROJECT_GL2_WAVEFRONT_LOADER_H
 
+#include <functional>
 #include <vector>
 #include <memory>
 
 #include "cwglx/Object/Object.h"
+#include "cwglx/Object/MeshCache.h"
+#include "cwglx/Object/ObjParser.h"
 
 namespace cw {
 
+class AssetStreamer;
 class GLObjectContext;
 
+// The CPU side of loading an object: parsed, optimised and compressed, or
+// taken from the mesh cache. Owns whatever `content` points to
+struct ObjectData {
+  // the source could not be read, `content` is empty and nothing got cached
+  bool sourceMissing = false;
+
+  MeshCacheContent content;
+  std::vector<MtlData> materialLibraries;
+
+  std::unique_ptr<MeshCacheFile> cache;
+  std::vector<CompactVertex> vertices;
+  std::vector<GLuint> indices;
+  std::vector<GLushort> shortIndices;
+};
+
+// Touches no OpenGL state, safe to call from any thread
+ObjectData PrepareObject(QString const& basePath, QString const& fileName);
+
+// `LoadMaterialLibrary` and `LoadObject` decode, and on a texture cache miss
+// build mip chains and block compress, on the calling thread. A cold cache
+// may take seconds, so they are for startup only; anything loaded while
+// frames are being drawn goes through `StreamObject`, which does the same
+// work on the workers of `AssetStreamer`
 void LoadMaterialLibrary(GLObjectContext *ctx,
                          GLFunctions *f,
                          QString const& basePath,
@@ -24,7 +51,19 @@ GLObject LoadObject(GLObjectContext *ctx,
                     bool linearSampling,
                     bool anisotropyFilter,
                     std::unique_ptr<VertexArrayObject> &&vao = nullptr,
-                    std::unique_ptr<VertexVBO> &&vbo = nullptr);
+                    std::unique_ptr<CompactVertexVBO> &&vbo = nullptr,
+                    std::unique_ptr<ElementBufferObject> &&ebo = nullptr);
+
+// Like `LoadObject`, but the object and its textures are decoded and uploaded
+// by `streamer`. `done` gets called from `AssetStreamer::Poll` once all of
+// them are on the GPU, with the textures and materials added to `ctx`
+void StreamObject(AssetStreamer *streamer,
+                  std::shared_ptr<GLObjectContext> const& ctx,
+                  QString const& basePath,
+                  QString const& fileName,
+                  bool linearSampling,
+                  bool anisotropyFilter,
+                  std::function<void(GLFunctions*, GLObject&&)> done);
 
 } // namespace cw
 
@@ -10,13 +10,13 @@ struct AttachmentStatus;
 
 class QMenu;
 class QPushButton;
-class GLWindow;
+class GLRenderer;
 struct StatusExtra;
 
 class AttachmentControl final : public CloseSignallingWidget {
 public:
   AttachmentControl(wgc0310::AttachmentStatus *attachmentStatus,
-                    GLWindow *glWindow,
+                    GLRenderer *renderer,
                     StatusExtra *statusExtra);
 
 private slots:
@@ -31,7 +31,7 @@ private:
 
 private:
   wgc0310::AttachmentStatus *m_AttachmentStatus;
-  GLWindow *m_GLWindow;
+  GLRenderer *m_Renderer;
   StatusExtra *m_StatusExtra;
 
   QMenu *m_ItemSelectMenu;
@@ -10,10 +10,12 @@
 #include "wgc0310/AttachmentStatus.h"
 #include "ui_next/EntityStatus.h"
 #include "ui_next/ExtraControl.h"
+#include "ui_next/GLRenderer.h"
 #include "util/CircularBuffer.h"
 
 class QPushButton;
 class GLWindow;
+class GLDirectWindow;
 class GLInfoDisplay;
 class EntityControl;
 class TrackControl;
@@ -45,26 +47,40 @@ protected:
 
 private slots:
   void NextTick();
+  // Publishes the current status to the renderer unless it is unchanged
+  void PublishRenderStatus();
+
+private:
+  void ShowGLWindow();
 
 private:
   // Worker thread, must be initialized very first
   QThread m_WorkerThread;
+  // Render thread, owns the OpenGL context
+  QThread m_RenderThread;
 
   // status
   EntityStatus m_EntityStatus;
-  wgc0310::HeadStatus m_HeadStatus;
+  wgc0310::HeadStatusBuffer m_HeadStatus;
   wgc0310::ScreenAnimationStatus m_ScreenAnimationStatus;
   wgc0310::ScreenDisplayMode m_ScreenDisplayMode;
   wgc0310::BodyStatus m_BodyStatus;
   wgc0310::AttachmentStatus m_AttachmentStatus;
-  cw::CircularBuffer<qreal, 160> m_VolumeLevels;
-  bool m_VolumeLevelsUpdated;
+  VolumeLevelsBuffer m_VolumeLevels;
   StatusExtra m_ExtraStatus;
+  std::uint64_t m_ScreenAnimationFrame;
+  RenderStatusBuffer m_RenderStatus;
+  RenderStatus m_LastRenderStatus;
 
   bool m_StartHideGL;
 
-  // widgets
+  // renderer
+  GLRenderer *m_Renderer;
+
+  // widgets, only one of the two output windows exists depending on
+  // `GlobalConfig::directPresent`
   GLWindow *m_GLWindow;
+  GLDirectWindow *m_GLDirectWindow;
   GLInfoDisplay *m_GLInfoDisplay;
   EntityControl *m_EntityControl;
   TrackControl *m_TrackControl;
@@ -30,6 +30,8 @@ public:
     *this = EntityStatus {};
   }
 
+  constexpr bool operator==(EntityStatus const&) const noexcept = default;
+
   void ToMatrix(glm::mat4 &matrix) const noexcept {
     matrix = glm::translate(matrix, glm::vec3(-translateX, -translateY, -translateZ));
     matrix = glm::rotate(matrix, glm::radians(entityRotateX), glm::vec3(1.0f, 0.0f, 0.0f));
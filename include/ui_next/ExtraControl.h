@@ -16,14 +16,14 @@ struct StatusExtra {
   glm::vec4 clearColor { 0.0f, 0.0f, 0.0f, 1.0f };
 };
 
-class GLWindow;
+class GLRenderer;
 class ShaderEdit;
 
 class ExtraControl final : public CloseSignallingWidget {
   Q_OBJECT
 
 public:
-  explicit ExtraControl(GLWindow *glWindow,
+  explicit ExtraControl(GLRenderer *renderer,
                         StatusExtra *statusExtra);
 
 signals:
@@ -33,7 +33,7 @@ signals:
 #pragma clang diagnostic pop
 
 private:
-  GLWindow *m_GLWindow;
+  GLRenderer *m_Renderer;
   StatusExtra *m_StatusExtra;
 };
 
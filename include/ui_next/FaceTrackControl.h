@@ -2,13 +2,11 @@
 #define PROJECT_WG_FACE_TRACK_CONTROL_H
 
 #include <QWidget>
+#include "wgc0310/HeadStatus.h"
 #include "ui_next/CloseSignallingWidget.h"
 
 namespace wgc0310 {
-struct HeadStatus;
 class BodyStatus;
-
-enum class ScreenDisplayMode : std::int8_t;
 } // namespace wgc0310
 
 class VTSTrackControl;
@@ -17,13 +15,13 @@ class ManualTrackControl;
 
 class TrackControl : public CloseSignallingWidget {
 public:
-  TrackControl(wgc0310::HeadStatus *headStatus,
+  TrackControl(wgc0310::HeadStatusBuffer *headStatus,
                wgc0310::ScreenDisplayMode *screenDisplayMode,
                QThread *workerThread);
 
 private:
   // Output
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   wgc0310::ScreenDisplayMode *m_ScreenDisplayMode;
 
   // Control widgets
@@ -0,0 +1,36 @@
+#ifndef PROJECT_WG_UINEXT_GLDIRECTWINDOW_H
+#define PROJECT_WG_UINEXT_GLDIRECTWINDOW_H
+
+#include <QWindow>
+
+class GLRenderer;
+
+// Alternative to `GLWindow`. The render thread draws straight into this
+// window's surface and swaps it, without going through the intermediate
+// framebuffer and composition of `QOpenGLWidget`.
+class GLDirectWindow final : public QWindow {
+  Q_OBJECT
+
+public:
+  explicit GLDirectWindow(GLRenderer *renderer);
+  ~GLDirectWindow() final;
+
+signals:
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "NotImplementedFunctions"
+  void Resized(int width, int height);
+#pragma clang diagnostic pop
+
+protected:
+  bool event(QEvent *e) final;
+  void exposeEvent(QExposeEvent *e) final;
+  void resizeEvent(QResizeEvent *e) final;
+
+private:
+  void UpdatePresenting();
+
+  GLRenderer *m_Renderer;
+  bool m_Presenting;
+};
+
+#endif // PROJECT_WG_UINEXT_GLDIRECTWINDOW_H
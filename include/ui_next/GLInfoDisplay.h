@@ -1,28 +1,46 @@
 #ifndef PROJECT_WG_UINEXT_GLINFO_H
 #define PROJECT_WG_UINEXT_GLINFO_H
 
+#include <QMap>
+#include <QString>
 #include "ui_next/CloseSignallingWidget.h"
 
 class QLineEdit;
 class QPlainTextEdit;
-class GLWindow;
+class GLRenderer;
 class SearchDialog;
 
 class GLInfoDisplay : public CloseSignallingWidget {
 public:
-  explicit GLInfoDisplay(GLWindow *glWindow);
+  explicit GLInfoDisplay(GLRenderer *renderer);
 
 private slots:
   void LoadGLInfo();
 
 private:
-  GLWindow *m_GLWindow;
+  QString AntiAliasingName() const;
+  QString OutputPathName() const;
+
+  struct Average {
+    double ms = 0.0;
+    int count = 0;
+  };
+  static QString AddSample(QMap<QString, Average> *averages,
+                           QString const& key,
+                           double ms);
+
+  GLRenderer *m_GLRenderer;
 
   QLineEdit *m_Vendor;
   QLineEdit *m_Version;
   QLineEdit *m_Renderer;
   QPlainTextEdit *m_Extensions;
   SearchDialog *m_SearchDialog;
+
+  // summed up per anti-aliasing mode and per output path, so that these can
+  // be compared side by side over the same session
+  QMap<QString, Average> m_GPUTimeAverages;
+  QMap<QString, Average> m_LatencyAverages;
 };
 
 #endif // PROJECT_WG_UINEXT_GLINFO_H
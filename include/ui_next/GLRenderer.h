@@ -0,0 +1,343 @@
+#ifndef PROJECT_WG_UINEXT_GLRENDERER_H
+#define PROJECT_WG_UINEXT_GLRENDERER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <QObject>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include "cwglx/GL/GL.h"
+#include "cwglx/GL/GLStateCache.h"
+#include "cwglx/Object/AssetStreamer.h"
+#include "cwglx/Object/Object.h"
+#include "cwglx/Object/UniformBlock.h"
+#include "wgc0310/BodyStatus.h"
+#include "wgc0310/HeadStatus.h"
+#include "wgc0310/Mesh.h"
+#include "wgc0310/RenderQueue.h"
+#include "wgc0310/Screen.h"
+#include "wgc0310/Shader.h"
+#include "ui_next/EntityStatus.h"
+#include "ui_next/QualityGovernor.h"
+#include "util/CircularBuffer.h"
+#include "util/SnapshotBuffer.h"
+
+namespace wgc0310 {
+struct StaticScreenImage;
+class ScreenImageArray;
+class WGAPIAnimation;
+} // namespace wgc0310
+
+class QThread;
+class QWindow;
+class QTimer;
+class QOpenGLContext;
+class QOffscreenSurface;
+
+// Everything the renderer needs from the control panel to draw one frame,
+// published as a snapshot so that the render thread never reads widget-owned
+// state. Head status and volume levels are published by their producers
+// directly, see `wgc0310::HeadStatusBuffer` and `VolumeLevelsBuffer`
+struct RenderStatus {
+  EntityStatus entityStatus;
+  wgc0310::BodyStatus bodyStatus;
+  wgc0310::ScreenDisplayMode screenDisplayMode =
+    wgc0310::ScreenDisplayMode::CapturedExpression;
+
+  std::shared_ptr<wgc0310::StaticScreenImage const> staticScreen;
+  wgc0310::WGAPIAnimation *screenAnimation = nullptr;
+  // advanced every tick while a screen animation is playing
+  std::uint64_t screenAnimationFrame = 0;
+
+  bool customClearColor = false;
+  glm::vec4 clearColor { 0.0f, 0.0f, 0.0f, 1.0f };
+
+  // the control panel only publishes a new status if it differs from the
+  // previous one, which is what the renderer uses for dirty tracking
+  bool operator==(RenderStatus const&) const = default;
+};
+
+using RenderStatusBuffer = cw::SnapshotBuffer<RenderStatus>;
+using VolumeLevelsBuffer = cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>>;
+
+// A finished frame, shared between the render thread and the presenting widget
+struct GLRenderTarget {
+  GLuint texture = 0;
+  GLuint fbo = 0;
+  GLsizei width = 0;
+  GLsizei height = 0;
+  // `GLRenderer::LatencyClock` time when the frame started rendering
+  qint64 frameStart = 0;
+
+  // signalled when the render thread finished drawing into `texture`
+  GLsync writeFence = nullptr;
+  // signalled when the presenter finished reading from `texture`
+  GLsync readFence = nullptr;
+};
+
+class GLRenderer final : public QObject {
+  Q_OBJECT
+
+public:
+  GLRenderer(RenderStatusBuffer *renderStatus,
+             wgc0310::HeadStatusBuffer *headStatus,
+             VolumeLevelsBuffer *volumeLevels);
+  ~GLRenderer() final;
+
+  // Must be called before QApplication gets constructed
+  static void SetupSurfaceFormat();
+
+  // Called from the GUI thread. Creates the OpenGL context and moves both the
+  // context and the renderer to `renderThread`
+  void Start(QThread *renderThread);
+  void Shutdown();
+
+  // Runs `f` on the render thread with the OpenGL context current, blocks
+  // until `f` finishes. Unless `readOnly`, `f` is assumed to have changed
+  // OpenGL state and what's on screen, so the state cache is invalidated and
+  // a frame gets rendered afterwards
+  void RunWithGLContext(std::function<void(void)> const& f, bool readOnly = false);
+
+  void EnablePerformanceCounter();
+  GLuint64 QueryPerformanceCounter() const noexcept;
+
+  struct MemoryInfo {
+    GLint available;
+    GLint dedicated;
+  };
+  // Video memory in KiB from GL_NVX_gpu_memory_info, sampled by the render
+  // thread along with each frame. Returns false if the driver rejected it
+  bool EnableMemoryInfo();
+  MemoryInfo QueryMemoryInfo() const noexcept;
+  // Nanoseconds from a frame starting to render to it being handed to the
+  // window system, sampled from the most recently presented frame
+  qint64 QueryPresentLatency() const noexcept;
+  // State changes issued and elided by the state cache in the latest frame
+  cw::GLStateCache::Counters QueryStateCacheCounters() const noexcept;
+  // Scene resolution and MSAA samples currently picked by the quality
+  // governor, full resolution with the configured samples if it's disabled
+  QualityGovernor::Decision QueryQualityDecision() const noexcept;
+
+  // Called from the GUI thread. Switches between FXAA and the configured
+  // multisampling while running, so that the two can be compared
+  void SetFXAA(bool enabled);
+  [[nodiscard]] bool IsFXAAEnabled() const noexcept;
+
+  // Called from the GUI thread, blocks until the render thread picked up the
+  // change. When set, frames are drawn straight into `window` and swapped by
+  // the render thread instead of being handed over to `GLWindow`
+  void SetPresentWindow(QWindow *window);
+  [[nodiscard]] bool IsPresentingDirectly() const noexcept;
+
+  // Called on the render thread, from `RunWithGLContext`. Picks up the
+  // latest status and stops playing `animation`. Returns whether it may be
+  // unloaded right after, which is not the case if the latest status still
+  // refers to it
+  bool ForgetScreenAnimation(wgc0310::WGAPIAnimation *animation);
+
+  // Loads assets in the background, callbacks run on the render thread
+  cw::AssetStreamer *GetAssetStreamer() noexcept;
+
+  // Called from any thread. Compiles `text` on the asset streamer's upload
+  // context while the current shaders keep being used, and swaps the new
+  // ones in between two frames. `done` is invoked on the thread of
+  // `receiver` afterwards, with the error message if compilation failed
+  void CompileShaderAsync(
+    wgc0310::ShaderText text,
+    QObject *receiver,
+    std::function<void(bool success, QString const& error)> done
+  );
+
+  // Called from any thread. Starts loading `images` in the background unless
+  // they are resident already, so that showing them later is instant
+  void PrefetchScreenImages(
+    std::vector<std::shared_ptr<wgc0310::StaticScreenImage const>> images
+  );
+  // Called from any thread. Frees the video memory of images not going to be
+  // shown again
+  void ReleaseScreenImages(std::vector<std::uint64_t> imageIds);
+
+  // The following two functions must be called on the render thread.
+  // `ReloadModel` returns right away, the current model keeps being drawn
+  // until the new one finished streaming in
+  void ReloadModel();
+  bool SetShader(std::unique_ptr<wgc0310::ShaderCollection> &&shader);
+
+  // Called by the presenter with its own (shared) context current.
+  // Returns nullptr if there's no frame to present yet.
+  GLRenderTarget *AcquireFrontTarget(std::size_t *index);
+  // Called by the presenter after it finished presenting `target`
+  void ReportPresented(GLRenderTarget const* target) noexcept;
+
+  // Forces the next frame to be rendered even if no status changed. Must be
+  // called on the render thread
+  void RequestFrame() noexcept;
+
+  // OpenGL function, only usable on the render thread
+  GLFunctions *GL;
+
+signals:
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "NotImplementedFunctions"
+  void OpenGLInitialized();
+  void FrameReady();
+  void ScreenImageLoadFailed(quint64 imageId);
+#pragma clang diagnostic pop
+
+public slots:
+  void Resize(int width, int height);
+
+private slots:
+  void InitializeGL();
+  void RenderFrame();
+
+private:
+  void PrepareRenderTarget(GLRenderTarget *target);
+  void PresentDirectly(GLRenderTarget const* target, bool queryStarted);
+  void ApplyQualityDecision();
+  void SetupAntiAliasing(bool fxaa);
+  void SampleMemoryInfo();
+  void DrawFXAA(GLRenderTarget const* target);
+  void ReallocateSceneBuffer();
+  bool ShouldRenderFrame();
+  void UpdateProjection();
+  // Uploads into and binds slot `index` of `m_FrameUniforms`
+  void UploadFrameUniforms(std::size_t index, glm::mat4 const& modelView);
+  // Advances the screen animation, and marks the screen content dirty if
+  // any of its inputs changed. Returns whether it did
+  bool UpdateScreenContent(RenderStatus const& status);
+  glm::mat4 ScreenModelView(glm::mat4 const& modelView) const;
+  // Returns false if something could not be drawn yet, the content is then
+  // rendered again with the next frame
+  bool DrawScreenContent(RenderStatus const& status);
+  void LoadScreenImage(wgc0310::StaticScreenImage const& image);
+
+private:
+  QOpenGLContext *m_Context;
+  QOffscreenSurface *m_Surface;
+  QTimer *m_FrameTimer;
+  bool m_Initialized;
+
+  // set by everything that changes the picture without going through the
+  // snapshot buffers: resizing, shader and model reloads, `RunWithGLContext`
+  bool m_FrameRequested;
+  QElapsedTimer m_SinceLastFrame;
+  // status of the latest rendered frame, `screenAnimationFrame` aside
+  RenderStatus m_RenderedStatus;
+
+  QWindow *m_PresentWindow;
+  std::atomic<bool> m_PresentingDirectly;
+  QElapsedTimer m_LatencyClock;
+  std::atomic<qint64> m_PresentLatency;
+
+  cw::GLStateCache m_StateCache;
+  std::atomic<std::uint32_t> m_StateCallsIssued;
+  std::atomic<std::uint32_t> m_StateCallsElided;
+
+  // consumer side of the snapshot buffers, only touched by the render thread
+  RenderStatusBuffer *m_RenderStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
+  VolumeLevelsBuffer *m_VolumeLevels;
+
+  // size of the output, the scene may be rendered smaller and scaled up
+  GLsizei m_Width;
+  GLsizei m_Height;
+  GLsizei m_RenderWidth;
+  GLsizei m_RenderHeight;
+  GLsizei m_Samples;
+  // clamped to what the driver supports, 0 if multisampling is off
+  GLsizei m_ConfiguredSamples;
+  GLuint m_SceneFBO;
+  GLuint m_SceneColorBuffer;
+  GLuint m_SceneDepthBuffer;
+  // with FXAA the scene is drawn into this texture instead of
+  // `m_SceneColorBuffer`, so that the post-process pass can sample it
+  bool m_FXAA;
+  GLuint m_SceneColorTexture;
+  // core profile refuses to draw without a vertex array bound
+  GLuint m_PostVAO;
+  // multisampled scenes are resolved here first when they get scaled up
+  GLuint m_ResolveFBO;
+  GLuint m_ResolveColorBuffer;
+  bool m_SceneBufferDirty;
+
+  std::unique_ptr<QualityGovernor> m_QualityGovernor;
+  std::atomic<float> m_QualityScale;
+  std::atomic<GLsizei> m_QualitySamples;
+  std::atomic<bool> m_QualityFXAA;
+
+  // back: being drawn by the render thread
+  // ready: latest finished frame
+  // front: being presented
+  std::array<GLRenderTarget, 3> m_Targets;
+  std::size_t m_BackIndex;
+  std::size_t m_ReadyIndex;
+  std::size_t m_FrontIndex;
+  bool m_ReadyFresh;
+  QMutex m_TargetMutex;
+
+  cw::AssetStreamer m_AssetStreamer;
+  std::shared_ptr<cw::GLObjectContext> m_GLObjectContext;
+  // the context the model being streamed in loads its textures into
+  std::shared_ptr<cw::GLObjectContext> m_PendingObjectContext;
+  // reloads replaced while still streaming in. They delete themselves once
+  // they finish, those that never do are deleted on shutdown
+  std::vector<std::shared_ptr<cw::GLObjectContext>> m_SupersededObjectContexts;
+  std::unique_ptr<wgc0310::ShaderCollection> m_Shader;
+  std::unique_ptr<wgc0310::Screen> m_Screen;
+  std::unique_ptr<wgc0310::ScreenImageArray> m_ScreenImages;
+
+  // inputs of what the screen render target currently shows, it only gets
+  // rendered again when any of them changes
+  struct ScreenContentKey {
+    std::uint64_t staticScreenId = 0;
+    wgc0310::ScreenDisplayMode displayMode =
+      wgc0310::ScreenDisplayMode::CapturedExpression;
+    // only tracked while showing the captured expression
+    float leftEye = 1.0f;
+    float rightEye = 1.0f;
+    wgc0310::HeadStatus::MouthStatus mouthStatus =
+      wgc0310::HeadStatus::MouthStatus::Close;
+
+    bool operator==(ScreenContentKey const&) const = default;
+  };
+  ScreenContentKey m_ScreenContent;
+  bool m_ScreenContentDirty;
+  wgc0310::WGAPIAnimation *m_ScreenAnimation;
+  // `RenderStatus::screenAnimationFrame` the animation has been ticked to
+  std::uint64_t m_ScreenAnimationFrame;
+
+  std::unique_ptr<wgc0310::WGCModel> m_Model;
+  wgc0310::RenderQueue m_RenderQueue;
+
+  glm::mat4 m_Projection;
+  // the model and the screen are drawn with different model views, each of
+  // them keeps its own slot so that neither gets uploaded again every frame
+  enum FrameBlockSlot : std::size_t {
+    SceneFrameBlock = 0,
+    ScreenFrameBlock = 1,
+    FrameBlockCount = 2
+  };
+  std::unique_ptr<cw::FrameUBO> m_FrameUniforms;
+  // what each slot of `m_FrameUniforms` holds, empty until its first upload
+  std::array<std::optional<cw::FrameBlock>, FrameBlockCount> m_UploadedFrameBlocks;
+
+  GLuint m_PerformanceCounter;
+  bool m_PerformanceCounterEnabled;
+  bool m_PerformanceCounterPending;
+  std::atomic<GLuint64> m_PerformanceCounterValue;
+
+  bool m_MemoryInfoEnabled;
+  std::atomic<GLint> m_MemoryAvailable;
+  std::atomic<GLint> m_MemoryDedicated;
+};
+
+#endif // PROJECT_WG_UINEXT_GLRENDERER_H
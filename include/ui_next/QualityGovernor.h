@@ -0,0 +1,49 @@
+#ifndef PROJECT_WG_UINEXT_QUALITY_GOVERNOR_H
+#define PROJECT_WG_UINEXT_QUALITY_GOVERNOR_H
+
+#include <cstddef>
+#include <vector>
+#include "cwglx/GL/GL.h"
+
+// Trades picture quality for GPU time. Steps the scene resolution and MSAA
+// sample count down while frames take longer than the target on the GPU, and
+// back up once there's plenty of headroom again. Samples are halved first,
+// then the resolution is lowered, since a blurrier picture is the more
+// noticeable loss.
+//
+// Only touched by the render thread
+class QualityGovernor final {
+public:
+  struct Decision {
+    // scene resolution relative to the output
+    float scale = 1.0f;
+    GLsizei samples = 0;
+
+    bool operator==(Decision const&) const = default;
+  };
+
+  // `maxSamples` is what the configuration asks for, 0 if multisampling is off
+  QualityGovernor(GLuint64 targetTime, GLsizei maxSamples);
+
+  // Feeds the GPU time of one frame, in nanoseconds. Returns true if the
+  // decision changed
+  bool AddSample(GLuint64 gpuTime) noexcept;
+
+  [[nodiscard]] Decision GetDecision() const noexcept;
+  [[nodiscard]] GLuint64 GetTargetTime() const noexcept;
+
+private:
+  void ResetAverage() noexcept;
+
+private:
+  // best quality first
+  std::vector<Decision> m_Ladder;
+  std::size_t m_Step;
+
+  GLuint64 m_TargetTime;
+  double m_AverageTime;
+  int m_SlowSamples;
+  int m_FastSamples;
+};
+
+#endif // PROJECT_WG_UINEXT_QUALITY_GOVERNOR_H
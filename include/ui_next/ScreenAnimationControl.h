@@ -1,42 +1,76 @@
 #ifndef PROJECT_WG_UINEXT_SCREEN_ANIMATION_CONTROL_H
 #define PROJECT_WG_UINEXT_SCREEN_ANIMATION_CONTROL_H
 
+#include <cstdint>
 #include <memory>
+#include <QStringList>
 #include <QWidget>
 
 #include "wgc0310/HeadStatus.h"
 #include "wgc0310/ScreenAnimationStatus.h"
 #include "ui_next/CloseSignallingWidget.h"
 
-class GLWindow;
+class GLRenderer;
 class QHBoxLayout;
+class QPushButton;
 class QVBoxLayout;
 class QRadioButton;
 struct StatusExtra;
 
 class ScreenAnimationControl : public CloseSignallingWidget {
+  Q_OBJECT
+
 public:
-  ScreenAnimationControl(GLWindow *glWindow,
+  ScreenAnimationControl(GLRenderer *renderer,
                          wgc0310::ScreenAnimationStatus *animationStatus,
                          wgc0310::ScreenDisplayMode *screenDisplayMode,
                          StatusExtra *statusExtra);
 
+signals:
+  // Must publish the status right away, an animation about to be unloaded
+  // may only be released by the renderer once the published status no
+  // longer refers to it
+  void ScreenAnimationChanged();
+
 public slots:
   void GLContextReady();
 
 private:
+  // Registered from the file name only, the shared object gets opened when
+  // the animation is first played
+  struct ScreenAnimationEntry {
+    QString fileName;
+    void *sharedObject = nullptr;
+    std::unique_ptr<wgc0310::WGAPIAnimation> animation;
+    // `m_AnimationUseClock` when last played
+    std::uint64_t lastUse = 0;
+    QPushButton *hButton = nullptr;
+    QPushButton *vButton = nullptr;
+  };
+
   void ReloadStaticImages();
+  void StaticImageLoadFailed(quint64 imageId);
+  void RebuildStaticImageButtons();
   void ReloadScreenAnimations();
+  void PlayScreenAnimation(std::size_t index);
+  bool LoadScreenAnimation(ScreenAnimationEntry *entry);
+  // Returns false, keeping the animation loaded, if the renderer may still
+  // be playing it
+  bool UnloadScreenAnimation(ScreenAnimationEntry *entry);
+  // Unloads the least recently played animations beyond
+  // `GlobalConfig::maxLoadedAnimations`, except the one playing
+  void EvictScreenAnimations();
 
 private:
-  GLWindow *m_GLWindow;
+  GLRenderer *m_Renderer;
   wgc0310::ScreenAnimationStatus *m_ScreenAnimationStatus;
   wgc0310::ScreenDisplayMode *m_ScreenDisplayMode;
   StatusExtra *m_StatusExtra;
 
-  std::vector<wgc0310::StaticScreenImage> m_StaticImages;
-  std::vector<std::unique_ptr<wgc0310::WGAPIAnimation>> m_ScreenAnimations;
-  std::vector<void*> m_SharedObjects;
+  std::vector<std::shared_ptr<wgc0310::StaticScreenImage const>> m_StaticImages;
+  std::uint64_t m_NextStaticImageId;
+  std::vector<ScreenAnimationEntry> m_ScreenAnimations;
+  std::uint64_t m_AnimationUseClock;
 
   QHBoxLayout *m_StaticImageButtonsLayout;
   QVBoxLayout *m_StaticImageButtonsLayoutV;
@@ -1,6 +1,7 @@
 #ifndef PROJECT_WG_SHADER_EDIT_H
 #define PROJECT_WG_SHADER_EDIT_H
 
+#include <cstdint>
 #include <QWidget>
 #include "wgc0310/Shader.h"
 #include "ui_next/CloseSignallingWidget.h"
@@ -9,20 +10,22 @@ namespace wgc0310 {
 struct ShaderText;
 } // namespace wgc0310
 
-class GLWindow;
+class GLRenderer;
 
 class ShaderEdit : public CloseSignallingWidget {
   Q_OBJECT
 
 public:
-  explicit ShaderEdit(GLWindow *glWindow);
+  explicit ShaderEdit(GLRenderer *renderer);
 
 private:
   wgc0310::ShaderText m_ShaderText;
-  GLWindow *m_GLWindow;
+  GLRenderer *m_Renderer;
 
   int m_ShaderPrevIndex;
   int m_ShaderSubPrevIndex;
+  // bumped with every compilation started
+  std::uint64_t m_CompileGeneration;
 };
 
 #endif // PROJECT_WG_SHADER_EDIT_H
@@ -1,11 +1,13 @@
 #ifndef PROJECT_WG_SOUND_CONTROL_H
 #define PROJECT_WG_SOUND_CONTROL_H
 
+#include <atomic>
 #include <QList>
 #include <QAudioDevice>
 
 #include "ui_next/CloseSignallingWidget.h"
 #include "util/CircularBuffer.h"
+#include "util/SnapshotBuffer.h"
 
 class QMediaDevices;
 class QComboBox;
@@ -15,8 +17,7 @@ class SoundControl : public CloseSignallingWidget {
   Q_OBJECT
 
 public:
-  SoundControl(cw::CircularBuffer<qreal, 160> *volumeLevels,
-               bool *volumeLevelsUpdated,
+  SoundControl(cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>> *volumeLevels,
                QThread *workerThread);
 
 signals:
@@ -28,12 +29,12 @@ signals:
 
 private slots:
   void ReloadAudioDevices();
-  void HandleSample(qreal sample);
+  void UpdateLevelMeter();
   void HandleError(QString const& reason);
 
 private:
-  cw::CircularBuffer<qreal, 160> *m_VolumeLevels;
-  bool *m_VolumeLevelsUpdated;
+  cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>> *m_VolumeLevels;
+  std::atomic<int> m_LatestLevel;
 
   QComboBox *m_DeviceSelect;
   QProgressBar *m_VolumeLevel;
@@ -1,6 +1,13 @@
 #ifndef PROJECT_WG_FILEUTIL_H
 #define PROJECT_WG_FILEUTIL_H
 
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <QByteArray>
+#include <QFile>
+#include "util/Derive.h"
+
 class QString;
 
 namespace cw {
@@ -9,8 +16,45 @@ bool IsFileExists(QString const& fileName);
 
 QString ReadToString(QString const &fileName);
 
+// Uncompressed Qt resources (`:/` paths) are returned without copying
+QByteArray ReadToBytes(QString const& fileName);
+
 bool WriteToFile(QString const& fileName, QString const& content);
 
+// Read-only bytes of a whole file, for parsing in place. Files on disk are
+// memory mapped, uncompressed Qt resources are used where they are, and
+// compressed ones are decompressed once. The bytes stay valid until the
+// `MappedFile` is destroyed
+class MappedFile {
+public:
+  // Returns nullptr if the file cannot be read
+  static std::unique_ptr<MappedFile> Open(QString const& fileName);
+
+  ~MappedFile();
+
+  [[nodiscard]] std::string_view GetView() const noexcept {
+    return std::string_view { m_Data, m_Size };
+  }
+
+  // Shares the bytes instead of copying them, so it must not outlive `this`
+  [[nodiscard]] QByteArray GetBytes() const {
+    return QByteArray::fromRawData(m_Data, static_cast<qsizetype>(m_Size));
+  }
+
+  CW_DERIVE_UNCOPYABLE(MappedFile)
+  CW_DERIVE_UNMOVABLE(MappedFile)
+
+private:
+  explicit MappedFile(QString const& fileName);
+
+  QFile m_File;
+  uchar *m_Mapped;
+  QByteArray m_Buffer;
+
+  char const* m_Data;
+  std::size_t m_Size;
+};
+
 } // namespace cw
 
 #endif // PROJECT_WG_FILEUTIL_H
@@ -1,6 +1,7 @@
 #ifndef PROJECT_WG_INI_LOADER_H
 #define PROJECT_WG_INI_LOADER_H
 
+#include <string_view>
 #include <QString>
 #include <QMap>
 
@@ -80,7 +81,8 @@ public:
                                   QString const& key,
                                   bool defaultValue = false) const;
 
-  [[nodiscard]] static IniFileData Parse(QString const& data);
+  // `data` is UTF-8
+  [[nodiscard]] static IniFileData Parse(std::string_view data);
 
 private:
   IniFileData() = default;
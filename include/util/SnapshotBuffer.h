@@ -0,0 +1,86 @@
+#ifndef PROJECT_WG_SNAPSHOT_BUFFER_H
+#define PROJECT_WG_SNAPSHOT_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include "util/Wife.h"
+
+namespace cw {
+
+// Lock-free "latest value wins" buffer, a triple buffer generalised to
+// `Writers` producers and exactly one consumer.
+//
+// Every producer owns one private slot, the consumer owns one, and one more
+// slot holds the latest published value. Publishing and consuming are single
+// atomic exchanges on that middle slot, so neither side ever waits nor sees a
+// torn value. Each writer index must only be used from one thread at a time.
+template <Wife T, std::size_t Writers = 1>
+class SnapshotBuffer {
+public:
+  static_assert(Writers >= 1, "SnapshotBuffer requires at least one writer");
+
+  constexpr static std::size_t SlotCount = Writers + 2;
+
+  SnapshotBuffer() : SnapshotBuffer(T {}) {}
+
+  explicit SnapshotBuffer(T const& initValue)
+    : m_Middle(Writers),
+      m_Front(Writers + 1)
+  {
+    for (Slot &slot : m_Slots) {
+      slot.value = initValue;
+    }
+    for (std::size_t i = 0; i < Writers; i++) {
+      m_WriterSlots[i].index = i;
+    }
+  }
+
+  SnapshotBuffer(SnapshotBuffer const&) = delete;
+  SnapshotBuffer &operator=(SnapshotBuffer const&) = delete;
+
+  // producer side
+  void Publish(T const& value, std::size_t writer = 0) {
+    std::size_t &index = m_WriterSlots[writer].index;
+    m_Slots[index].value = value;
+    index = m_Middle.exchange(index | FreshBit, std::memory_order_acq_rel) & IndexMask;
+  }
+
+  // consumer side, returns true if a new value has been published since last
+  // call. References obtained with `Read` are invalidated.
+  bool Update() noexcept {
+    if (!(m_Middle.load(std::memory_order_relaxed) & FreshBit)) {
+      return false;
+    }
+    m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & IndexMask;
+    return true;
+  }
+
+  [[nodiscard]] T const& Read() const noexcept {
+    return m_Slots[m_Front].value;
+  }
+
+private:
+  constexpr static std::size_t FreshBit = 0x100;
+  constexpr static std::size_t IndexMask = 0xFF;
+  static_assert(SlotCount <= IndexMask, "too many writers");
+
+  // keep slots on separate cache lines so that producers and the consumer
+  // don't fight over them
+  struct alignas(64) Slot {
+    T value;
+  };
+
+  struct alignas(64) WriterSlot {
+    std::size_t index;
+  };
+
+  std::array<Slot, SlotCount> m_Slots;
+  std::array<WriterSlot, Writers> m_WriterSlots;
+  alignas(64) std::atomic<std::size_t> m_Middle;
+  alignas(64) std::size_t m_Front;
+};
+
+} // namespace cw
+
+#endif // PROJECT_WG_SNAPSHOT_BUFFER_H
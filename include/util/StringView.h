@@ -0,0 +1,94 @@
+#ifndef PROJECT_WG_STRING_VIEW_H
+#define PROJECT_WG_STRING_VIEW_H
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+namespace cw {
+
+// Helpers for parsing UTF-8 text in place. None of them allocate
+
+// Editors on Windows like to start UTF-8 files with a byte order mark
+inline std::string_view SkipByteOrderMark(std::string_view text) noexcept {
+  if (text.starts_with("\xEF\xBB\xBF")) {
+    text.remove_prefix(3);
+  }
+  return text;
+}
+
+// Removes the next line from `rest` and returns it, without its `\n` or
+// `\r\n` line break
+inline std::string_view NextLine(std::string_view *rest) noexcept {
+  std::size_t end = rest->find('\n');
+  std::string_view line = rest->substr(0, end);
+  rest->remove_prefix(end == std::string_view::npos ? rest->size() : end + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+constexpr bool IsBlank(char ch) noexcept {
+  return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+inline std::string_view Trim(std::string_view text) noexcept {
+  while (!text.empty() && IsBlank(text.front())) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && IsBlank(text.back())) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+// Removes the next blank separated token from `line` and returns it, empty
+// if there is none left
+inline std::string_view NextToken(std::string_view *line) noexcept {
+  std::size_t begin = 0;
+  while (begin < line->size() && IsBlank((*line)[begin])) {
+    begin += 1;
+  }
+  std::size_t end = begin;
+  while (end < line->size() && !IsBlank((*line)[end])) {
+    end += 1;
+  }
+
+  std::string_view token = line->substr(begin, end - begin);
+  line->remove_prefix(end);
+  return token;
+}
+
+// ASCII only, `lowered` must be lower case already
+constexpr bool EqualsIgnoreCase(std::string_view text, std::string_view lowered) noexcept {
+  if (text.size() != lowered.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < text.size(); i++) {
+    char ch = text[i];
+    if (ch >= 'A' && ch <= 'Z') {
+      ch = static_cast<char>(ch - 'A' + 'a');
+    }
+    if (ch != lowered[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The whole token must be a number, an explicit plus sign is accepted
+template <typename T>
+bool ParseNumber(std::string_view token, T *out) noexcept {
+  if (!token.empty() && token.front() == '+') {
+    token.remove_prefix(1);
+  }
+  std::from_chars_result result = std::from_chars(token.data(),
+                                                  token.data() + token.size(),
+                                                  *out);
+  return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+} // namespace cw
+
+#endif // PROJECT_WG_STRING_VIEW_H
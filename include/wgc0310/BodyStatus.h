@@ -22,6 +22,8 @@ public:
 
   bool NextTick(BodyStatus* bodyStatus) noexcept;
 
+  constexpr bool operator==(PlayAnimationStatus const&) const noexcept = default;
+
 private:
   BodyAnimation const* m_Animation;
   std::size_t m_CurrentSection;
@@ -40,6 +42,8 @@ public:
     rotation[3] = 0.0f;
     rotation[4] = 0.0f;
   }
+
+  constexpr bool operator==(ArmStatus const&) const noexcept = default;
 };
 
 class BodyStatus {
@@ -105,6 +109,8 @@ public:
         return { 0.4, 0.4f, 0.4f, 1.0f };
     }
   }
+
+  constexpr bool operator==(BodyStatus const&) const noexcept = default;
 };
 
 } // namespace wgc0310
@@ -2,6 +2,7 @@
 #define PROJECT_WG_WGC0310_HEAD_STATUS_H
 
 #include <cstdint>
+#include "util/SnapshotBuffer.h"
 
 namespace wgc0310 {
 
@@ -19,6 +20,16 @@ struct HeadStatus {
   } mouthStatus = MouthStatus::Close;
 };
 
+// Head status is published by the tracking workers (on the worker thread) and
+// by manual control (on the GUI thread), each of them owns a writer slot
+enum HeadStatusWriter : std::size_t {
+  TrackerWriter = 0,
+  ManualWriter = 1,
+  HeadStatusWriterCount
+};
+
+using HeadStatusBuffer = cw::SnapshotBuffer<HeadStatus, HeadStatusWriterCount>;
+
 enum class ScreenDisplayMode : std::int8_t {
   CapturedExpression = -1,
   SoundWave = 1
@@ -2,6 +2,7 @@
 #define PROJECT_WG_WGC0310_MESH_H
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "cwglx/GL/GL.h"
@@ -9,17 +10,34 @@
 #include "cwglx/Base/VertexArrayObject.h"
 #include "cwglx/Base/ShaderProgram.h"
 #include "cwglx/Object/Object.h"
+#include "wgc0310/RenderQueue.h"
+
+namespace cw {
+class AssetStreamer;
+} // namespace cw
 
 namespace wgc0310 {
 
 struct WGCModel {
   cw::GLObject testObject;
 
+  // Every object of the model, each in the pass and at the depth it belongs
+  void Submit(RenderQueue *queue, glm::mat4 const& modelView) const;
+
   void Delete(GLFunctions *f);
 };
 
+// Blocks until everything is decoded and uploaded, including block
+// compressing textures missing from the texture cache. Only meant for startup
+// and tools, `GLRenderer` streams the model with `StreamWGCModel` instead
 WGCModel LoadWGCModel(cw::GLObjectContext *ctx, GLFunctions *f);
 
+// Loads the model through `streamer` without blocking, `done` gets called on
+// the render thread once it can be drawn
+void StreamWGCModel(cw::AssetStreamer *streamer,
+                    std::shared_ptr<cw::GLObjectContext> const& ctx,
+                    std::function<void(GLFunctions*, WGCModel&&)> done);
+
 } // namespace wgc0310
 
 #endif /* PROJECT_WG_WGC0310_MESH_H */
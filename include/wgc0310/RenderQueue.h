@@ -0,0 +1,71 @@
+#ifndef PROJECT_WG_WGC0310_RENDER_QUEUE_H
+#define PROJECT_WG_WGC0310_RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/fwd.hpp>
+#include "cwglx/GL/GL.h"
+
+namespace cw {
+struct GLObject;
+} // namespace cw
+
+namespace wgc0310 {
+
+struct ShaderCollection;
+
+// Passes are drawn in this order. Each of them uses its own program from
+// `ShaderCollection`
+enum class RenderPass : std::uint8_t {
+  Opaque = 0,
+  Emissive = 1,
+  Translucent = 2
+};
+
+struct DrawItem {
+  // opaque and emissive:
+  //   [63..62] pass  [61..56] shader  [55..40] material  [39..24] texture
+  //   [23..0]  depth, front to back
+  // translucent:
+  //   [63..62] pass  [61..56] shader  [55..32] depth, back to front
+  //   [31..16] material  [15..0] texture
+  std::uint64_t sortKey;
+  RenderPass pass;
+  cw::GLObject const* object;
+};
+
+// Collects everything to be drawn in one frame, then draws it sorted so that
+// program, material and texture switches happen as rarely as possible
+class RenderQueue {
+public:
+  RenderQueue() = default;
+
+  void Clear() noexcept;
+
+  // `depth` is the view space distance of the object, only used for ordering
+  void Submit(RenderPass pass, cw::GLObject const* object, GLfloat depth);
+
+  // Submits `object` to the pass its material asks for, translucent when the
+  // diffuse alpha (the dissolve of the MTL) is below one. Objects carry no
+  // bounds, the depth is that of their origin as placed by `modelView`
+  void Submit(cw::GLObject const* object, glm::mat4 const& modelView);
+
+  void Sort();
+
+  // `modelView` goes to programs still using plain uniforms instead of the
+  // frame uniform block
+  void Execute(GLFunctions *f,
+               ShaderCollection const& shaders,
+               glm::mat4 const& modelView) const;
+
+  [[nodiscard]] std::size_t GetItemCount() const noexcept {
+    return m_Items.size();
+  }
+
+private:
+  std::vector<DrawItem> m_Items;
+};
+
+} // namespace wgc0310
+
+#endif // PROJECT_WG_WGC0310_RENDER_QUEUE_H
@@ -4,22 +4,60 @@
 #include <functional>
 #include <glm/fwd.hpp>
 #include "cwglx/GL/GL.h"
-#include "cwglx/Base/ShaderProgram.h"
+#include "wgc0310/Shader.h"
 
 namespace wgc0310 {
 
+// nominal size of the screen content. The render target it gets drawn into
+// is scaled from this to how large the screen appears, see
+// `Screen::UpdateResolution`
+constexpr GLsizei ScreenWidth = 640;
+constexpr GLsizei ScreenHeight = 480;
+
 class ScreenImpl;
 
 class Screen final {
 public:
-  explicit Screen(GLFunctions *f);
+  // With `procedural` set the surface is generated in the vertex shader and
+  // no vertex data is kept at all, otherwise every level of detail is stored
+  // as 16-bit indexed triangle strips
+  Screen(GLFunctions *f, bool procedural);
   ~Screen();
 
+  // Binds the render target and sets the viewport to its full size
   void BeginScreenContext(GLFunctions *f) const noexcept;
 
+  // Rebuilds the mipmaps of the render target
   void DoneScreenContext(GLFunctions *f) const noexcept;
 
-  void Draw(GLFunctions *f, cw::ShaderProgram *shaderProgram) const noexcept;
+  // Sizes the render target to the pixels the screen covers when drawn with
+  // `transform`. Grows right away, but only shrinks after the smaller size
+  // kept being enough for a while, so that a screen hovering around a size
+  // does not get reallocated every frame. Returns true if the render target
+  // got reallocated, its content is lost then
+  bool UpdateResolution(GLFunctions *f,
+                        glm::mat4 const& transform,
+                        GLsizei viewportWidth,
+                        GLsizei viewportHeight);
+
+  [[nodiscard]] GLsizei GetWidth() const noexcept;
+  [[nodiscard]] GLsizei GetHeight() const noexcept;
+  // render target size relative to `ScreenWidth` by `ScreenHeight`
+  [[nodiscard]] float GetScale() const noexcept;
+
+  // Cheap CPU test of whether drawing the screen with `transform` would show
+  // anything, i.e. it is neither facing away nor outside the view frustum.
+  // The screen content need not be rendered if not
+  [[nodiscard]] bool IsVisible(glm::mat4 const& transform) const noexcept;
+
+  // `transform` is the projection and model view the screen gets drawn with,
+  // the tessellation gets coarser the fewer pixels of the viewport the screen
+  // covers
+  void Draw(GLFunctions *f,
+            ShaderCollection const& shaders,
+            glm::mat4 const& transform,
+            GLsizei viewportWidth,
+            GLsizei viewportHeight) const noexcept;
 
   void Delete(GLFunctions *f) const noexcept;
 
@@ -2,29 +2,30 @@
 #define PROJECT_WG_SCREEN_ANIMATION_STATUS_H
 
 #include <cstdint>
+#include <memory>
 #include <QString>
 
 #include "cwglx/GL/GL.h"
-#include "cwglx/Base/Texture.h"
 #include "util/Derive.h"
 #include "include/wgc0310/api/ScreenAnimation.h"
 
-namespace cw {
-class Texture2D;
-} // namespace cw
-
 namespace wgc0310 {
 
+// Registered from the file name only, the renderer loads the image into its
+// `ScreenImageArray` once it gets shown or prefetched. Never changes after
+// creation, so that it may be shared with the render thread
 struct StaticScreenImage final {
+  // unique for the lifetime of the program
+  std::uint64_t id;
   QString imageName;
-  std::unique_ptr<cw::Texture2D> texture;
+  QString filePath;
 };
 
 class ScreenAnimationStatus final {
 public:
   ScreenAnimationStatus();
 
-  void PlayStaticAnimation(StaticScreenImage *staticScreen);
+  void PlayStaticAnimation(std::shared_ptr<StaticScreenImage const> staticScreen);
 
   void PlayAnimation(WGAPIAnimation *animation);
 
@@ -32,13 +33,14 @@ public:
 
   void DrawOnScreen(GLFunctions *f) const noexcept;
 
-  void NextTick();
+  // Returns whether the animation needs to be redrawn
+  bool NextTick();
   void Reset();
 
   CW_DERIVE_UNCOPYABLE(ScreenAnimationStatus)
   CW_DERIVE_UNMOVABLE(ScreenAnimationStatus)
 
-  StaticScreenImage *staticScreen;
+  std::shared_ptr<StaticScreenImage const> staticScreen;
   WGAPIAnimation *animation;
 
 private:
@@ -0,0 +1,105 @@
+#ifndef PROJECT_WG_WGC0310_SCREEN_IMAGE_ARRAY_H
+#define PROJECT_WG_WGC0310_SCREEN_IMAGE_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <QImage>
+#include "cwglx/GL/GL.h"
+#include "cwglx/Base/ShaderProgram.h"
+#include "wgc0310/ShaderInterface.h"
+#include "util/Derive.h"
+
+namespace wgc0310 {
+
+// Static screen images packed into the layers of one texture array sized to
+// the screen, so that switching between them only changes a uniform. Images
+// are identified by `StaticScreenImage::id`. Layers are allocated on demand,
+// the array doubles when it runs out of them until it reaches the budget, from
+// then on the least recently used image gets evicted to make room.
+//
+// Everything here must be called on the render thread
+class ScreenImageArray final {
+public:
+  // Never holds more than `budget` bytes worth of layers, but at least one
+  ScreenImageArray(GLFunctions *f, std::size_t budget);
+  ~ScreenImageArray();
+
+  // Returns the layer holding image `key` if it has been uploaded, -1
+  // otherwise. Counts as a use of that image, the most recently used image is
+  // never evicted
+  GLint Use(std::uint64_t key) noexcept;
+
+  // Whether image `key` is resident, being loaded, or failed loading before.
+  // Only unknown images need to be requested
+  [[nodiscard]] bool IsKnown(std::uint64_t key) const noexcept;
+  void MarkLoading(std::uint64_t key);
+  [[nodiscard]] bool HasFailed(std::uint64_t key) const noexcept;
+
+  // Places `image` for `key`, which must have been marked as loading and not
+  // removed since, otherwise `image` is dropped. A null image marks `key` as
+  // failed. Returns whether the image got a layer
+  bool AddImage(GLFunctions *f, std::uint64_t key, QImage const& image);
+  void RemoveImage(std::uint64_t key);
+
+  // Uploads a few of the images added since, so that a burst of prefetched
+  // images does not stall a single frame. Returns whether anything was
+  // uploaded
+  bool Update(GLFunctions *f);
+
+  // Draws `layer`, as returned by `Use`, over the whole viewport
+  void Draw(GLFunctions *f,
+            cw::ShaderProgram const& program,
+            ScreenImageShaderInterface const& uniforms,
+            GLint layer) const noexcept;
+
+  void Delete(GLFunctions *f);
+
+  CW_DERIVE_UNCOPYABLE(ScreenImageArray)
+  CW_DERIVE_UNMOVABLE(ScreenImageArray)
+
+private:
+  enum class LayerState : std::uint8_t { Free, Pending, Ready };
+
+  struct Layer {
+    LayerState state = LayerState::Free;
+    std::uint64_t key = 0;
+    std::uint64_t lastUse = 0;
+  };
+
+  struct PendingUpload {
+    GLint layer;
+    QImage image;
+  };
+
+  bool Grow(GLFunctions *f);
+  // Frees the least recently used layer, returns false if there's none but
+  // the one in use
+  bool Evict();
+  void FreeLayer(GLint layer);
+
+private:
+  GLuint m_TextureId;
+  GLuint m_CopyFBO;
+  // core profile refuses to draw without a vertex array bound
+  GLuint m_EmptyVAO;
+  GLsizei m_MaxLayers;
+
+  std::vector<Layer> m_Layers;
+  std::vector<GLint> m_FreeLayers;
+  std::vector<PendingUpload> m_PendingUploads;
+
+  std::unordered_map<std::uint64_t, GLint> m_KeyLayers;
+  std::unordered_set<std::uint64_t> m_Loading;
+  std::unordered_set<std::uint64_t> m_Failed;
+  std::uint64_t m_UseClock;
+  std::uint64_t m_CurrentKey;
+
+  bool m_Deleted;
+};
+
+} // namespace wgc0310
+
+#endif // PROJECT_WG_WGC0310_SCREEN_IMAGE_ARRAY_H
@@ -2,24 +2,43 @@
 #define PROJECT_WG_WGC0310_SHADER_H
 
 #include "cwglx/Base/ShaderProgram.h"
+#include "cwglx/Object/ShaderInterface.h"
+#include "wgc0310/ShaderInterface.h"
 
 namespace wgc0310 {
 
 struct ShaderCollection {
   cw::ShaderProgram emissiveShader;
+  // same as `emissiveShader`, but generates the screen surface from
+  // `gl_VertexID` instead of reading vertex attributes
+  cw::ShaderProgram proceduralScreenShader;
+  // draws a static image from `ScreenImageArray` into the screen
+  cw::ShaderProgram screenImageShader;
+  // post-process anti-aliasing of the finished scene
+  cw::ShaderProgram fxaaShader;
 
   cw::ShaderProgram opaqueShader;
   cw::ShaderProgram translucentShader;
 
+  // the emissive program draws both objects and the screen
+  cw::ObjectShaderInterface emissiveUniforms;
+  ScreenShaderInterface emissiveScreenUniforms;
+  ProceduralScreenShaderInterface proceduralScreenUniforms;
+  ScreenImageShaderInterface screenImageUniforms;
+  FXAAShaderInterface fxaaUniforms;
+  cw::ObjectShaderInterface opaqueUniforms;
+  cw::ObjectShaderInterface translucentUniforms;
+
   void Delete(GLFunctions *f);
 };
 
+// UTF-8, built-in shaders point into the resource data without copying
 struct ShaderText {
-  QString opaqueVS;
-  QString opaqueFS;
+  QByteArray opaqueVS;
+  QByteArray opaqueFS;
 
-  QString translucentVS;
-  QString translucentFS;
+  QByteArray translucentVS;
+  QByteArray translucentFS;
 };
 
 std::unique_ptr<ShaderCollection>
@@ -0,0 +1,48 @@
+#ifndef PROJECT_WG_WGC0310_SHADER_INTERFACE_H
+#define PROJECT_WG_WGC0310_SHADER_INTERFACE_H
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include "cwglx/Base/ShaderProgram.h"
+
+namespace wgc0310 {
+
+// Uniforms of the programs drawing the screen and post-processing the scene,
+// one interface per program. Unlike the object shaders these are built in,
+// so every uniform is required to be found
+
+// emissive.frag, samples the screen render target
+struct ScreenShaderInterface {
+  cw::Uniform<GLint> screenTexture;
+
+  void Resolve(GLFunctions *f, cw::ShaderProgram const& program);
+};
+
+// screen.vert + emissive.frag
+struct ProceduralScreenShaderInterface : ScreenShaderInterface {
+  cw::Uniform<glm::vec3> screenGeometry;
+  cw::Uniform<GLint> screenColumns;
+  cw::Uniform<GLint> screenRows;
+
+  void Resolve(GLFunctions *f, cw::ShaderProgram const& program);
+};
+
+// screen-image.vert + screen-image.frag
+struct ScreenImageShaderInterface {
+  cw::Uniform<GLint> screenImages;
+  cw::Uniform<GLint> screenImageLayer;
+
+  void Resolve(GLFunctions *f, cw::ShaderProgram const& program);
+};
+
+// fxaa.vert + fxaa.frag
+struct FXAAShaderInterface {
+  cw::Uniform<GLint> sceneTexture;
+  cw::Uniform<glm::vec2> sceneTexelSize;
+
+  void Resolve(GLFunctions *f, cw::ShaderProgram const& program);
+};
+
+} // namespace wgc0310
+
+#endif // PROJECT_WG_WGC0310_SHADER_INTERFACE_H
@@ -9,6 +9,16 @@ class QWidget;
 
 namespace wgc0310 {
 
+// The screen render target is sized to how large the screen appears instead
+// of always being 640x480. The viewport covers all of it, animations drawing
+// in 640x480 units multiply by `scale`, e.g. for line widths or to pick the
+// resolution of their own textures
+struct WGAPIScreenViewport {
+  int width;
+  int height;
+  float scale;
+};
+
 class WGAPIAnimation {
 public:
   WGAPIAnimation() = default;
@@ -19,13 +29,15 @@ public:
 
   virtual QWidget *GetControlWidget() noexcept = 0;
 
-  virtual void NextTick() noexcept = 0;
+  // Returns whether the next `Draw` would look different from the previous
+  // one, the screen only gets redrawn then. Called on the render thread
+  virtual bool NextTick() noexcept = 0;
 
   virtual void Rewind() noexcept = 0;
 
   virtual bool Initialize(GLFunctions *f) noexcept = 0;
 
-  virtual void Draw(GLFunctions *f) noexcept = 0;
+  virtual void Draw(GLFunctions *f, WGAPIScreenViewport const& viewport) noexcept = 0;
 
   virtual void Delete(GLFunctions *f) noexcept = 0;
 
@@ -8,6 +8,7 @@
 #include "GlobalConfig.h"
 #include "ui_next/LicensePresenter.h"
 #include "ui_next/ControlPanel.h"
+#include "ui_next/GLRenderer.h"
 #include "util/FileUtil.h"
 
 std::pair<QDialog::DialogCode, LicensePresenter*>
@@ -55,6 +56,7 @@ PrecheckLicense() {
 
 int main(int argc, char *argv[]) {
   cw::InitGlobalConfig();
+  GLRenderer::SetupSurfaceFormat();
 
   QApplication a { argc, argv };
   QApplication::setWindowIcon(QIcon(QPixmap(":/icon-v2.png")));
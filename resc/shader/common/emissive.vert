@@ -3,8 +3,13 @@
 layout(location = 0) in vec3 inVertexCoord;
 layout(location = 1) in vec2 inTexCoord;
 
-uniform mat4 projection;
-uniform mat4 modelView;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
 
 out vec2 texCoord;
 
@@ -0,0 +1,53 @@
+#version 330 core
+
+in vec2 texCoord;
+
+uniform sampler2D sceneTexture;
+// 1.0 / size of sceneTexture
+uniform vec2 sceneTexelSize;
+
+out vec4 fragColor;
+
+// FXAA in its simplest form: blur along the direction of the local luma
+// gradient, unless that overshoots the neighbourhood
+const float ReduceMin = 1.0 / 128.0;
+const float ReduceMul = 1.0 / 8.0;
+const float SpanMax = 8.0;
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+vec3 sampleAt(vec2 offset) {
+    return texture(sceneTexture, texCoord + offset).rgb;
+}
+
+void main() {
+    vec4 center = texture(sceneTexture, texCoord);
+
+    float lumaNW = luma(sampleAt(vec2(-1.0, -1.0) * sceneTexelSize));
+    float lumaNE = luma(sampleAt(vec2(1.0, -1.0) * sceneTexelSize));
+    float lumaSW = luma(sampleAt(vec2(-1.0, 1.0) * sceneTexelSize));
+    float lumaSE = luma(sampleAt(vec2(1.0, 1.0) * sceneTexelSize));
+    float lumaM = luma(center.rgb);
+
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)),
+                    (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * ReduceMul), ReduceMin);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-SpanMax), vec2(SpanMax)) * sceneTexelSize;
+
+    vec3 rgbA = 0.5 * (sampleAt(dir * (1.0 / 3.0 - 0.5)) + sampleAt(dir * (2.0 / 3.0 - 0.5)));
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (sampleAt(dir * -0.5) + sampleAt(dir * 0.5));
+    float lumaB = luma(rgbB);
+
+    // the scene may be transparent, alpha is kept as it is
+    if (lumaB < lumaMin || lumaB > lumaMax) {
+        fragColor = vec4(rgbA, center.a);
+    } else {
+        fragColor = vec4(rgbB, center.a);
+    }
+}
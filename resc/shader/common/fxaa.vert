@@ -0,0 +1,10 @@
+#version 330 core
+
+out vec2 texCoord;
+
+// one triangle covering the whole viewport, no vertex data needed
+void main() {
+    vec2 position = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1)) - 1.0;
+    gl_Position = vec4(position, 0.0, 1.0);
+    texCoord = (position + 1.0) * 0.5;
+}
@@ -0,0 +1,12 @@
+#version 330 core
+
+in vec2 texCoord;
+
+uniform sampler2DArray screenImages;
+uniform int screenImageLayer;
+
+out vec4 fragColor;
+
+void main() {
+    fragColor = texture(screenImages, vec3(texCoord, float(screenImageLayer)));
+}
@@ -0,0 +1,46 @@
+#version 330 core
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
+
+// width, height and bulb of the screen surface
+uniform vec3 screenGeometry;
+uniform int screenColumns;
+uniform int screenRows;
+
+out vec2 texCoord;
+
+// two triangles per quad, wound the same way as the indexed strips
+const ivec2 quadCorners[6] = ivec2[6](
+    ivec2(0, 0), ivec2(0, 1), ivec2(1, 1),
+    ivec2(0, 0), ivec2(1, 1), ivec2(1, 0)
+);
+
+// one axis of the surface bent over a cylinder, mirrors ComputeVCylinder in
+// ScreenCurveHelper.cc
+vec2 cylinder(float extent, float bulb, float t) {
+    float radius = (bulb / 2.0) + (extent * extent / (8.0 * bulb));
+    float base = radius - bulb;
+    float halfAngle = asin(extent / (2.0 * radius));
+    float angle = mix(-halfAngle, halfAngle, t);
+    return vec2(sin(angle) * radius, cos(angle) * radius - base);
+}
+
+void main() {
+    int quad = gl_VertexID / 6;
+    ivec2 corner = quadCorners[gl_VertexID % 6];
+    ivec2 gridPos = ivec2(quad % screenColumns, quad / screenColumns) + corner;
+
+    vec2 uv = vec2(gridPos) / vec2(screenColumns, screenRows);
+    vec2 xz = cylinder(screenGeometry.x, screenGeometry.z / 2.0, uv.x);
+    // rows run from the top edge downwards
+    vec2 yz = cylinder(screenGeometry.y, screenGeometry.z / 2.0, 1.0 - uv.y);
+
+    gl_Position = projection * modelView * vec4(xz.x, yz.x, xz.y + yz.y, 1.0);
+    texCoord = uv;
+}
@@ -3,14 +3,12 @@
 in vec3 fragPos;
 in vec2 texCoord;
 
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+layout (std140) uniform MaterialData {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
     float shininess;
-};
-
-uniform Material material;
+} material;
 uniform sampler2D diffuseTex;
 uniform sampler2D normalTex;
 
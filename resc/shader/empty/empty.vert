@@ -1,13 +1,17 @@
 #version 330 core
 
 layout (location = 0) in vec3 inVertexCoord;
-layout (location = 1) in vec3 inVertexNormal;
-layout (location = 2) in vec2 inTexCoord;
-layout (location = 3) in vec3 inTangent;
-layout (location = 4) in vec3 inBiTangent;
+layout (location = 1) in vec2 inTexCoord;
+// unit quaternion, sign of w is the handedness of the bitangent
+layout (location = 2) in vec4 inTangentFrame;
 
-uniform mat4 projection;
-uniform mat4 modelView;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
 
 out vec3 fragPos;
 out vec2 texCoord;
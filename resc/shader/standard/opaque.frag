@@ -14,14 +14,12 @@ in vec3 tangentLightPos;
 in vec3 tangentViewPos;
 in vec3 tangentFragPos;
 
-struct Material {
+layout (std140) uniform MaterialData {
     vec4 ambient;
     vec4 diffuse;
     vec4 specular;
     float shininess;
-};
-
-uniform Material material;
+} material;
 uniform sampler2D diffuseTex;
 uniform sampler2D normalTex;
 
@@ -1,16 +1,17 @@
 #version 330 core
 
 layout (location = 0) in vec3 inVertexCoord;
-layout (location = 1) in vec3 inVertexNormal;
-layout (location = 2) in vec2 inTexCoord;
-layout (location = 3) in vec3 inTangent;
-layout (location = 4) in vec3 inBiTangent;
-
-uniform mat4 projection;
-uniform mat4 modelView;
-
-const vec3 lightPos = vec3(0.0, 0.0, 0.0);
-const vec3 viewPos = vec3(0.0, 0.0, 0.0);
+layout (location = 1) in vec2 inTexCoord;
+// unit quaternion, sign of w is the handedness of the bitangent
+layout (location = 2) in vec4 inTangentFrame;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
 
 out vec3 fragPos;
 out vec2 texCoord;
@@ -18,18 +19,27 @@ out vec3 tangentLightPos;
 out vec3 tangentViewPos;
 out vec3 tangentFragPos;
 
+vec3 QuatRotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
 void main() {
     fragPos = vec3(modelView * vec4(inVertexCoord, 1.0));
     texCoord = vec2(inTexCoord.x, 1.0 - inTexCoord.y);
 
+    vec4 q = normalize(inTangentFrame);
+    vec3 inVertexNormal = QuatRotate(q, vec3(0.0, 0.0, 1.0));
+    vec3 inTangent = QuatRotate(q, vec3(1.0, 0.0, 0.0));
+    vec3 inBiTangent = cross(inVertexNormal, inTangent) * (q.w < 0.0 ? -1.0 : 1.0);
+
     mat3 normalMatrix = transpose(inverse(mat3(modelView)));
     vec3 t = normalize(normalMatrix * inTangent);
     vec3 b = normalize(normalMatrix * inBiTangent);
     vec3 n = normalize(normalMatrix * inVertexNormal);
     mat3 tbn = mat3(t, b, n);
 
-    tangentLightPos = tbn * lightPos;
-    tangentViewPos = tbn * viewPos;
+    tangentLightPos = tbn * light0Pos.xyz;
+    tangentViewPos = tbn * viewPos.xyz;
     tangentFragPos = tbn * fragPos;
 
     gl_Position = projection * vec4(fragPos, 1.0);
@@ -1,32 +1,32 @@
 #version 330 core
 
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
-};
-
 struct Light {
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
 };
 
-const Material material = Material(
-vec3(0.1f, 0.125f, 0.15f),
-vec3(0.1f, 0.1125f, 0.125f),
-vec3(0.1f, 0.1125f, 0.125f),
-32.0f
-);
-
 const Light light = Light(vec3(1.0f), vec3(1.0f), vec3(1.0f));
 
 in vec3 fragPos;
 in vec3 normal;
 
-uniform vec3 light0Pos;
-uniform vec3 light1Pos;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
+
+// same block as the opaque pass, the alpha of `diffuse` is the material's
+// dissolve
+layout (std140) uniform MaterialData {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float shininess;
+} material;
 
 out vec4 fragColor;
 
@@ -34,15 +34,15 @@ void main() {
     vec3 norm = normalize(normal);
 
     // ambient
-    vec3 ambient = light.ambient * material.ambient;
+    vec3 ambient = light.ambient * vec3(material.ambient);
 
     // diffuse
-    vec3 lightDir0 = normalize(light0Pos - fragPos);
-    vec3 lightDir1 = normalize(light1Pos - fragPos);
+    vec3 lightDir0 = normalize(light0Pos.xyz - fragPos);
+    vec3 lightDir1 = normalize(light1Pos.xyz - fragPos);
     float diff0 = max(dot(norm, lightDir0), 0.0);
     float diff1 = max(dot(norm, lightDir1), 0.0);
-    vec3 diffuse0 = diff0 * material.diffuse * light.diffuse;
-    vec3 diffuse1 = diff1 * material.diffuse * light.diffuse;
+    vec3 diffuse0 = diff0 * vec3(material.diffuse) * light.diffuse;
+    vec3 diffuse1 = diff1 * vec3(material.diffuse) * light.diffuse;
 
     // specular
     // our view point is always at the origin, thus the view direction is the negative position
@@ -51,10 +51,11 @@ void main() {
     vec3 reflectDir1 = reflect(-lightDir1, norm);
     float spec0 = pow(max(dot(viewDir, reflectDir0), 0.0), material.shininess);
     float spec1 = pow(max(dot(viewDir, reflectDir1), 0.0), material.shininess);
-    vec3 specular0 = light.specular * (spec0 * material.specular);
-    vec3 specular1 = light.specular * (spec1 * material.specular);
+    vec3 specular0 = light.specular * (spec0 * vec3(material.specular));
+    vec3 specular1 = light.specular * (spec1 * vec3(material.specular));
 
-    // blending
+    // blending, premultiplied as `SetupPreferred` sets the blend function
     vec3 result = ambient + diffuse0 + diffuse1 + specular0 + specular1;
-    fragColor = vec4(result, 1.0);
+    float alpha = material.diffuse.a;
+    fragColor = vec4(result * alpha, alpha);
 }
@@ -1,16 +1,26 @@
 #version 330 core
 
 layout (location = 0) in vec3 inVertexCoord;
-layout (location = 1) in vec3 inNormal;
+layout (location = 2) in vec4 inTangentFrame;
 
-uniform mat4 projection;
-uniform mat4 modelView;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 modelView;
+    vec4 viewPos;
+    vec4 light0Pos;
+    vec4 light1Pos;
+};
 
 out vec3 fragPos;
 out vec3 normal;
 
+vec3 QuatRotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
 void main() {
     fragPos = vec3(modelView * vec4(inVertexCoord, 1.0));
+    vec3 inNormal = QuatRotate(normalize(inTangentFrame), vec3(0.0, 0.0, 1.0));
     normal = mat3(transpose(inverse(modelView))) * inNormal;
 
     gl_Position = projection * vec4(fragPos, 1.0);
@@ -9,8 +9,8 @@ namespace cw {
 GlobalConfig GlobalConfig::Instance;
 
 void InitGlobalConfig() {
-  QString iniFileContent = ReadToString("config.ini");
-  IniFileData config = IniFileData::Parse(iniFileContent);
+  std::unique_ptr<MappedFile> iniFile = MappedFile::Open("config.ini");
+  IniFileData config = IniFileData::Parse(iniFile ? iniFile->GetView() : std::string_view {});
 
   IniSection const* commonConfig = config.GetSection("common");
   if (commonConfig) {
@@ -33,12 +33,31 @@ void InitGlobalConfig() {
       renderConfig->GetBoolValue("multisampling");
     GlobalConfig::Instance.multisamplingSamples =
       renderConfig->GetIntValue("multisampling_samples");
+    GlobalConfig::Instance.fxaa =
+      renderConfig->GetBoolValue("fxaa", GlobalConfig::Instance.fxaa);
     GlobalConfig::Instance.lineSmoothHint =
       renderConfig->GetBoolValue("line_smooth");
     GlobalConfig::Instance.anisotropyFilter =
       renderConfig->GetBoolValue("anisotropy_filter");
     GlobalConfig::Instance.linearSampling =
       renderConfig->GetBoolValue("linear_sampling");
+    GlobalConfig::Instance.keepAliveFrameRate =
+      renderConfig->GetIntValue("keep_alive_fps",
+                                GlobalConfig::Instance.keepAliveFrameRate);
+    GlobalConfig::Instance.directPresent =
+      renderConfig->GetBoolValue("direct_present");
+    GlobalConfig::Instance.screenImageBudget =
+      renderConfig->GetIntValue("screen_image_budget_mb",
+                                GlobalConfig::Instance.screenImageBudget);
+    GlobalConfig::Instance.maxLoadedAnimations =
+      renderConfig->GetIntValue("max_loaded_animations",
+                                GlobalConfig::Instance.maxLoadedAnimations);
+    GlobalConfig::Instance.proceduralScreen =
+      renderConfig->GetBoolValue("procedural_screen",
+                                 GlobalConfig::Instance.proceduralScreen);
+    GlobalConfig::Instance.dynamicQuality =
+      renderConfig->GetBoolValue("dynamic_quality",
+                                 GlobalConfig::Instance.dynamicQuality);
   }
 
   IniSection const* controlConfig = config.GetSection("control");
@@ -38,7 +38,7 @@ void ElementBufferObject::BufferData(GLFunctions *f,
                                      std::size_t size,
                                      GLenum drawHint) const noexcept {
   if (m_Deleted) {
-    qWarning() << "ElementBufferObject::Bind(GLFunctions*):"
+    qWarning() << "ElementBufferObject::BufferData(GLFunctions*, const GLuint*, std::size_t, GLenum):"
                << "cannot provide data to an already deleted element buffer object";
     return;
   }
@@ -48,6 +48,21 @@ void ElementBufferObject::BufferData(GLFunctions *f,
                   data, drawHint);
 }
 
+void ElementBufferObject::BufferData(GLFunctions *f,
+                                     const GLushort *data,
+                                     std::size_t size,
+                                     GLenum drawHint) const noexcept {
+  if (m_Deleted) {
+    qWarning() << "ElementBufferObject::BufferData(GLFunctions*, const GLushort*, std::size_t, GLenum):"
+               << "cannot provide data to an already deleted element buffer object";
+    return;
+  }
+
+  f->glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                  static_cast<GLsizeiptr>(size * sizeof(GLushort)),
+                  data, drawHint);
+}
+
 void ElementBufferObject::Delete(GLFunctions *f) {
   if (m_Deleted) {
     return;
@@ -7,7 +7,7 @@
 
 namespace cw {
 
-Shader::Shader(QString programText, GLenum shaderType)
+Shader::Shader(QByteArray programText, GLenum shaderType)
   : m_ProgramText(std::move(programText)),
     m_ShaderType(shaderType),
     m_ShaderId(0),
@@ -26,11 +26,11 @@ bool Shader::Compile(GLFunctions *f) {
     return true;
   }
 
-  std::string programText = m_ProgramText.toStdString();
-  const char *rawProgramText = programText.data();
+  const char *rawProgramText = m_ProgramText.constData();
+  GLint programTextLength = static_cast<GLint>(m_ProgramText.size());
 
   m_ShaderId = f->glCreateShader(m_ShaderType);
-  f->glShaderSource(m_ShaderId, 1, &rawProgramText, nullptr);
+  f->glShaderSource(m_ShaderId, 1, &rawProgramText, &programTextLength);
   f->glCompileShader(m_ShaderId);
 
   GLint success;
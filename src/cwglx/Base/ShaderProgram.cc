@@ -1,14 +1,19 @@
 #include <glm/gtc/type_ptr.hpp>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
 #include "include/cwglx/Base/ShaderProgram.h"
 #include "include/cwglx/GL/GLImpl.h"
+#include "include/cwglx/GL/GLStateCache.h"
 #include "include/cwglx/Base/Shader.h"
+#include "include/cwglx/Object/ProgramCache.h"
 
 namespace cw {
 
 ShaderProgram::ShaderProgram()
   : m_ProgramId(0),
     m_Initialised(false),
-    m_Linked(false)
+    m_Linked(false),
+    m_UniformBlocks(0)
 {}
 
 ShaderProgram::~ShaderProgram() {
@@ -26,6 +31,15 @@ void ShaderProgram::InitCompilation(GLFunctions *f) {
   m_ProgramId = f->glCreateProgram();
   m_Initialised = true;
   m_CompileError.clear();
+
+  if (IsProgramBinarySupported()) {
+    // some drivers only keep what `GetBinary` needs when asked before linking
+    QOpenGLContext::currentContext()->extraFunctions()->glProgramParameteri(
+      m_ProgramId,
+      GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+      GL_TRUE
+    );
+  }
 }
 
 void ShaderProgram::AttachShader(GLFunctions *f, Shader *shader) {  // NOLINT(readability-make-member-function-const)
@@ -84,18 +98,76 @@ bool ShaderProgram::Link(GLFunctions *f) {
   return true;
 }
 
+bool ShaderProgram::LinkBinary(GLFunctions *f,
+                               GLenum format,
+                               void const* binary,
+                               GLsizei length) {
+  if (m_Linked) {
+    qWarning() << "ShaderProgram::LinkBinary(GLFunctions*, GLenum, void const*, GLsizei):"
+               << "linked shader program cannot be modified";
+    return false;
+  }
+
+  InitCompilation(f);
+  QOpenGLContext::currentContext()->extraFunctions()->glProgramBinary(
+    m_ProgramId,
+    format,
+    binary,
+    length
+  );
+
+  GLint success;
+  f->glGetProgramiv(m_ProgramId, GL_LINK_STATUS, &success);
+  if (!success) {
+    // not worth a log, the caller compiles from source instead
+    f->glDeleteProgram(m_ProgramId);
+    m_Initialised = false;
+    return false;
+  }
+
+  m_Linked = true;
+  return true;
+}
+
+QByteArray ShaderProgram::GetBinary(GLFunctions *f, GLenum *format) const {
+  if (!m_Linked) {
+    return QByteArray();
+  }
+
+  GLint length = 0;
+  f->glGetProgramiv(m_ProgramId, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return QByteArray();
+  }
+
+  QByteArray binary(length, Qt::Uninitialized);
+  GLsizei written = 0;
+  QOpenGLContext::currentContext()->extraFunctions()->glGetProgramBinary(
+    m_ProgramId,
+    length,
+    &written,
+    format,
+    binary.data()
+  );
+  binary.truncate(written);
+  return binary;
+}
+
 void ShaderProgram::UseProgram(GLFunctions *f) const {
   if (!m_Linked) {
     qWarning() << "ShaderProgram::UseProgram(GLFunctions*):"
                << "cannot activate a not linked program";
   }
-  f->glUseProgram(m_ProgramId);
+  cw::UseProgram(f, m_ProgramId);
 }
 
 void ShaderProgram::Delete(GLFunctions *f) {
   if (m_Initialised) {
+    if (GLStateCache *cache = GLStateCache::Current()) {
+      cache->ForgetProgram(m_ProgramId);
+    }
     f->glDeleteProgram(m_ProgramId);
-    m_CachedUniforms.clear();
+    m_UniformBlocks = 0;
     m_Initialised = false;
     m_Linked = false;
   }
@@ -105,108 +177,111 @@ QString ShaderProgram::GetCompileError() const {
   return m_CompileError;
 }
 
-GLint ShaderProgram::GetUniformLocation(GLFunctions *f,
-                                        QString const& uniformName) const {
-  auto it = m_CachedUniforms.find(uniformName);
-  if (it != m_CachedUniforms.end()) {
-    return *it;
+bool ShaderProgram::BindUniformBlock(GLFunctions *f,
+                                     char const* blockName,
+                                     GLuint bindingPoint) {
+  if (!m_Linked) {
+    qWarning() << "ShaderProgram::BindUniformBlock(GLFunctions*, char const*, GLuint):"
+               << "cannot bind uniform block of a not linked program";
+    return false;
   }
 
-  GLint location = f->glGetUniformLocation(m_ProgramId, uniformName.toStdString().c_str());
-  if (location < 0) {
-    qCritical() << "ShaderProgram::GetUniformLocation(GLFunctions*, QString const&):"
-                << "error retrieving uniform location of"
-                << uniformName
-                << ", glGetError() ="
-                << f->glGetError();
+  Q_ASSERT(bindingPoint < 32);
+
+  GLuint blockIndex = f->glGetUniformBlockIndex(m_ProgramId, blockName);
+  if (blockIndex == GL_INVALID_INDEX) {
+    // user supplied shaders may still use plain uniforms
+    return false;
   }
-  m_CachedUniforms.insert(uniformName, location);
-  return location;
+
+  f->glUniformBlockBinding(m_ProgramId, blockIndex, bindingPoint);
+  m_UniformBlocks |= (1u << bindingPoint);
+  return true;
 }
 
-void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               GLint value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+bool ShaderProgram::HasUniformBlock(GLuint bindingPoint) const noexcept {
+  return (m_UniformBlocks & (1u << bindingPoint)) != 0;
+}
+
+GLint ShaderProgram::GetUniformLocation(GLFunctions *f,
+                                        char const* uniformName) const {
+  if (!m_Linked) {
+    qWarning() << "ShaderProgram::GetUniformLocation(GLFunctions*, char const*):"
+               << "cannot query uniforms of a not linked program";
+    return -1;
   }
 
-  f->glUniform1i(uniformLocation, value);
-  qDebug() << "glGetError() after setting" << uniformName << "=" << f->glGetError();
+  return f->glGetUniformLocation(m_ProgramId, uniformName);
 }
 
-void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               GLuint value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+GLint ShaderProgram::GetRequiredUniformLocation(GLFunctions *f,
+                                                char const* uniformName) const {
+  GLint location = GetUniformLocation(f, uniformName);
+  if (location < 0 && m_Linked) {
+    // inactive uniforms get optimised away, so this also fires for a uniform
+    // that is declared but never read
+    qWarning() << "ShaderProgram::GetRequiredUniformLocation(GLFunctions*, char const*):"
+               << "uniform"
+               << uniformName
+               << "not found";
   }
-
-  f->glUniform1ui(uniformLocation, value);
+  return location;
 }
 
 void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               GLfloat value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+                               Uniform<GLint> uniform,
+                               GLint value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform1i(uniform.GetLocation(), value);
   }
-
-  f->glUniform1f(uniformLocation, value);
 }
 
 void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               const glm::vec3 &value) {
-  SetUniform3fv(f, uniformName, glm::value_ptr(value));
+                               Uniform<GLuint> uniform,
+                               GLuint value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform1ui(uniform.GetLocation(), value);
+  }
 }
 
 void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               const glm::vec4 &value) {
-  SetUniform4fv(f, uniformName, glm::value_ptr(value));
+                               Uniform<GLfloat> uniform,
+                               GLfloat value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform1f(uniform.GetLocation(), value);
+  }
 }
 
 void ShaderProgram::SetUniform(GLFunctions *f,
-                               const QString &uniformName,
-                               const glm::mat4 &value) {
-  SetUniformMatrix4fv(f, uniformName, glm::value_ptr(value));
+                               Uniform<glm::vec2> uniform,
+                               glm::vec2 const& value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform2fv(uniform.GetLocation(), 1, glm::value_ptr(value));
+  }
 }
 
-void ShaderProgram::SetUniform4fv(GLFunctions *f,
-                                  const QString &uniformName,
-                                  GLfloat const* value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+void ShaderProgram::SetUniform(GLFunctions *f,
+                               Uniform<glm::vec3> uniform,
+                               glm::vec3 const& value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform3fv(uniform.GetLocation(), 1, glm::value_ptr(value));
   }
-
-  f->glUniform4fv(uniformLocation, 1, value);
 }
 
-void ShaderProgram::SetUniform3fv(GLFunctions *f,
-                                  const QString &uniformName,
-                                  const GLfloat *value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+void ShaderProgram::SetUniform(GLFunctions *f,
+                               Uniform<glm::vec4> uniform,
+                               glm::vec4 const& value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniform4fv(uniform.GetLocation(), 1, glm::value_ptr(value));
   }
-
-  f->glUniform3fv(uniformLocation, 1, value);
 }
 
-void ShaderProgram::SetUniformMatrix4fv(GLFunctions *f,
-                                        const QString &uniformName,
-                                        GLfloat const* value) {
-  GLint uniformLocation = GetUniformLocation(f, uniformName);
-  if (uniformLocation < 0) {
-    return;
+void ShaderProgram::SetUniform(GLFunctions *f,
+                               Uniform<glm::mat4> uniform,
+                               glm::mat4 const& value) noexcept {
+  if (uniform.IsResolved()) {
+    f->glUniformMatrix4fv(uniform.GetLocation(), 1, GL_FALSE, glm::value_ptr(value));
   }
-
-  f->glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, value);
 }
 
 } // namespace cw
@@ -2,21 +2,19 @@
 
 #include <QImage>
 #include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLStateCache.h"
 
 namespace cw {
 
-Texture2D::Texture2D(const QImage &image,
-                     GLFunctions *f,
-                     bool linearSampling,
-                     bool anisotropyFilter)
-  : m_TextureId(0),
-    m_IsDeleted(false)
-{
-  QImage rgbaImage = image.convertToFormat(QImage::Format_RGBA8888);
-
-  f->glGenTextures(1, &m_TextureId);
-  f->glBindTexture(GL_TEXTURE_2D, m_TextureId);
+QImage PrepareTextureImage(QImage const& image) {
+  return image.convertToFormat(image.hasAlphaChannel()
+                                 ? QImage::Format_RGBA8888
+                                 : QImage::Format_RGB888);
+}
 
+void SetTexture2DSampling(GLFunctions *f,
+                          bool linearSampling,
+                          bool anisotropyFilter) {
   if (anisotropyFilter) {
     GLfloat maxAnisotropy = 1.0f;
     f->glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
@@ -40,20 +38,45 @@ Texture2D::Texture2D(const QImage &image,
                        GL_TEXTURE_MIN_FILTER,
                        GL_NEAREST);
   }
+}
+
+void TexImage2D(GLFunctions *f,
+                QImage const& prepared,
+                void const* pixels,
+                bool linearSampling,
+                bool anisotropyFilter) {
+  SetTexture2DSampling(f, linearSampling, anisotropyFilter);
 
+  // QImage scan lines are 4-byte aligned, which is also the default unpack
+  // alignment, so RGB888 rows of any width upload as they are
+  bool hasAlpha = prepared.format() == QImage::Format_RGBA8888;
   f->glTexImage2D(GL_TEXTURE_2D,
                   0,
-                  GL_RGBA,
-                  rgbaImage.width(),
-                  rgbaImage.height(),
+                  hasAlpha ? GL_RGBA8 : GL_RGB8,
+                  prepared.width(),
+                  prepared.height(),
                   0,
-                  GL_RGBA,
+                  hasAlpha ? GL_RGBA : GL_RGB,
                   GL_UNSIGNED_BYTE,
-                  rgbaImage.bits());
+                  pixels);
 
   if (linearSampling) {
     f->glGenerateMipmap(GL_TEXTURE_2D);
   }
+}
+
+Texture2D::Texture2D(const QImage &image,
+                     GLFunctions *f,
+                     bool linearSampling,
+                     bool anisotropyFilter)
+  : m_TextureId(0),
+    m_IsDeleted(false)
+{
+  QImage prepared = PrepareTextureImage(image);
+
+  f->glGenTextures(1, &m_TextureId);
+  BindTexture2D(f, m_TextureId);
+  TexImage2D(f, prepared, prepared.constBits(), linearSampling, anisotropyFilter);
 
   GLenum error = f->glGetError();
   if (error != GL_NO_ERROR) {
@@ -62,6 +85,11 @@ Texture2D::Texture2D(const QImage &image,
   }
 }
 
+Texture2D::Texture2D(GLuint textureId) noexcept
+  : m_TextureId(textureId),
+    m_IsDeleted(false)
+{}
+
 GLuint Texture2D::GetTextureId() const noexcept {
   Q_ASSERT(!m_IsDeleted && "Texture2D has been deleted");
   return m_TextureId;
@@ -72,8 +100,8 @@ void Texture2D::ActivateTexture(GLFunctions *f,
                                 GLint uniform) const noexcept
 {
   Q_ASSERT(!m_IsDeleted && "Texture2D has been deleted");
-  f->glActiveTexture(textureUnit);
-  f->glBindTexture(GL_TEXTURE_2D, m_TextureId);
+  cw::ActiveTexture(f, textureUnit);
+  BindTexture2D(f, m_TextureId);
   if (uniform >= 0) {
     f->glUniform1i(uniform, static_cast<GLint>(textureUnit) - GL_TEXTURE0);
   }
@@ -82,6 +110,9 @@ void Texture2D::ActivateTexture(GLFunctions *f,
 void Texture2D::Delete(GLFunctions *f) noexcept {
   Q_ASSERT(!m_IsDeleted && "Texture2D has been deleted");
 
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->ForgetTexture(m_TextureId);
+  }
   f->glDeleteTextures(1, &m_TextureId);
   m_IsDeleted = true;
 }
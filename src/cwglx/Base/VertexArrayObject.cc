@@ -1,5 +1,6 @@
 #include "include/cwglx/Base/VertexArrayObject.h"
 #include "include/cwglx/GL/GLImpl.h"
+#include "include/cwglx/GL/GLStateCache.h"
 
 namespace cw {
 VertexArrayObject::VertexArrayObject(GLFunctions *f)
@@ -27,13 +28,13 @@ void VertexArrayObject::Bind(GLFunctions *f) const {
                << "cannot bind an already deleted vertex array object";
     return;
   }
-  f->glBindVertexArray(m_VAO);
+  BindVertexArray(f, m_VAO);
 }
 
 void VertexArrayObject::Unbind(GLFunctions *f) const {
   Q_UNUSED(this)
 
-  f->glBindVertexArray(0);
+  BindVertexArray(f, 0);
 }
 
 void VertexArrayObject::Delete(GLFunctions *f) {
@@ -41,6 +42,9 @@ void VertexArrayObject::Delete(GLFunctions *f) {
     return;
   }
 
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->ForgetVertexArray(m_VAO);
+  }
   f->glDeleteVertexArrays(1, &m_VAO);
   m_Deleted = true;
 }
@@ -13,6 +13,10 @@ GLInfo::GLInfo(const char *vendor,
     extensions(std::move(extensions))
 {}
 
+bool GLInfo::HasExtension(QString const& extension) const {
+  return extensions.split(' ').contains(extension);
+}
+
 GLInfo GLInfo::AutoDetect(GLFunctions *f) {
   const char *vendor = reinterpret_cast<const char *>(f->glGetString(GL_VENDOR));
   const char *version = reinterpret_cast<const char *>(f->glGetString(GL_VERSION));
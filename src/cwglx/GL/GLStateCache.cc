@@ -0,0 +1,284 @@
+#include "cwglx/GL/GLStateCache.h"
+#include "cwglx/GL/GLImpl.h"
+
+namespace cw {
+
+namespace {
+
+// no real object or enum ever takes this value
+constexpr GLuint Unknown = ~static_cast<GLuint>(0);
+
+thread_local GLStateCache *CurrentCache = nullptr;
+
+} // namespace
+
+GLStateCache::GLStateCache() noexcept {
+  Invalidate();
+}
+
+GLStateCache *GLStateCache::Current() noexcept {
+  return CurrentCache;
+}
+
+void GLStateCache::MakeCurrent() noexcept {
+  CurrentCache = this;
+}
+
+void GLStateCache::DoneCurrent() noexcept {
+  CurrentCache = nullptr;
+}
+
+void GLStateCache::Invalidate() noexcept {
+  m_Program = Unknown;
+  m_VAO = Unknown;
+  m_ActiveTexture = Unknown;
+  m_Textures.fill(Unknown);
+  m_ReadFramebuffer = Unknown;
+  m_DrawFramebuffer = Unknown;
+  m_Capabilities.fill(-1);
+  m_DepthMask = -1;
+  m_BlendSrc = Unknown;
+  m_BlendDst = Unknown;
+}
+
+bool GLStateCache::Elide(bool unchanged) noexcept {
+  if (unchanged) {
+    m_Counters.elided += 1;
+  } else {
+    m_Counters.issued += 1;
+  }
+  return unchanged;
+}
+
+void GLStateCache::UseProgram(GLFunctions *f, GLuint program) noexcept {
+  if (Elide(m_Program == program)) {
+    return;
+  }
+  f->glUseProgram(program);
+  m_Program = program;
+}
+
+void GLStateCache::BindVertexArray(GLFunctions *f, GLuint vao) noexcept {
+  if (Elide(m_VAO == vao)) {
+    return;
+  }
+  f->glBindVertexArray(vao);
+  m_VAO = vao;
+}
+
+void GLStateCache::ActiveTexture(GLFunctions *f, GLenum textureUnit) noexcept {
+  if (Elide(m_ActiveTexture == textureUnit)) {
+    return;
+  }
+  f->glActiveTexture(textureUnit);
+  m_ActiveTexture = textureUnit;
+}
+
+void GLStateCache::BindTexture2D(GLFunctions *f, GLuint texture) noexcept {
+  std::size_t unit = m_ActiveTexture - GL_TEXTURE0;
+  if (m_ActiveTexture == Unknown || unit >= TrackedTextureUnits) {
+    m_Counters.issued += 1;
+    f->glBindTexture(GL_TEXTURE_2D, texture);
+    return;
+  }
+
+  if (Elide(m_Textures[unit] == texture)) {
+    return;
+  }
+  f->glBindTexture(GL_TEXTURE_2D, texture);
+  m_Textures[unit] = texture;
+}
+
+void GLStateCache::BindFramebuffer(GLFunctions *f, GLenum target, GLuint fbo) noexcept {
+  switch (target) {
+    case GL_READ_FRAMEBUFFER:
+      if (Elide(m_ReadFramebuffer == fbo)) {
+        return;
+      }
+      m_ReadFramebuffer = fbo;
+      break;
+    case GL_DRAW_FRAMEBUFFER:
+      if (Elide(m_DrawFramebuffer == fbo)) {
+        return;
+      }
+      m_DrawFramebuffer = fbo;
+      break;
+    default:
+      if (Elide(m_ReadFramebuffer == fbo && m_DrawFramebuffer == fbo)) {
+        return;
+      }
+      m_ReadFramebuffer = fbo;
+      m_DrawFramebuffer = fbo;
+      break;
+  }
+  f->glBindFramebuffer(target, fbo);
+}
+
+std::size_t GLStateCache::CapabilityToIndex(GLenum capability) noexcept {
+  switch (capability) {
+    case GL_BLEND: return BlendIndex;
+    case GL_DEPTH_TEST: return DepthTestIndex;
+    case GL_CULL_FACE: return CullFaceIndex;
+    default: return CapabilityCount;
+  }
+}
+
+void GLStateCache::SetCapability(GLFunctions *f, GLenum capability, bool enabled) noexcept {
+  std::size_t index = CapabilityToIndex(capability);
+  if (index != CapabilityCount) {
+    std::int8_t state = enabled ? 1 : 0;
+    if (Elide(m_Capabilities[index] == state)) {
+      return;
+    }
+    m_Capabilities[index] = state;
+  } else {
+    m_Counters.issued += 1;
+  }
+
+  if (enabled) {
+    f->glEnable(capability);
+  } else {
+    f->glDisable(capability);
+  }
+}
+
+bool GLStateCache::IsCapabilityEnabled(GLFunctions *f, GLenum capability) noexcept {
+  std::size_t index = CapabilityToIndex(capability);
+  if (index != CapabilityCount && m_Capabilities[index] >= 0) {
+    return m_Capabilities[index] == 1;
+  }
+
+  bool enabled = f->glIsEnabled(capability) == GL_TRUE;
+  if (index != CapabilityCount) {
+    m_Capabilities[index] = enabled ? 1 : 0;
+  }
+  return enabled;
+}
+
+void GLStateCache::DepthMask(GLFunctions *f, GLboolean mask) noexcept {
+  std::int8_t state = mask ? 1 : 0;
+  if (Elide(m_DepthMask == state)) {
+    return;
+  }
+  f->glDepthMask(mask);
+  m_DepthMask = state;
+}
+
+void GLStateCache::BlendFunc(GLFunctions *f, GLenum srcFactor, GLenum dstFactor) noexcept {
+  if (Elide(m_BlendSrc == srcFactor && m_BlendDst == dstFactor)) {
+    return;
+  }
+  f->glBlendFunc(srcFactor, dstFactor);
+  m_BlendSrc = srcFactor;
+  m_BlendDst = dstFactor;
+}
+
+void GLStateCache::ForgetProgram(GLuint program) noexcept {
+  if (m_Program == program) {
+    m_Program = Unknown;
+  }
+}
+
+void GLStateCache::ForgetVertexArray(GLuint vao) noexcept {
+  if (m_VAO == vao) {
+    m_VAO = 0;
+  }
+}
+
+void GLStateCache::ForgetTexture(GLuint texture) noexcept {
+  for (GLuint &bound : m_Textures) {
+    if (bound == texture) {
+      bound = 0;
+    }
+  }
+}
+
+void GLStateCache::ForgetFramebuffer(GLuint fbo) noexcept {
+  if (m_ReadFramebuffer == fbo) {
+    m_ReadFramebuffer = 0;
+  }
+  if (m_DrawFramebuffer == fbo) {
+    m_DrawFramebuffer = 0;
+  }
+}
+
+GLStateCache::Counters GLStateCache::TakeCounters() noexcept {
+  Counters ret = m_Counters;
+  m_Counters = Counters {};
+  return ret;
+}
+
+void UseProgram(GLFunctions *f, GLuint program) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->UseProgram(f, program);
+  } else {
+    f->glUseProgram(program);
+  }
+}
+
+void BindVertexArray(GLFunctions *f, GLuint vao) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->BindVertexArray(f, vao);
+  } else {
+    f->glBindVertexArray(vao);
+  }
+}
+
+void ActiveTexture(GLFunctions *f, GLenum textureUnit) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->ActiveTexture(f, textureUnit);
+  } else {
+    f->glActiveTexture(textureUnit);
+  }
+}
+
+void BindTexture2D(GLFunctions *f, GLuint texture) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->BindTexture2D(f, texture);
+  } else {
+    f->glBindTexture(GL_TEXTURE_2D, texture);
+  }
+}
+
+void BindFramebuffer(GLFunctions *f, GLenum target, GLuint fbo) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->BindFramebuffer(f, target, fbo);
+  } else {
+    f->glBindFramebuffer(target, fbo);
+  }
+}
+
+void SetCapability(GLFunctions *f, GLenum capability, bool enabled) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->SetCapability(f, capability, enabled);
+  } else if (enabled) {
+    f->glEnable(capability);
+  } else {
+    f->glDisable(capability);
+  }
+}
+
+bool IsCapabilityEnabled(GLFunctions *f, GLenum capability) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    return cache->IsCapabilityEnabled(f, capability);
+  }
+  return f->glIsEnabled(capability) == GL_TRUE;
+}
+
+void DepthMask(GLFunctions *f, GLboolean mask) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->DepthMask(f, mask);
+  } else {
+    f->glDepthMask(mask);
+  }
+}
+
+void BlendFunc(GLFunctions *f, GLenum srcFactor, GLenum dstFactor) noexcept {
+  if (GLStateCache *cache = GLStateCache::Current()) {
+    cache->BlendFunc(f, srcFactor, dstFactor);
+  } else {
+    f->glBlendFunc(srcFactor, dstFactor);
+  }
+}
+
+} // namespace cw
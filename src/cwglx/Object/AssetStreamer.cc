@@ -0,0 +1,383 @@
+#include "cwglx/Object/AssetStreamer.h"
+
+#include <cstring>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QObject>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QThread>
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/Base/Texture.h"
+#include "cwglx/Object/TextureCache.h"
+#include "cwglx/Object/WavefrontLoader.h"
+#include "util/FileUtil.h"
+
+namespace cw {
+
+AssetStreamer::AssetStreamer()
+  : m_UploadThread(nullptr),
+    m_Uploader(nullptr),
+    m_UploadContext(nullptr),
+    m_UploadSurface(nullptr),
+    m_UploadGL(nullptr),
+    m_ScratchVAO(0),
+    m_PixelBuffer(0)
+{}
+
+AssetStreamer::~AssetStreamer() {
+  if (m_UploadThread) {
+    qWarning() << "AssetStreamer::~AssetStreamer():"
+               << "asset streamer deleted before releasing relevant OpenGL resources";
+  }
+
+  delete m_UploadSurface;
+}
+
+void AssetStreamer::Start(QOpenGLContext *shareContext) {
+  // both the context and the offscreen surface must be created on GUI thread
+  m_UploadContext = new QOpenGLContext();
+  m_UploadContext->setFormat(shareContext->format());
+  m_UploadContext->setShareContext(shareContext);
+  if (!m_UploadContext->create()) {
+    qCritical() << "AssetStreamer::Start(QOpenGLContext*):"
+                << "failed creating OpenGL context";
+    std::abort();
+  }
+
+  m_UploadSurface = new QOffscreenSurface();
+  m_UploadSurface->setFormat(m_UploadContext->format());
+  m_UploadSurface->create();
+
+  m_UploadThread = new QThread();
+  m_Uploader = new QObject();
+  m_UploadContext->moveToThread(m_UploadThread);
+  m_Uploader->moveToThread(m_UploadThread);
+  QObject::connect(m_UploadThread, &QThread::finished, m_Uploader, &QObject::deleteLater);
+  m_UploadThread->start();
+
+  QMetaObject::invokeMethod(m_Uploader,
+                            [this] { InitializeUploader(); },
+                            Qt::QueuedConnection);
+}
+
+void AssetStreamer::Shutdown(GLFunctions *f) {
+  if (!m_UploadThread) {
+    return;
+  }
+
+  // workers post their results to the uploader, so they must be done before
+  // the uploader goes away. Everything they posted is queued in front of
+  // `DeleteUploader`
+  m_Workers.waitForDone();
+  QMetaObject::invokeMethod(m_Uploader,
+                            [this] { DeleteUploader(); },
+                            Qt::BlockingQueuedConnection);
+  m_UploadThread->quit();
+  m_UploadThread->wait();
+  delete m_UploadThread;
+  m_UploadThread = nullptr;
+  m_Uploader = nullptr;
+
+  // objects created on a shared context may be deleted from any context
+  // sharing with it
+  std::vector<FinishedUpload> finished;
+  {
+    QMutexLocker locker(&m_FinishedMutex);
+    finished.swap(m_Finished);
+  }
+  for (FinishedUpload &upload : finished) {
+    if (upload.fence) {
+      f->glDeleteSync(upload.fence);
+    }
+    if (upload.discard) {
+      upload.discard(f);
+    }
+  }
+}
+
+void AssetStreamer::RequestTexture(QString const& fileName,
+                                   bool linearSampling,
+                                   bool anisotropyFilter,
+                                   TextureCallback done) {
+  m_Workers.start([this, fileName, linearSampling, anisotropyFilter, done] {
+    // shared, queued functors must be copyable
+    std::shared_ptr<TextureData> data =
+      std::make_shared<TextureData>(PrepareTexture(fileName));
+    if (data->IsNull()) {
+      qWarning() << "AssetStreamer::RequestTexture(...):"
+                 << "cannot load image:"
+                 << fileName;
+      PushFinished(FinishedUpload {
+        .fence = nullptr,
+        .complete = [done](GLFunctions *f) { done(f, nullptr); },
+        .discard = nullptr
+      });
+      return;
+    }
+
+    QMetaObject::invokeMethod(
+      m_Uploader,
+      [this, data, linearSampling, anisotropyFilter, done] {
+        UploadTexture(data, linearSampling, anisotropyFilter, done);
+      },
+      Qt::QueuedConnection
+    );
+  });
+}
+
+void AssetStreamer::RequestObject(QString const& basePath,
+                                  QString const& fileName,
+                                  ObjectCallback done) {
+  m_Workers.start([this, basePath, fileName, done] {
+    // shared, queued functors must be copyable
+    std::shared_ptr<ObjectData> data =
+      std::make_shared<ObjectData>(PrepareObject(basePath, fileName));
+    QMetaObject::invokeMethod(
+      m_Uploader,
+      [this, data, done] { UploadObject(data, done); },
+      Qt::QueuedConnection
+    );
+  });
+}
+
+void AssetStreamer::RequestImage(QString const& fileName,
+                                 QSize size,
+                                 ImageCallback done) {
+  m_Workers.start([this, fileName, size, done] {
+    QImage image;
+    std::unique_ptr<MappedFile> file = MappedFile::Open(fileName);
+    if (!file || !image.loadFromData(file->GetBytes()) || image.isNull()) {
+      qWarning() << "AssetStreamer::RequestImage(...):"
+                 << "cannot load image:"
+                 << fileName;
+      image = QImage();
+    } else {
+      if (image.size() != size) {
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+      }
+      image = image.convertToFormat(QImage::Format_RGBA8888);
+    }
+
+    // QImage is implicitly shared, copying it out of the functor is cheap
+    PushFinished(FinishedUpload {
+      .fence = nullptr,
+      .complete = [image, done](GLFunctions *f) { done(f, QImage(image)); },
+      .discard = nullptr
+    });
+  });
+}
+
+void AssetStreamer::RequestUpload(UploadTask task) {
+  QMetaObject::invokeMethod(
+    m_Uploader,
+    [this, task] {
+      UploadResult result = task(m_UploadGL);
+      if (!result.complete) {
+        result.complete = [](GLFunctions*) {};
+      }
+
+      GLsync fence = m_UploadGL->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      m_UploadGL->glFlush();
+      PushFinished(FinishedUpload {
+        .fence = fence,
+        .complete = std::move(result.complete),
+        .discard = std::move(result.discard)
+      });
+    },
+    Qt::QueuedConnection
+  );
+}
+
+bool AssetStreamer::Poll(GLFunctions *f) {
+  std::vector<FinishedUpload> signalled;
+  {
+    QMutexLocker locker(&m_FinishedMutex);
+    auto it = m_Finished.begin();
+    while (it != m_Finished.end()) {
+      if (it->fence) {
+        GLenum result = f->glClientWaitSync(it->fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+          ++it;
+          continue;
+        }
+        f->glDeleteSync(it->fence);
+      }
+
+      signalled.push_back(std::move(*it));
+      it = m_Finished.erase(it);
+    }
+  }
+
+  // callbacks may request more assets, so they run without the lock held
+  for (FinishedUpload &upload : signalled) {
+    upload.complete(f);
+  }
+  return !signalled.empty();
+}
+
+void AssetStreamer::InitializeUploader() {
+  if (!m_UploadContext->makeCurrent(m_UploadSurface)) {
+    qCritical() << "AssetStreamer::InitializeUploader():"
+                << "failed making OpenGL context current";
+    std::abort();
+  }
+
+  m_UploadGL = new GLFunctions();
+  m_UploadGL->initializeOpenGLFunctions();
+  m_UploadGL->glGenVertexArrays(1, &m_ScratchVAO);
+  m_UploadGL->glGenBuffers(1, &m_PixelBuffer);
+}
+
+void AssetStreamer::DeleteUploader() {
+  m_UploadGL->glDeleteVertexArrays(1, &m_ScratchVAO);
+  m_UploadGL->glDeleteBuffers(1, &m_PixelBuffer);
+  m_ScratchVAO = 0;
+  m_PixelBuffer = 0;
+
+  m_UploadContext->doneCurrent();
+  delete m_UploadContext;
+  m_UploadContext = nullptr;
+  delete m_UploadGL;
+  m_UploadGL = nullptr;
+}
+
+void AssetStreamer::UploadTexture(std::shared_ptr<TextureData> const& data,
+                                  bool linearSampling,
+                                  bool anisotropyFilter,
+                                  TextureCallback const& done) {
+  GLFunctions *f = m_UploadGL;
+
+  GLuint textureId = 0;
+  f->glGenTextures(1, &textureId);
+  f->glBindTexture(GL_TEXTURE_2D, textureId);
+
+  // re-specifying the storage orphans whatever the previous upload is still
+  // reading from, instead of waiting for it
+  GLsizeiptr size = static_cast<GLsizeiptr>(data->GetPixelsSize());
+  f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer);
+  f->glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+  void *mapped = f->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                     0,
+                                     size,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (mapped) {
+    std::memcpy(mapped, data->GetPixels(), static_cast<std::size_t>(size));
+    f->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    UploadTextureData(f, *data, nullptr, linearSampling, anisotropyFilter);
+  } else {
+    f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    UploadTextureData(f, *data, data->GetPixels(), linearSampling, anisotropyFilter);
+  }
+  f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+
+  GLenum error = f->glGetError();
+  if (error != GL_NO_ERROR) {
+    qWarning() << "AssetStreamer::UploadTexture(...):"
+               << "failed uploading texture:"
+               << error;
+    f->glDeleteTextures(1, &textureId);
+    PushFinished(FinishedUpload {
+      .fence = nullptr,
+      .complete = [done](GLFunctions *f) { done(f, nullptr); },
+      .discard = nullptr
+    });
+    return;
+  }
+
+  // the render thread waits on this fence from its own context, so it must
+  // be flushed before handing over
+  GLsync fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  f->glFlush();
+
+  PushFinished(FinishedUpload {
+    .fence = fence,
+    .complete = [textureId, done](GLFunctions *f) {
+      done(f, std::make_unique<Texture2D>(textureId));
+    },
+    .discard = [textureId](GLFunctions *f) {
+      f->glDeleteTextures(1, &textureId);
+    }
+  });
+}
+
+namespace {
+
+// queued functors must be copyable, so the buffers are owned through this
+// until the render thread takes them over
+struct UploadedBuffers {
+  std::unique_ptr<CompactVertexVBO> vbo;
+  std::unique_ptr<ElementBufferObject> ebo;
+};
+
+} // namespace
+
+void AssetStreamer::UploadObject(std::shared_ptr<ObjectData> const& data,
+                                 ObjectCallback const& done) {
+  GLFunctions *f = m_UploadGL;
+  MeshCacheContent const& content = data->content;
+
+  std::shared_ptr<UploadedBuffers> buffers = std::make_shared<UploadedBuffers>();
+  buffers->vbo = std::make_unique<CompactVertexVBO>(f);
+  buffers->ebo = std::make_unique<ElementBufferObject>(f);
+
+  f->glBindVertexArray(m_ScratchVAO);
+  buffers->vbo->Bind(f);
+  buffers->vbo->BufferData(f, content.vertices, content.vertexCount, GL_STATIC_DRAW);
+  buffers->ebo->Bind(f);
+  if (content.indexType == GL_UNSIGNED_SHORT) {
+    buffers->ebo->BufferData(f,
+                             static_cast<GLushort const*>(content.indices),
+                             content.indexCount,
+                             GL_STATIC_DRAW);
+  } else {
+    buffers->ebo->BufferData(f,
+                             static_cast<GLuint const*>(content.indices),
+                             content.indexCount,
+                             GL_STATIC_DRAW);
+  }
+  f->glBindVertexArray(0);
+  buffers->vbo->Unbind(f);
+
+  GLsync fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  f->glFlush();
+
+  PushFinished(FinishedUpload {
+    .fence = fence,
+    .complete = [data, buffers, done](GLFunctions *f) {
+      // vertex arrays are not shared between contexts, the one used for
+      // drawing must be made on the render thread
+      std::unique_ptr<VertexArrayObject> vao = std::make_unique<VertexArrayObject>(f);
+      vao->Bind(f);
+      buffers->vbo->Bind(f);
+      buffers->ebo->Bind(f);
+      vao->Unbind(f);
+
+      MeshCacheContent const& content = data->content;
+      done(f, StreamedObject {
+        .object = GLObject {
+          std::move(vao),
+          std::move(buffers->vbo),
+          std::move(buffers->ebo),
+          static_cast<GLsizei>(content.indexCount),
+          content.indexType,
+          nullptr
+        },
+        .materialName = content.materialName,
+        .materialLibraries = std::move(data->materialLibraries)
+      });
+    },
+    .discard = [buffers](GLFunctions *f) {
+      buffers->vbo->Delete(f);
+      buffers->ebo->Delete(f);
+    }
+  });
+}
+
+void AssetStreamer::PushFinished(FinishedUpload &&upload) {
+  QMutexLocker locker(&m_FinishedMutex);
+  m_Finished.push_back(std::move(upload));
+}
+
+} // namespace cw
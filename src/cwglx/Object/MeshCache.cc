@@ -0,0 +1,190 @@
+#include "cwglx/Object/MeshCache.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include "cwglx/GL/GLImpl.h"
+
+namespace cw {
+
+namespace {
+
+// bump whenever the layout of the file or of `CompactVertex` changes
+constexpr std::uint32_t MeshCacheVersion = 1;
+constexpr std::array<char, 4> MeshCacheMagic { 'C', 'W', 'M', 'C' };
+
+struct MeshCacheHeader {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t sourceHash;
+  std::uint32_t vertexSize;
+  std::uint32_t vertexCount;
+  std::uint32_t indexType;
+  std::uint32_t indexCount;
+  // UTF-8, material libraries separated by '\n'
+  std::uint32_t materialLibrariesLength;
+  std::uint32_t materialNameLength;
+};
+
+static_assert(std::is_trivially_copyable_v<MeshCacheHeader>);
+static_assert(sizeof(MeshCacheHeader) == 40);
+
+constexpr std::size_t AlignUp4(std::size_t value) noexcept {
+  return (value + 3) / 4 * 4;
+}
+
+std::size_t IndexSize(GLenum indexType) noexcept {
+  return indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+}
+
+} // namespace
+
+MeshCacheFile::MeshCacheFile(QString const& path)
+  : m_File(path),
+    m_Mapped(nullptr)
+{}
+
+MeshCacheFile::~MeshCacheFile() {
+  if (m_Mapped) {
+    m_File.unmap(m_Mapped);
+  }
+}
+
+std::unique_ptr<MeshCacheFile>
+MeshCacheFile::Open(QString const& path, std::uint64_t sourceHash) {
+  std::unique_ptr<MeshCacheFile> ret { new MeshCacheFile(path) };
+  if (!ret->m_File.open(QIODevice::ReadOnly)) {
+    return nullptr;
+  }
+
+  qint64 fileSize = ret->m_File.size();
+  if (fileSize < static_cast<qint64>(sizeof(MeshCacheHeader))) {
+    return nullptr;
+  }
+
+  ret->m_Mapped = ret->m_File.map(0, fileSize);
+  if (!ret->m_Mapped) {
+    return nullptr;
+  }
+
+  MeshCacheHeader header {};
+  std::memcpy(&header, ret->m_Mapped, sizeof(header));
+  if (header.magic != MeshCacheMagic
+      || header.version != MeshCacheVersion
+      || header.sourceHash != sourceHash
+      || header.vertexSize != sizeof(CompactVertex)
+      || (header.indexType != GL_UNSIGNED_SHORT && header.indexType != GL_UNSIGNED_INT)) {
+    return nullptr;
+  }
+
+  std::size_t stringsOffset = sizeof(MeshCacheHeader);
+  std::size_t verticesOffset = AlignUp4(stringsOffset
+                                        + header.materialLibrariesLength
+                                        + header.materialNameLength);
+  std::size_t indicesOffset = verticesOffset + header.vertexCount * sizeof(CompactVertex);
+  std::size_t expectedSize = indicesOffset + header.indexCount * IndexSize(header.indexType);
+  if (static_cast<std::size_t>(fileSize) != expectedSize) {
+    qWarning() << "MeshCacheFile::Open(QString const&, std::uint64_t):"
+               << "mesh cache"
+               << path
+               << "is corrupted";
+    return nullptr;
+  }
+
+  char const* strings = reinterpret_cast<char const*>(ret->m_Mapped + stringsOffset);
+  QString materialLibraries = QString::fromUtf8(
+    strings,
+    static_cast<qsizetype>(header.materialLibrariesLength)
+  );
+
+  MeshCacheContent &content = ret->m_Content;
+  content.sourceHash = header.sourceHash;
+  if (!materialLibraries.isEmpty()) {
+    content.materialLibraries = materialLibraries.split('\n');
+  }
+  content.materialName = QString::fromUtf8(
+    strings + header.materialLibrariesLength,
+    static_cast<qsizetype>(header.materialNameLength)
+  );
+  content.vertices = reinterpret_cast<CompactVertex const*>(ret->m_Mapped + verticesOffset);
+  content.vertexCount = header.vertexCount;
+  content.indices = ret->m_Mapped + indicesOffset;
+  content.indexCount = header.indexCount;
+  content.indexType = header.indexType;
+  return ret;
+}
+
+bool WriteMeshCache(QString const& path, MeshCacheContent const& content) {
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  // written to a temporary file and renamed, so that a crashed write never
+  // leaves a half written cache behind
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "WriteMeshCache(QString const&, MeshCacheContent const&):"
+               << "cannot open"
+               << path
+               << "for writing";
+    return false;
+  }
+
+  QByteArray materialLibraries = content.materialLibraries.join('\n').toUtf8();
+  QByteArray materialName = content.materialName.toUtf8();
+
+  MeshCacheHeader header {
+    .magic = MeshCacheMagic,
+    .version = MeshCacheVersion,
+    .sourceHash = content.sourceHash,
+    .vertexSize = sizeof(CompactVertex),
+    .vertexCount = static_cast<std::uint32_t>(content.vertexCount),
+    .indexType = content.indexType,
+    .indexCount = static_cast<std::uint32_t>(content.indexCount),
+    .materialLibrariesLength = static_cast<std::uint32_t>(materialLibraries.size()),
+    .materialNameLength = static_cast<std::uint32_t>(materialName.size())
+  };
+
+  std::size_t stringsEnd = sizeof(header) + materialLibraries.size() + materialName.size();
+  QByteArray padding(static_cast<qsizetype>(AlignUp4(stringsEnd) - stringsEnd), '\0');
+
+  file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  file.write(materialLibraries);
+  file.write(materialName);
+  file.write(padding);
+  file.write(reinterpret_cast<char const*>(content.vertices),
+             static_cast<qint64>(content.vertexCount * sizeof(CompactVertex)));
+  file.write(reinterpret_cast<char const*>(content.indices),
+             static_cast<qint64>(content.indexCount * IndexSize(content.indexType)));
+
+  if (!file.commit()) {
+    qWarning() << "WriteMeshCache(QString const&, MeshCacheContent const&):"
+               << "failed writing"
+               << path
+               << ":"
+               << file.errorString();
+    return false;
+  }
+  return true;
+}
+
+QString GetMeshCachePath(QString const& basePath, QString const& fileName) {
+  QByteArray base = basePath.toUtf8();
+  std::uint64_t baseHash = HashBytes(base.constData(), static_cast<std::size_t>(base.size()));
+  return QStringLiteral("./cache/model/%1-%2.cwmesh")
+    .arg(baseHash, 16, 16, QLatin1Char('0'))
+    .arg(fileName);
+}
+
+std::uint64_t HashBytes(char const* data, std::size_t size, std::uint64_t seed) noexcept {
+  std::uint64_t hash = seed;
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+} // namespace cw
@@ -0,0 +1,257 @@
+#include "cwglx/Object/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <glm/geometric.hpp>
+#include "cwglx/Object/Vertex.h"
+
+namespace cw {
+
+float ComputeACMR(std::vector<GLuint> const& indices,
+                  std::size_t vertexCount,
+                  std::size_t cacheSize) {
+  std::size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return 0.0f;
+  }
+
+  // with a FIFO cache, a vertex stays cached until `cacheSize` other
+  // vertices have been loaded after it
+  std::vector<std::size_t> loadedAt(vertexCount, 0);
+  std::vector<bool> everLoaded(vertexCount, false);
+  std::size_t misses = 0;
+  for (GLuint index : indices) {
+    if (everLoaded[index] && misses - loadedAt[index] < cacheSize) {
+      continue;
+    }
+    everLoaded[index] = true;
+    loadedAt[index] = misses;
+    misses += 1;
+  }
+
+  return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+namespace {
+
+std::int64_t SkipDeadEnd(std::vector<GLuint> &deadEnd,
+                         std::vector<std::uint32_t> const& liveCount,
+                         std::size_t *cursor) {
+  while (!deadEnd.empty()) {
+    GLuint vertex = deadEnd.back();
+    deadEnd.pop_back();
+    if (liveCount[vertex] > 0) {
+      return vertex;
+    }
+  }
+
+  while (*cursor < liveCount.size()) {
+    std::size_t vertex = *cursor;
+    *cursor += 1;
+    if (liveCount[vertex] > 0) {
+      return static_cast<std::int64_t>(vertex);
+    }
+  }
+
+  return -1;
+}
+
+} // namespace
+
+void OptimizeVertexCache(std::vector<GLuint> &indices,
+                         std::size_t vertexCount,
+                         std::vector<std::size_t> *clusters,
+                         std::size_t cacheSize) {
+  std::size_t triangleCount = indices.size() / 3;
+  if (clusters) {
+    clusters->clear();
+    clusters->push_back(0);
+  }
+  if (triangleCount == 0 || vertexCount == 0) {
+    return;
+  }
+
+  // vertex -> triangle adjacency, packed
+  std::vector<std::uint32_t> liveCount(vertexCount, 0);
+  for (GLuint index : indices) {
+    liveCount[index] += 1;
+  }
+
+  std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+  for (std::size_t i = 0; i < vertexCount; i++) {
+    offsets[i + 1] = offsets[i] + liveCount[i];
+  }
+
+  std::vector<std::uint32_t> adjacency(triangleCount * 3);
+  {
+    std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++) {
+      for (std::size_t k = 0; k < 3; k++) {
+        adjacency[fill[indices[triangle * 3 + k]]++] = static_cast<std::uint32_t>(triangle);
+      }
+    }
+  }
+
+  std::vector<std::size_t> cacheTime(vertexCount, 0);
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<GLuint> deadEnd;
+  std::vector<GLuint> candidates;
+  std::vector<GLuint> output;
+  deadEnd.reserve(triangleCount * 3);
+  output.reserve(triangleCount * 3);
+
+  std::size_t timeStamp = cacheSize + 1;
+  std::size_t cursor = 0;
+  std::int64_t fanning = 0;
+  while (fanning >= 0) {
+    candidates.clear();
+
+    for (std::uint32_t i = offsets[fanning]; i < offsets[fanning + 1]; i++) {
+      std::uint32_t triangle = adjacency[i];
+      if (emitted[triangle]) {
+        continue;
+      }
+
+      for (std::size_t k = 0; k < 3; k++) {
+        GLuint vertex = indices[triangle * 3 + k];
+        output.push_back(vertex);
+        deadEnd.push_back(vertex);
+        candidates.push_back(vertex);
+        liveCount[vertex] -= 1;
+        if (timeStamp - cacheTime[vertex] > cacheSize) {
+          cacheTime[vertex] = timeStamp;
+          timeStamp += 1;
+        }
+      }
+      emitted[triangle] = true;
+    }
+
+    // prefer the candidate that stays in cache for the longest while all of
+    // its remaining triangles get emitted
+    std::int64_t next = -1;
+    std::int64_t bestPriority = -1;
+    for (GLuint vertex : candidates) {
+      if (liveCount[vertex] == 0) {
+        continue;
+      }
+
+      std::int64_t priority = 0;
+      std::size_t age = timeStamp - cacheTime[vertex];
+      if (age + 2 * liveCount[vertex] <= cacheSize) {
+        priority = static_cast<std::int64_t>(age);
+      }
+      if (priority > bestPriority) {
+        bestPriority = priority;
+        next = vertex;
+      }
+    }
+
+    if (next == -1) {
+      next = SkipDeadEnd(deadEnd, liveCount, &cursor);
+      if (clusters && next >= 0 && !output.empty()) {
+        clusters->push_back(output.size());
+      }
+    }
+    fanning = next;
+  }
+
+  indices.swap(output);
+}
+
+void OptimizeOverdraw(std::vector<GLuint> &indices,
+                      std::vector<Vertex> const& vertices,
+                      std::vector<std::size_t> const& clusters,
+                      float threshold,
+                      std::size_t cacheSize) {
+  if (clusters.size() < 2) {
+    return;
+  }
+
+  struct Cluster {
+    std::size_t begin;
+    std::size_t end;
+    float sortKey;
+  };
+
+  glm::vec3 meshCentroid { 0.0f };
+  float meshArea = 0.0f;
+
+  std::vector<Cluster> sorted;
+  std::vector<glm::vec3> clusterCentroids;
+  std::vector<glm::vec3> clusterNormals;
+  sorted.reserve(clusters.size());
+  for (std::size_t i = 0; i < clusters.size(); i++) {
+    std::size_t begin = clusters[i];
+    std::size_t end = i + 1 < clusters.size() ? clusters[i + 1] : indices.size();
+
+    glm::vec3 centroid { 0.0f };
+    glm::vec3 normal { 0.0f };
+    float area = 0.0f;
+    for (std::size_t j = begin; j < end; j += 3) {
+      glm::vec3 const& v0 = vertices[indices[j]].vertexCoord;
+      glm::vec3 const& v1 = vertices[indices[j + 1]].vertexCoord;
+      glm::vec3 const& v2 = vertices[indices[j + 2]].vertexCoord;
+
+      // length of the cross product is twice the triangle area
+      glm::vec3 cross = glm::cross(v1 - v0, v2 - v0);
+      float triangleArea = glm::length(cross);
+      centroid += (v0 + v1 + v2) / 3.0f * triangleArea;
+      normal += cross;
+      area += triangleArea;
+    }
+
+    meshCentroid += centroid;
+    meshArea += area;
+    if (area > 0.0f) {
+      centroid /= area;
+    }
+    if (glm::dot(normal, normal) > 0.0f) {
+      normal = glm::normalize(normal);
+    }
+
+    sorted.push_back(Cluster { begin, end, 0.0f });
+    clusterCentroids.push_back(centroid);
+    clusterNormals.push_back(normal);
+  }
+
+  if (meshArea > 0.0f) {
+    meshCentroid /= meshArea;
+  }
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    sorted[i].sortKey = glm::dot(clusterCentroids[i] - meshCentroid, clusterNormals[i]);
+  }
+
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [] (Cluster const& lhs, Cluster const& rhs) {
+                     return lhs.sortKey > rhs.sortKey;
+                   });
+
+  std::vector<GLuint> output;
+  output.reserve(indices.size());
+  for (Cluster const& cluster : sorted) {
+    output.insert(output.end(),
+                  indices.begin() + static_cast<std::ptrdiff_t>(cluster.begin),
+                  indices.begin() + static_cast<std::ptrdiff_t>(cluster.end));
+  }
+
+  float acmrBefore = ComputeACMR(indices, vertices.size(), cacheSize);
+  float acmrAfter = ComputeACMR(output, vertices.size(), cacheSize);
+  if (acmrAfter <= acmrBefore * threshold) {
+    indices.swap(output);
+  }
+}
+
+MeshOptimizeStats OptimizeMesh(std::vector<GLuint> &indices,
+                               std::vector<Vertex> const& vertices) {
+  MeshOptimizeStats stats {};
+  stats.acmrBefore = ComputeACMR(indices, vertices.size());
+
+  std::vector<std::size_t> clusters;
+  OptimizeVertexCache(indices, vertices.size(), &clusters);
+  OptimizeOverdraw(indices, vertices, clusters);
+
+  stats.acmrAfter = ComputeACMR(indices, vertices.size());
+  return stats;
+}
+
+} // namespace cw
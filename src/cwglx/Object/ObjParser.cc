@@ -0,0 +1,464 @@
+#include "cwglx/Object/ObjParser.h"
+
+#include <algorithm>
+#include <thread>
+#include "util/StringView.h"
+
+namespace cw {
+
+namespace {
+
+// Reads up to `capacity` floats, returns how many were read or -1 on bad input
+int ParseFloats(std::string_view line, float *out, int capacity) noexcept {
+  int count = 0;
+  for (std::string_view token = NextToken(&line);
+       !token.empty();
+       token = NextToken(&line)) {
+    if (count == capacity || !ParseNumber(token, &out[count])) {
+      return -1;
+    }
+    count += 1;
+  }
+  return count;
+}
+
+// Everything one thread produced. Negative OBJ indices count backwards from
+// the current end of the vertex list, which is only known relative to the
+// chunk until all chunks before it are done, so they are resolved as chunk
+// local and fixed up when merging
+struct ObjChunk {
+  ObjData data;
+  std::vector<std::size_t> relativeCoords;
+  std::vector<std::size_t> relativeTexCoords;
+  std::vector<std::size_t> relativeNormals;
+  bool hasMaterial = false;
+  std::size_t lineCount = 0;
+};
+
+enum class IndexKind { Absolute, Relative, Missing, Bad };
+
+IndexKind ResolveIndex(std::string_view token,
+                       std::size_t localCount,
+                       std::int32_t *out) noexcept {
+  if (token.empty()) {
+    *out = -1;
+    return IndexKind::Missing;
+  }
+
+  std::int32_t value;
+  if (!ParseNumber(token, &value) || value == 0) {
+    return IndexKind::Bad;
+  }
+
+  if (value > 0) {
+    *out = value - 1;
+    return IndexKind::Absolute;
+  }
+  // may go below zero, pointing into an earlier chunk
+  *out = static_cast<std::int32_t>(localCount) + value;
+  return IndexKind::Relative;
+}
+
+// `relative` receives one bit per component that was a relative index
+bool ParseFaceVertex(std::string_view token,
+                     ObjData const& data,
+                     ObjFaceVertex *out,
+                     unsigned *relative) noexcept {
+  std::string_view pieces[3];
+  std::size_t pieceCount = 0;
+  while (pieceCount < 3) {
+    std::size_t slash = token.find('/');
+    pieces[pieceCount++] = token.substr(0, slash);
+    if (slash == std::string_view::npos) {
+      break;
+    }
+    token.remove_prefix(slash + 1);
+    if (pieceCount == 3) {
+      return false;
+    }
+  }
+
+  IndexKind kinds[3] = {
+    ResolveIndex(pieces[0], data.vertexCoords.size(), &out->vertexCoord),
+    ResolveIndex(pieces[1], data.texCoords.size(), &out->texCoord),
+    ResolveIndex(pieces[2], data.vertexNormals.size(), &out->normal)
+  };
+  if (kinds[0] == IndexKind::Missing
+      || kinds[0] == IndexKind::Bad
+      || kinds[1] == IndexKind::Bad
+      || kinds[2] == IndexKind::Bad) {
+    return false;
+  }
+
+  *relative = 0;
+  for (unsigned i = 0; i < 3; i++) {
+    if (kinds[i] == IndexKind::Relative) {
+      *relative |= 1u << i;
+    }
+  }
+  return true;
+}
+
+void PushFaceVertex(ObjChunk *chunk, ObjFaceVertex const& faceVertex, unsigned relative) {
+  std::size_t index = chunk->data.faceVertices.size();
+  chunk->data.faceVertices.push_back(faceVertex);
+  if (relative & 1u) {
+    chunk->relativeCoords.push_back(index);
+  }
+  if (relative & 2u) {
+    chunk->relativeTexCoords.push_back(index);
+  }
+  if (relative & 4u) {
+    chunk->relativeNormals.push_back(index);
+  }
+}
+
+void RollbackFaceVertices(ObjChunk *chunk, std::size_t size) {
+  chunk->data.faceVertices.resize(size);
+  for (std::vector<std::size_t> *fixups : { &chunk->relativeCoords,
+                                            &chunk->relativeTexCoords,
+                                            &chunk->relativeNormals }) {
+    while (!fixups->empty() && fixups->back() >= size) {
+      fixups->pop_back();
+    }
+  }
+}
+
+void ParseObjLine(std::string_view line, std::size_t lineNo, ObjChunk *chunk) {
+  ObjData &data = chunk->data;
+  std::string_view command = NextToken(&line);
+  if (command.empty() || command.front() == '#') {
+    return;
+  }
+
+  if (EqualsIgnoreCase(command, "v") || EqualsIgnoreCase(command, "vn")) {
+    float values[3];
+    if (ParseFloats(line, values, 3) != 3) {
+      data.diagnostics.push_back({ lineNo, "bad command (v/vn expects 3 arguments)" });
+      return;
+    }
+
+    glm::vec3 value { values[0], values[1], values[2] };
+    if (command.size() == 1) {
+      data.vertexCoords.push_back(value);
+    } else {
+      data.vertexNormals.push_back(value);
+    }
+  } else if (EqualsIgnoreCase(command, "vt")) {
+    float values[3];
+    int count = ParseFloats(line, values, 3);
+    if (count != 2 && count != 3) {
+      data.diagnostics.push_back({ lineNo, "bad command (vt expects 2 arguments)" });
+      return;
+    }
+
+    data.texCoords.emplace_back(values[0], values[1]);
+  } else if (EqualsIgnoreCase(command, "f")) {
+    ObjFaceVertex first {};
+    ObjFaceVertex previous {};
+    unsigned firstRelative = 0;
+    unsigned previousRelative = 0;
+    std::size_t count = 0;
+    std::size_t rollback = data.faceVertices.size();
+    for (std::string_view token = NextToken(&line);
+         !token.empty();
+         token = NextToken(&line)) {
+      ObjFaceVertex current {};
+      unsigned currentRelative = 0;
+      if (!ParseFaceVertex(token, data, &current, &currentRelative)) {
+        RollbackFaceVertices(chunk, rollback);
+        data.diagnostics.push_back({ lineNo, "bad command (bad face vertex)" });
+        return;
+      }
+
+      if (count == 0) {
+        first = current;
+        firstRelative = currentRelative;
+      } else if (count >= 2) {
+        // fan triangulation, the first two were only remembered
+        PushFaceVertex(chunk, first, firstRelative);
+        PushFaceVertex(chunk, previous, previousRelative);
+        PushFaceVertex(chunk, current, currentRelative);
+      }
+      previous = current;
+      previousRelative = currentRelative;
+      count += 1;
+    }
+
+    if (count < 3) {
+      RollbackFaceVertices(chunk, rollback);
+      data.diagnostics.push_back({ lineNo, "bad command (f expects at least 3 arguments)" });
+    }
+  } else if (EqualsIgnoreCase(command, "mtllib") || EqualsIgnoreCase(command, "usemtl")) {
+    std::string_view name = NextToken(&line);
+    if (name.empty() || !NextToken(&line).empty()) {
+      data.diagnostics.push_back({ lineNo, "bad command (mtllib/usemtl expects 1 argument)" });
+      return;
+    }
+
+    if (EqualsIgnoreCase(command, "mtllib")) {
+      data.materialLibraries.emplace_back(name);
+    } else {
+      data.materialName = name;
+      chunk->hasMaterial = true;
+    }
+  } else if (EqualsIgnoreCase(command, "o")
+             || EqualsIgnoreCase(command, "g")
+             || EqualsIgnoreCase(command, "s")) {
+    // do nothing
+  } else {
+    data.diagnostics.push_back({ lineNo, "unsupported command" });
+  }
+}
+
+void ParseObjChunk(std::string_view source, ObjChunk *chunk) {
+  std::size_t lineNo = 0;
+  while (!source.empty()) {
+    std::string_view line = NextLine(&source);
+    lineNo += 1;
+    ParseObjLine(line, lineNo, chunk);
+  }
+  chunk->lineCount = lineNo;
+}
+
+template <typename T>
+void AppendMoved(std::vector<T> &to, std::vector<T> &from) {
+  to.insert(to.end(),
+            std::make_move_iterator(from.begin()),
+            std::make_move_iterator(from.end()));
+  from.clear();
+}
+
+// Also checks the merged indices, dropping triangles that refer to vertices
+// which do not exist
+void MergeChunks(std::vector<ObjChunk> &chunks, ObjData *out) {
+  std::size_t coordBase = 0;
+  std::size_t texCoordBase = 0;
+  std::size_t normalBase = 0;
+  std::size_t lineBase = 0;
+  std::size_t faceVertexBase = 0;
+
+  for (ObjChunk &chunk : chunks) {
+    ObjData &data = chunk.data;
+    for (std::size_t i : chunk.relativeCoords) {
+      data.faceVertices[i].vertexCoord += static_cast<std::int32_t>(coordBase);
+    }
+    for (std::size_t i : chunk.relativeTexCoords) {
+      data.faceVertices[i].texCoord += static_cast<std::int32_t>(texCoordBase);
+    }
+    for (std::size_t i : chunk.relativeNormals) {
+      data.faceVertices[i].normal += static_cast<std::int32_t>(normalBase);
+    }
+    for (ObjDiagnostic &diagnostic : data.diagnostics) {
+      diagnostic.lineNo += lineBase;
+    }
+
+    coordBase += data.vertexCoords.size();
+    texCoordBase += data.texCoords.size();
+    normalBase += data.vertexNormals.size();
+    lineBase += chunk.lineCount;
+    faceVertexBase += data.faceVertices.size();
+  }
+
+  out->vertexCoords.reserve(coordBase);
+  out->texCoords.reserve(texCoordBase);
+  out->vertexNormals.reserve(normalBase);
+  out->faceVertices.reserve(faceVertexBase);
+  for (ObjChunk &chunk : chunks) {
+    ObjData &data = chunk.data;
+    AppendMoved(out->vertexCoords, data.vertexCoords);
+    AppendMoved(out->texCoords, data.texCoords);
+    AppendMoved(out->vertexNormals, data.vertexNormals);
+    AppendMoved(out->faceVertices, data.faceVertices);
+    AppendMoved(out->materialLibraries, data.materialLibraries);
+    AppendMoved(out->diagnostics, data.diagnostics);
+    if (chunk.hasMaterial) {
+      out->materialName = std::move(data.materialName);
+    }
+  }
+
+  auto outOfRange = [] (std::int32_t index, std::size_t count, bool optional) {
+    if (index == -1 && optional) {
+      return false;
+    }
+    return index < 0 || static_cast<std::size_t>(index) >= count;
+  };
+
+  std::size_t kept = 0;
+  std::size_t dropped = 0;
+  for (std::size_t i = 0; i + 2 < out->faceVertices.size(); i += 3) {
+    bool valid = true;
+    for (std::size_t k = 0; k < 3; k++) {
+      ObjFaceVertex const& faceVertex = out->faceVertices[i + k];
+      if (outOfRange(faceVertex.vertexCoord, coordBase, false)
+          || outOfRange(faceVertex.texCoord, texCoordBase, true)
+          || outOfRange(faceVertex.normal, normalBase, true)) {
+        valid = false;
+      }
+    }
+
+    if (!valid) {
+      dropped += 1;
+      continue;
+    }
+    if (kept != i) {
+      std::copy_n(out->faceVertices.begin() + static_cast<std::ptrdiff_t>(i),
+                  3,
+                  out->faceVertices.begin() + static_cast<std::ptrdiff_t>(kept));
+    }
+    kept += 3;
+  }
+  out->faceVertices.resize(kept);
+
+  if (dropped != 0) {
+    out->diagnostics.push_back({ 0, "faces referring to missing vertices were dropped" });
+  }
+}
+
+} // namespace
+
+ObjData ParseObj(std::string_view source, std::size_t threadCount) {
+  source = SkipByteOrderMark(source);
+  if (threadCount == 0) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  std::size_t chunkCount = std::min(threadCount,
+                                    source.size() / ObjParallelThreshold + 1);
+
+  // cut at the first line break after each even split point, so some chunks
+  // may end up empty
+  std::vector<std::string_view> pieces;
+  pieces.reserve(chunkCount);
+  std::size_t begin = 0;
+  for (std::size_t i = 1; i <= chunkCount; i++) {
+    std::size_t end = source.size();
+    if (i != chunkCount) {
+      end = std::max(begin, source.size() / chunkCount * i);
+      end = source.find('\n', end);
+      end = end == std::string_view::npos ? source.size() : end + 1;
+    }
+    pieces.push_back(source.substr(begin, end - begin));
+    begin = end;
+  }
+
+  std::vector<ObjChunk> chunks(pieces.size());
+  std::vector<std::thread> workers;
+  workers.reserve(pieces.size() - 1);
+  for (std::size_t i = 1; i < pieces.size(); i++) {
+    workers.emplace_back(ParseObjChunk, pieces[i], &chunks[i]);
+  }
+  ParseObjChunk(pieces[0], &chunks[0]);
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  ObjData ret;
+  MergeChunks(chunks, &ret);
+  return ret;
+}
+
+MtlData ParseMtl(std::string_view source) {
+  source = SkipByteOrderMark(source);
+  MtlData ret;
+  MtlMaterial *current = nullptr;
+
+  std::size_t lineNo = 0;
+  while (!source.empty()) {
+    std::string_view line = NextLine(&source);
+    lineNo += 1;
+
+    std::string_view command = NextToken(&line);
+    if (command.empty() || command.front() == '#') {
+      continue;
+    }
+
+    if (EqualsIgnoreCase(command, "newmtl")) {
+      std::string_view name = NextToken(&line);
+      if (name.empty() || !NextToken(&line).empty()) {
+        ret.diagnostics.push_back({ lineNo, "bad command (newmtl expects 1 argument)" });
+        continue;
+      }
+
+      ret.materials.emplace_back();
+      current = &ret.materials.back();
+      current->name = name;
+      continue;
+    }
+
+    if (!current) {
+      ret.diagnostics.push_back({
+        lineNo,
+        "bad command (cannot set material properties without a live material)"
+      });
+      continue;
+    }
+
+    if (EqualsIgnoreCase(command, "ka") || EqualsIgnoreCase(command, "kd") || EqualsIgnoreCase(command, "ks")) {
+      glm::vec4 *portion;
+      if (EqualsIgnoreCase(command, "ka")) {
+        portion = &current->ambient;
+      } else if (EqualsIgnoreCase(command, "kd")) {
+        portion = &current->diffuse;
+      } else {
+        portion = &current->specular;
+      }
+
+      float values[4];
+      int count = ParseFloats(line, values, 4);
+      if (count == 3) {
+        *portion = glm::vec4 { values[0], values[1], values[2], portion->a };
+      } else if (count == 4) {
+        *portion = glm::vec4 { values[0], values[1], values[2], values[3] };
+      } else {
+        ret.diagnostics.push_back({ lineNo, "bad command (k commands expect 3 or 4 arguments)" });
+      }
+    } else if (EqualsIgnoreCase(command, "d") || EqualsIgnoreCase(command, "tr")) {
+      float value;
+      if (ParseFloats(line, &value, 1) != 1) {
+        ret.diagnostics.push_back({ lineNo, "bad command (d/tr expects 1 argument)" });
+        continue;
+      }
+
+      if (EqualsIgnoreCase(command, "tr")) {
+        value = 1.0f - value;
+      }
+      current->ambient.a = value;
+      current->diffuse.a = value;
+      current->specular.a = value;
+    } else if (EqualsIgnoreCase(command, "ns")) {
+      float value;
+      if (ParseFloats(line, &value, 1) != 1) {
+        ret.diagnostics.push_back({ lineNo, "bad command (ns expects 1 argument)" });
+        continue;
+      }
+
+      current->shine = value;
+    } else if (EqualsIgnoreCase(command, "map_ka")
+               || EqualsIgnoreCase(command, "map_kd")
+               || EqualsIgnoreCase(command, "map_ks")
+               || EqualsIgnoreCase(command, "map_bump")
+               || EqualsIgnoreCase(command, "bump")) {
+      std::string_view path = NextToken(&line);
+      if (path.empty() || !NextToken(&line).empty()) {
+        ret.diagnostics.push_back({ lineNo, "bad command (map expects 1 argument)" });
+        continue;
+      }
+
+      if (EqualsIgnoreCase(command, "map_ka")) {
+        ret.diagnostics.push_back({ lineNo, "ambient mapping not supported yet" });
+      } else if (EqualsIgnoreCase(command, "map_kd")) {
+        current->diffuseMap = path;
+      } else if (EqualsIgnoreCase(command, "map_ks")) {
+        current->specularMap = path;
+      } else {
+        current->normalMap = path;
+      }
+    } else {
+      ret.diagnostics.push_back({ lineNo, "unsupported command" });
+    }
+  }
+
+  return ret;
+}
+
+} // namespace cw
@@ -2,22 +2,26 @@
 
 #include <QDebug>
 #include "cwglx/GL/GLImpl.h"
-#include "cwglx/Base/ShaderProgram.h"
+#include "cwglx/Object/ShaderInterface.h"
 
 namespace cw {
 
 void GLObjectContext::RemoveAll(GLFunctions *f) {
-  for (auto &[name, texture] : m_TextureLibrary) {
-    texture->Delete(f);
-  }
+  Delete(f);
   m_MaterialLibrary.clear();
   m_TextureLibrary.clear();
+  m_MaterialBuffer.reset();
 }
 
 void GLObjectContext::Delete(GLFunctions *f) {
   for (auto &[name, texture] : m_TextureLibrary) {
     texture->Delete(f);
   }
+  if (m_MaterialBuffer) {
+    m_MaterialBuffer->Delete(f);
+  }
+  // whatever is still waiting is never going to be picked up
+  m_TextureWaiters.clear();
 }
 
 bool GLObjectContext::HasTexture(QString const& texturePath) const {
@@ -49,6 +53,28 @@ GLObjectContext::AddTexture(QString texturePath,
   return r.first->second.get();
 }
 
+bool GLObjectContext::WaitForTexture(QString const& texturePath,
+                                     std::function<void(GLFunctions*)> ready) {
+  auto [it, inserted] = m_TextureWaiters.try_emplace(texturePath);
+  it->second.push_back(std::move(ready));
+  return inserted;
+}
+
+void GLObjectContext::NotifyTextureArrived(GLFunctions *f, QString const& texturePath) {
+  auto it = m_TextureWaiters.find(texturePath);
+  if (it == m_TextureWaiters.end()) {
+    return;
+  }
+
+  // waiters may request more textures, which must not touch the entry being
+  // iterated over
+  std::vector<std::function<void(GLFunctions*)>> waiters = std::move(it->second);
+  m_TextureWaiters.erase(it);
+  for (auto const& ready : waiters) {
+    ready(f);
+  }
+}
+
 Material const*
 GLObjectContext::AddMaterial(QString materialName,
                              std::unique_ptr<Material> &&material)
@@ -94,27 +120,61 @@ Material const *GLObjectContext::GetMaterial(const QString &materialName) const
   return it->second.get();
 }
 
+void GLObjectContext::UploadMaterials(GLFunctions *f) {
+  if (!m_MaterialBuffer) {
+    m_MaterialBuffer = std::make_unique<MaterialUBO>(f);
+  }
+  m_MaterialBuffer->Allocate(f, m_MaterialLibrary.size(), GL_STATIC_DRAW);
+
+  std::size_t index = 0;
+  for (auto &[name, material] : m_MaterialLibrary) {
+    m_MaterialBuffer->BufferSubData(f, MaterialBlock {
+      .ambient = material->ambient,
+      .diffuse = material->diffuse,
+      .specular = material->specular,
+      .shininess = material->shine
+    }, index);
+
+    material->uniformBuffer = m_MaterialBuffer.get();
+    material->uniformIndex = index;
+    index += 1;
+  }
+}
+
 GLObject::GLObject(std::unique_ptr<VertexArrayObject> &&vao,
-                   std::unique_ptr<VertexVBO> &&vbo,
-                   GLsizei vertexCount,
+                   std::unique_ptr<CompactVertexVBO> &&vbo,
+                   std::unique_ptr<ElementBufferObject> &&ebo,
+                   GLsizei indexCount,
+                   GLenum indexType,
                    const Material *material)
   : vao(std::move(vao)),
     vbo(std::move(vbo)),
-    vertexCount(vertexCount),
+    ebo(std::move(ebo)),
+    indexCount(indexCount),
+    indexType(indexType),
     material(material)
 {}
 
-void GLObject::Draw(GLFunctions *f, ShaderProgram *shaderProgram) const {
-  shaderProgram->SetUniform(f, QStringLiteral("material.ambient"), material->ambient);
-  shaderProgram->SetUniform(f, QStringLiteral("material.diffuse"), material->diffuse);
-  shaderProgram->SetUniform(f, QStringLiteral("material.specular"), material->specular);
-  shaderProgram->SetUniform(f, QStringLiteral("material.shininess"), material->shine);
+void GLObject::Draw(GLFunctions *f, ObjectShaderInterface const& uniforms) const {
+  ApplyMaterial(f, uniforms);
+  DrawVertices(f);
+}
+
+void GLObject::ApplyMaterial(GLFunctions *f, ObjectShaderInterface const& uniforms) const {
+  if (material->uniformBuffer && uniforms.materialBlock) {
+    material->uniformBuffer->BindRange(f, MaterialBlockBinding, material->uniformIndex);
+  } else {
+    ShaderProgram::SetUniform(f, uniforms.materialAmbient, material->ambient);
+    ShaderProgram::SetUniform(f, uniforms.materialDiffuse, material->diffuse);
+    ShaderProgram::SetUniform(f, uniforms.materialSpecular, material->specular);
+    ShaderProgram::SetUniform(f, uniforms.materialShininess, material->shine);
+  }
 
   if (material->diffuseTexture) {
     material->diffuseTexture->ActivateTexture(
       f,
       GL_TEXTURE0,
-      shaderProgram->GetUniformLocation(f, QStringLiteral("diffuseTex"))
+      uniforms.diffuseTex.GetLocation()
     );
   }
 
@@ -122,17 +182,20 @@ void GLObject::Draw(GLFunctions *f, ShaderProgram *shaderProgram) const {
     material->normalTexture->ActivateTexture(
       f,
       GL_TEXTURE1,
-      shaderProgram->GetUniformLocation(f, QStringLiteral("normalTex"))
+      uniforms.normalTex.GetLocation()
     );
   }
+}
 
+void GLObject::DrawVertices(GLFunctions *f) const {
   vao->Bind(f);
-  f->glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+  f->glDrawElements(GL_TRIANGLES, indexCount, indexType, nullptr);
 }
 
 void GLObject::Delete(GLFunctions *f) const {
   vao->Delete(f);
   vbo->Delete(f);
+  ebo->Delete(f);
 }
 
 } // namespace cw
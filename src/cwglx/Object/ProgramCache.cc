@@ -0,0 +1,174 @@
+#include "cwglx/Object/ProgramCache.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLInfo.h"
+#include "cwglx/Base/ShaderProgram.h"
+#include "cwglx/Object/MeshCache.h"
+#include "util/FileUtil.h"
+
+namespace cw {
+
+namespace {
+
+// bump whenever the layout of the file changes
+constexpr std::uint32_t ProgramCacheVersion = 1;
+constexpr std::array<char, 4> ProgramCacheMagic { 'C', 'W', 'P', 'B' };
+
+struct ProgramCacheHeader {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t sourceHash;
+  std::uint32_t binaryFormat;
+  std::uint32_t binaryLength;
+};
+
+static_assert(std::is_trivially_copyable_v<ProgramCacheHeader>);
+static_assert(sizeof(ProgramCacheHeader) == 24);
+
+std::atomic<bool> BinarySupported { false };
+std::atomic<std::uint64_t> DriverHash { 0 };
+
+} // namespace
+
+void DetectProgramBinarySupport(GLFunctions *f) {
+  GLInfo info = GLInfo::AutoDetect(f);
+
+  GLint major = 0;
+  GLint minor = 0;
+  f->glGetIntegerv(GL_MAJOR_VERSION, &major);
+  f->glGetIntegerv(GL_MINOR_VERSION, &minor);
+  bool hasEntryPoints = major > 4
+                        || (major == 4 && minor >= 1)
+                        || info.HasExtension(QStringLiteral("GL_ARB_get_program_binary"));
+
+  // the extension may be exposed with no format to go with it
+  GLint formatCount = 0;
+  if (hasEntryPoints) {
+    f->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  }
+
+  bool supported = hasEntryPoints && formatCount > 0;
+  BinarySupported.store(supported, std::memory_order_relaxed);
+  if (!supported) {
+    qInfo() << "DetectProgramBinarySupport(GLFunctions*):"
+            << "program binaries not supported, shaders will always be compiled";
+  }
+
+  QByteArray driver = QStringLiteral("%1\n%2\n%3\n")
+    .arg(info.vendor, info.renderer, info.version)
+    .toUtf8();
+  DriverHash.store(HashBytes(driver.constData(), static_cast<std::size_t>(driver.size())),
+                   std::memory_order_relaxed);
+}
+
+bool IsProgramBinarySupported() noexcept {
+  return BinarySupported.load(std::memory_order_relaxed);
+}
+
+std::uint64_t HashProgramSource(QByteArray const& vertexShader,
+                                QByteArray const& fragmentShader) {
+  std::uint64_t driverHash = DriverHash.load(std::memory_order_relaxed);
+
+  QByteArray key;
+  key.reserve(static_cast<qsizetype>(sizeof(driverHash))
+              + vertexShader.size()
+              + fragmentShader.size()
+              + 1);
+  key.append(reinterpret_cast<char const*>(&driverHash), sizeof(driverHash));
+  key.append(vertexShader);
+  // otherwise moving text from the end of one stage to the start of the other
+  // would keep the hash
+  key.append('\0');
+  key.append(fragmentShader);
+  return HashBytes(key.constData(), static_cast<std::size_t>(key.size()));
+}
+
+bool LoadCachedProgram(GLFunctions *f, ShaderProgram *program, std::uint64_t sourceHash) {
+  if (!IsProgramBinarySupported()) {
+    return false;
+  }
+
+  std::unique_ptr<MappedFile> file = MappedFile::Open(GetProgramCachePath(sourceHash));
+  if (!file) {
+    return false;
+  }
+
+  std::string_view view = file->GetView();
+  if (view.size() < sizeof(ProgramCacheHeader)) {
+    return false;
+  }
+
+  ProgramCacheHeader header {};
+  std::memcpy(&header, view.data(), sizeof(header));
+  if (header.magic != ProgramCacheMagic
+      || header.version != ProgramCacheVersion
+      || header.sourceHash != sourceHash
+      || view.size() - sizeof(header) != header.binaryLength) {
+    return false;
+  }
+
+  return program->LinkBinary(f,
+                             static_cast<GLenum>(header.binaryFormat),
+                             view.data() + sizeof(header),
+                             static_cast<GLsizei>(header.binaryLength));
+}
+
+void StoreCachedProgram(GLFunctions *f,
+                        ShaderProgram const& program,
+                        std::uint64_t sourceHash) {
+  if (!IsProgramBinarySupported()) {
+    return;
+  }
+
+  GLenum binaryFormat = 0;
+  QByteArray binary = program.GetBinary(f, &binaryFormat);
+  if (binary.isEmpty()) {
+    return;
+  }
+
+  QString path = GetProgramCachePath(sourceHash);
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  // written to a temporary file and renamed, so that a crashed write never
+  // leaves a half written cache behind
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "StoreCachedProgram(GLFunctions*, ShaderProgram const&, std::uint64_t):"
+               << "cannot open"
+               << path
+               << "for writing";
+    return;
+  }
+
+  ProgramCacheHeader header {
+    .magic = ProgramCacheMagic,
+    .version = ProgramCacheVersion,
+    .sourceHash = sourceHash,
+    .binaryFormat = static_cast<std::uint32_t>(binaryFormat),
+    .binaryLength = static_cast<std::uint32_t>(binary.size())
+  };
+
+  file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  file.write(binary);
+
+  if (!file.commit()) {
+    qWarning() << "StoreCachedProgram(GLFunctions*, ShaderProgram const&, std::uint64_t):"
+               << "failed writing"
+               << path;
+  }
+}
+
+QString GetProgramCachePath(std::uint64_t sourceHash) {
+  return QStringLiteral("./cache/shader/%1.cwprog")
+    .arg(sourceHash, 16, 16, QLatin1Char('0'));
+}
+
+} // namespace cw
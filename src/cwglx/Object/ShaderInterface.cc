@@ -0,0 +1,26 @@
+#include "include/cwglx/Object/ShaderInterface.h"
+#include "include/cwglx/Object/UniformBlock.h"
+
+namespace cw {
+
+void ObjectShaderInterface::Resolve(GLFunctions *f, ShaderProgram const& program) {
+  frameBlock = program.HasUniformBlock(FrameBlockBinding);
+  materialBlock = program.HasUniformBlock(MaterialBlockBinding);
+
+  if (!frameBlock) {
+    projection = program.RequireUniform<glm::mat4>(f, "projection");
+    modelView = program.RequireUniform<glm::mat4>(f, "modelView");
+  }
+
+  if (!materialBlock) {
+    materialAmbient = program.ResolveUniform<glm::vec4>(f, "material.ambient");
+    materialDiffuse = program.ResolveUniform<glm::vec4>(f, "material.diffuse");
+    materialSpecular = program.ResolveUniform<glm::vec4>(f, "material.specular");
+    materialShininess = program.ResolveUniform<GLfloat>(f, "material.shininess");
+  }
+
+  diffuseTex = program.ResolveUniform<GLint>(f, "diffuseTex");
+  normalTex = program.ResolveUniform<GLint>(f, "normalTex");
+}
+
+} // namespace cw
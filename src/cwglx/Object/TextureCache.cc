@@ -0,0 +1,557 @@
+#include "cwglx/Object/TextureCache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLInfo.h"
+#include "cwglx/GL/GLStateCache.h"
+#include "cwglx/Base/Texture.h"
+#include "cwglx/Object/MeshCache.h"
+#include "util/FileUtil.h"
+
+namespace cw {
+
+namespace {
+
+// bump whenever the layout of the file or the encoder changes
+constexpr std::uint32_t TextureCacheVersion = 1;
+constexpr std::array<char, 4> TextureCacheMagic { 'C', 'W', 'T', 'C' };
+
+struct TextureCacheHeader {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t sourceHash;
+  std::uint32_t format;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t levelCount;
+};
+
+static_assert(std::is_trivially_copyable_v<TextureCacheHeader>);
+static_assert(sizeof(TextureCacheHeader) == 32);
+
+std::atomic<bool> CompressionSupported { false };
+
+std::size_t BlockSize(GLenum format) noexcept {
+  return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+}
+
+std::uint32_t FullMipCount(GLsizei width, GLsizei height) noexcept {
+  std::uint32_t count = 1;
+  while (width > 1 || height > 1) {
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+    count += 1;
+  }
+  return count;
+}
+
+std::vector<TextureLevel> ComputeLevels(GLenum format,
+                                        GLsizei width,
+                                        GLsizei height,
+                                        std::uint32_t levelCount) {
+  std::vector<TextureLevel> levels;
+  std::size_t offset = 0;
+  for (std::uint32_t i = 0; i < levelCount; i++) {
+    // partial blocks at the edges still take a whole block
+    std::size_t blocks = static_cast<std::size_t>((width + 3) / 4)
+                         * static_cast<std::size_t>((height + 3) / 4);
+    std::size_t size = blocks * BlockSize(format);
+    levels.push_back(TextureLevel {
+      .width = width,
+      .height = height,
+      .offset = offset,
+      .size = size
+    });
+    offset += size;
+
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+  }
+  return levels;
+}
+
+struct Rgba8Image {
+  GLsizei width;
+  GLsizei height;
+  std::vector<std::uint8_t> pixels;
+
+  [[nodiscard]] std::uint8_t const* At(GLsizei x, GLsizei y) const noexcept {
+    x = std::min(x, width - 1);
+    y = std::min(y, height - 1);
+    return pixels.data() + (static_cast<std::size_t>(y) * width + x) * 4;
+  }
+};
+
+// 2x2 box filter, the last row and column repeat for odd sizes
+Rgba8Image Downsample(Rgba8Image const& source) {
+  Rgba8Image ret {
+    .width = std::max(1, source.width / 2),
+    .height = std::max(1, source.height / 2),
+    .pixels = {}
+  };
+  ret.pixels.resize(static_cast<std::size_t>(ret.width) * ret.height * 4);
+
+  std::uint8_t *out = ret.pixels.data();
+  for (GLsizei y = 0; y < ret.height; y++) {
+    for (GLsizei x = 0; x < ret.width; x++) {
+      std::uint8_t const* p00 = source.At(x * 2, y * 2);
+      std::uint8_t const* p01 = source.At(x * 2 + 1, y * 2);
+      std::uint8_t const* p10 = source.At(x * 2, y * 2 + 1);
+      std::uint8_t const* p11 = source.At(x * 2 + 1, y * 2 + 1);
+      for (int c = 0; c < 4; c++) {
+        *out++ = static_cast<std::uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+      }
+    }
+  }
+  return ret;
+}
+
+using Block = std::array<std::array<std::uint8_t, 4>, 16>;
+
+std::uint16_t To565(std::uint8_t const* rgb) noexcept {
+  std::uint16_t r = static_cast<std::uint16_t>((rgb[0] * 31 + 127) / 255);
+  std::uint16_t g = static_cast<std::uint16_t>((rgb[1] * 63 + 127) / 255);
+  std::uint16_t b = static_cast<std::uint16_t>((rgb[2] * 31 + 127) / 255);
+  return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+std::array<int, 3> From565(std::uint16_t color) noexcept {
+  int r = (color >> 11) & 31;
+  int g = (color >> 5) & 63;
+  int b = color & 31;
+  return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+}
+
+void WriteLE(std::uint8_t *out, std::uint64_t value, int bytes) noexcept {
+  for (int i = 0; i < bytes; i++) {
+    out[i] = static_cast<std::uint8_t>(value >> (i * 8));
+  }
+}
+
+// Endpoints are the two pixels furthest apart along the principal axis of
+// the block, then every pixel takes the nearest of the four palette colors.
+// Not as good as an exhaustive search, but fast enough to run on first load
+void EncodeColorBlock(Block const& block, std::uint8_t *out) noexcept {
+  float mean[3] = { 0.0f, 0.0f, 0.0f };
+  for (auto const& pixel : block) {
+    for (int c = 0; c < 3; c++) {
+      mean[c] += pixel[c];
+    }
+  }
+  for (float &value : mean) {
+    value /= 16.0f;
+  }
+
+  float cov[3][3] = {};
+  for (auto const& pixel : block) {
+    float d[3] = { pixel[0] - mean[0], pixel[1] - mean[1], pixel[2] - mean[2] };
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        cov[i][j] += d[i] * d[j];
+      }
+    }
+  }
+
+  float axis[3] = { 1.0f, 1.0f, 1.0f };
+  for (int iteration = 0; iteration < 8; iteration++) {
+    float next[3];
+    for (int i = 0; i < 3; i++) {
+      next[i] = cov[i][0] * axis[0] + cov[i][1] * axis[1] + cov[i][2] * axis[2];
+    }
+    float length = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+    if (length < 1e-6f) {
+      break;
+    }
+    for (int i = 0; i < 3; i++) {
+      axis[i] = next[i] / length;
+    }
+  }
+
+  std::size_t minIndex = 0;
+  std::size_t maxIndex = 0;
+  float minT = 0.0f;
+  float maxT = 0.0f;
+  for (std::size_t i = 0; i < block.size(); i++) {
+    float t = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+    if (i == 0 || t < minT) {
+      minT = t;
+      minIndex = i;
+    }
+    if (i == 0 || t > maxT) {
+      maxT = t;
+      maxIndex = i;
+    }
+  }
+
+  std::uint16_t color0 = To565(block[maxIndex].data());
+  std::uint16_t color1 = To565(block[minIndex].data());
+  // color0 > color1 selects the four color mode
+  if (color0 < color1) {
+    std::swap(color0, color1);
+  }
+
+  std::uint32_t indices = 0;
+  if (color0 != color1) {
+    std::array<int, 3> c0 = From565(color0);
+    std::array<int, 3> c1 = From565(color1);
+    std::array<std::array<int, 3>, 4> palette {};
+    for (int c = 0; c < 3; c++) {
+      palette[0][c] = c0[c];
+      palette[1][c] = c1[c];
+      palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+      palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+    }
+
+    for (std::size_t i = 0; i < block.size(); i++) {
+      int best = 0;
+      int bestDistance = std::numeric_limits<int>::max();
+      for (int p = 0; p < 4; p++) {
+        int distance = 0;
+        for (int c = 0; c < 3; c++) {
+          int d = block[i][c] - palette[p][c];
+          distance += d * d;
+        }
+        if (distance < bestDistance) {
+          bestDistance = distance;
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint32_t>(best) << (i * 2);
+    }
+  }
+
+  WriteLE(out, color0, 2);
+  WriteLE(out + 2, color1, 2);
+  WriteLE(out + 4, indices, 4);
+}
+
+void EncodeAlphaBlock(Block const& block, std::uint8_t *out) noexcept {
+  int alpha0 = 0;
+  int alpha1 = 255;
+  for (auto const& pixel : block) {
+    alpha0 = std::max<int>(alpha0, pixel[3]);
+    alpha1 = std::min<int>(alpha1, pixel[3]);
+  }
+
+  std::uint64_t indices = 0;
+  if (alpha0 != alpha1) {
+    // alpha0 > alpha1 selects six interpolated values
+    std::array<int, 8> palette { alpha0, alpha1 };
+    for (int i = 2; i < 8; i++) {
+      palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+    }
+
+    for (std::size_t i = 0; i < block.size(); i++) {
+      int best = 0;
+      for (int p = 1; p < 8; p++) {
+        if (std::abs(block[i][3] - palette[p]) < std::abs(block[i][3] - palette[best])) {
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint64_t>(best) << (i * 3);
+    }
+  }
+
+  out[0] = static_cast<std::uint8_t>(alpha0);
+  out[1] = static_cast<std::uint8_t>(alpha1);
+  WriteLE(out + 2, indices, 6);
+}
+
+void EncodeLevel(Rgba8Image const& image, GLenum format, std::uint8_t *out) noexcept {
+  for (GLsizei blockY = 0; blockY < image.height; blockY += 4) {
+    for (GLsizei blockX = 0; blockX < image.width; blockX += 4) {
+      Block block;
+      for (GLsizei y = 0; y < 4; y++) {
+        for (GLsizei x = 0; x < 4; x++) {
+          std::memcpy(block[y * 4 + x].data(), image.At(blockX + x, blockY + y), 4);
+        }
+      }
+
+      if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+        EncodeAlphaBlock(block, out);
+        out += 8;
+      }
+      EncodeColorBlock(block, out);
+      out += 8;
+    }
+  }
+}
+
+void CompressImage(QImage const& image, TextureData *data) {
+  QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+
+  Rgba8Image level {
+    .width = rgba.width(),
+    .height = rgba.height(),
+    .pixels = {}
+  };
+  level.pixels.resize(static_cast<std::size_t>(level.width) * level.height * 4);
+  bool opaque = true;
+  for (GLsizei y = 0; y < level.height; y++) {
+    std::uint8_t const* line = rgba.constScanLine(y);
+    std::memcpy(level.pixels.data() + static_cast<std::size_t>(y) * level.width * 4,
+                line,
+                static_cast<std::size_t>(level.width) * 4);
+    for (GLsizei x = 0; x < level.width && opaque; x++) {
+      opaque = line[x * 4 + 3] == 255;
+    }
+  }
+
+  data->compressedFormat = opaque
+                           ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+                           : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  data->levels = ComputeLevels(data->compressedFormat,
+                               level.width,
+                               level.height,
+                               FullMipCount(level.width, level.height));
+  data->compressedBuffer.resize(data->levels.back().offset + data->levels.back().size);
+
+  for (std::size_t i = 0; i < data->levels.size(); i++) {
+    if (i != 0) {
+      level = Downsample(level);
+    }
+    EncodeLevel(level,
+                data->compressedFormat,
+                data->compressedBuffer.data() + data->levels[i].offset);
+  }
+
+  data->compressedData = data->compressedBuffer.data();
+  data->compressedSize = data->compressedBuffer.size();
+}
+
+bool WriteTextureCache(QString const& path,
+                       std::uint64_t sourceHash,
+                       TextureData const& data) {
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  // written to a temporary file and renamed, so that a crashed write never
+  // leaves a half written cache behind
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "WriteTextureCache(QString const&, std::uint64_t, TextureData const&):"
+               << "cannot open"
+               << path
+               << "for writing";
+    return false;
+  }
+
+  TextureCacheHeader header {
+    .magic = TextureCacheMagic,
+    .version = TextureCacheVersion,
+    .sourceHash = sourceHash,
+    .format = data.compressedFormat,
+    .width = static_cast<std::uint32_t>(data.levels.front().width),
+    .height = static_cast<std::uint32_t>(data.levels.front().height),
+    .levelCount = static_cast<std::uint32_t>(data.levels.size())
+  };
+
+  file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  file.write(reinterpret_cast<char const*>(data.compressedData),
+             static_cast<qint64>(data.compressedSize));
+
+  if (!file.commit()) {
+    qWarning() << "WriteTextureCache(QString const&, std::uint64_t, TextureData const&):"
+               << "failed writing"
+               << path
+               << ":"
+               << file.errorString();
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+TextureCacheFile::TextureCacheFile(QString const& path)
+  : m_File(path),
+    m_Mapped(nullptr),
+    m_Format(0),
+    m_Data(nullptr),
+    m_Size(0)
+{}
+
+TextureCacheFile::~TextureCacheFile() {
+  if (m_Mapped) {
+    m_File.unmap(m_Mapped);
+  }
+}
+
+std::unique_ptr<TextureCacheFile>
+TextureCacheFile::Open(QString const& path, std::uint64_t sourceHash) {
+  std::unique_ptr<TextureCacheFile> ret { new TextureCacheFile(path) };
+  if (!ret->m_File.open(QIODevice::ReadOnly)) {
+    return nullptr;
+  }
+
+  qint64 fileSize = ret->m_File.size();
+  if (fileSize < static_cast<qint64>(sizeof(TextureCacheHeader))) {
+    return nullptr;
+  }
+
+  ret->m_Mapped = ret->m_File.map(0, fileSize);
+  if (!ret->m_Mapped) {
+    return nullptr;
+  }
+
+  TextureCacheHeader header {};
+  std::memcpy(&header, ret->m_Mapped, sizeof(header));
+  if (header.magic != TextureCacheMagic
+      || header.version != TextureCacheVersion
+      || header.sourceHash != sourceHash
+      || (header.format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+          && header.format != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+      || header.width == 0
+      || header.height == 0
+      || header.levelCount != FullMipCount(static_cast<GLsizei>(header.width),
+                                           static_cast<GLsizei>(header.height))) {
+    return nullptr;
+  }
+
+  ret->m_Format = header.format;
+  ret->m_Levels = ComputeLevels(header.format,
+                                static_cast<GLsizei>(header.width),
+                                static_cast<GLsizei>(header.height),
+                                header.levelCount);
+  ret->m_Data = ret->m_Mapped + sizeof(TextureCacheHeader);
+  ret->m_Size = ret->m_Levels.back().offset + ret->m_Levels.back().size;
+  if (static_cast<std::size_t>(fileSize) != sizeof(TextureCacheHeader) + ret->m_Size) {
+    qWarning() << "TextureCacheFile::Open(QString const&, std::uint64_t):"
+               << "texture cache"
+               << path
+               << "is corrupted";
+    return nullptr;
+  }
+  return ret;
+}
+
+void const* TextureData::GetPixels() const noexcept {
+  return compressedFormat != 0 ? static_cast<void const*>(compressedData) : image.constBits();
+}
+
+std::size_t TextureData::GetPixelsSize() const noexcept {
+  return compressedFormat != 0 ? compressedSize : static_cast<std::size_t>(image.sizeInBytes());
+}
+
+void DetectTextureCompression(GLFunctions *f) {
+  GLInfo info = GLInfo::AutoDetect(f);
+  bool supported = info.HasExtension(QStringLiteral("GL_EXT_texture_compression_s3tc"));
+  CompressionSupported.store(supported, std::memory_order_relaxed);
+  if (!supported) {
+    qInfo() << "DetectTextureCompression(GLFunctions*):"
+            << "S3TC not supported, textures will not be compressed";
+  }
+}
+
+bool IsTextureCompressionSupported() noexcept {
+  return CompressionSupported.load(std::memory_order_relaxed);
+}
+
+TextureData PrepareTexture(QString const& fileName) {
+  TextureData data;
+
+  std::unique_ptr<MappedFile> file = MappedFile::Open(fileName);
+  if (!file) {
+    return data;
+  }
+
+  bool compress = IsTextureCompressionSupported();
+  std::uint64_t sourceHash = 0;
+  QString cachePath;
+  if (compress) {
+    std::string_view source = file->GetView();
+    sourceHash = HashBytes(source.data(), source.size());
+    cachePath = GetTextureCachePath(sourceHash);
+
+    data.cache = TextureCacheFile::Open(cachePath, sourceHash);
+    if (data.cache) {
+      data.compressedFormat = data.cache->GetFormat();
+      data.levels = data.cache->GetLevels();
+      data.compressedData = data.cache->GetData();
+      data.compressedSize = data.cache->GetSize();
+      return data;
+    }
+  }
+
+  QImage image;
+  if (!image.loadFromData(file->GetBytes()) || image.isNull()) {
+    return data;
+  }
+
+  if (!compress) {
+    data.image = PrepareTextureImage(image);
+    return data;
+  }
+
+  CompressImage(image, &data);
+  WriteTextureCache(cachePath, sourceHash, data);
+  return data;
+}
+
+void UploadTextureData(GLFunctions *f,
+                       TextureData const& data,
+                       void const* pixels,
+                       bool linearSampling,
+                       bool anisotropyFilter) {
+  if (data.compressedFormat == 0) {
+    TexImage2D(f, data.image, pixels, linearSampling, anisotropyFilter);
+    return;
+  }
+
+  SetTexture2DSampling(f, linearSampling, anisotropyFilter);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+  f->glTexParameteri(GL_TEXTURE_2D,
+                     GL_TEXTURE_MAX_LEVEL,
+                     static_cast<GLint>(data.levels.size() - 1));
+
+  // `pixels` may be an offset rather than a pointer
+  std::uintptr_t base = reinterpret_cast<std::uintptr_t>(pixels);
+  for (std::size_t i = 0; i < data.levels.size(); i++) {
+    TextureLevel const& level = data.levels[i];
+    f->glCompressedTexImage2D(GL_TEXTURE_2D,
+                              static_cast<GLint>(i),
+                              data.compressedFormat,
+                              level.width,
+                              level.height,
+                              0,
+                              static_cast<GLsizei>(level.size),
+                              reinterpret_cast<void const*>(base + level.offset));
+  }
+}
+
+std::unique_ptr<Texture2D> CreateTexture(GLFunctions *f,
+                                         TextureData const& data,
+                                         bool linearSampling,
+                                         bool anisotropyFilter) {
+  GLuint textureId = 0;
+  f->glGenTextures(1, &textureId);
+  BindTexture2D(f, textureId);
+  UploadTextureData(f, data, data.GetPixels(), linearSampling, anisotropyFilter);
+
+  std::unique_ptr<Texture2D> texture = std::make_unique<Texture2D>(textureId);
+  GLenum error = f->glGetError();
+  if (error != GL_NO_ERROR) {
+    qWarning() << "CreateTexture(...):"
+               << "failed uploading texture:"
+               << error;
+    texture->Delete(f);
+    return nullptr;
+  }
+  return texture;
+}
+
+QString GetTextureCachePath(std::uint64_t sourceHash) {
+  return QStringLiteral("./cache/texture/%1.cwtex")
+    .arg(sourceHash, 16, 16, QLatin1Char('0'));
+}
+
+} // namespace cw
@@ -0,0 +1,9 @@
+#include "include/cwglx/Object/UniformBlock.h"
+#include "include/cwglx/Base/UniformBufferObjectImpl.h"
+
+namespace cw {
+
+template class CW_DEFINE_UBO_TYPE(FrameBlock, projection, modelView, viewPos, light0Pos, light1Pos);
+template class CW_DEFINE_UBO_TYPE(MaterialBlock, ambient, diffuse, specular, shininess);
+
+} // namespace cw
@@ -1,10 +1,62 @@
 #include "include/cwglx/Object/Vertex.h"
 #include "include/cwglx/Base/VertexBufferObjectImpl.h"
 
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 namespace cw {
 
+CompactVertex CompressVertex(Vertex const& vertex) noexcept {
+  glm::vec3 normal = glm::normalize(vertex.vertexNormal);
+
+  // the loader already orthogonalised the tangent, but it may be missing
+  // if the mesh has no usable texture coordinates
+  glm::vec3 tangent = vertex.tangent - normal * glm::dot(normal, vertex.tangent);
+  if (glm::dot(tangent, tangent) <= 1e-12f) {
+    glm::vec3 axis = std::abs(normal.x) < 0.9f
+                     ? glm::vec3 { 1.0f, 0.0f, 0.0f }
+                     : glm::vec3 { 0.0f, 1.0f, 0.0f };
+    tangent = axis - normal * glm::dot(normal, axis);
+  }
+  tangent = glm::normalize(tangent);
+
+  glm::vec3 biTangent = glm::cross(normal, tangent);
+  bool mirrored = glm::dot(biTangent, vertex.biTangent) < 0.0f;
+
+  glm::quat q = glm::quat_cast(glm::mat3 { tangent, biTangent, normal });
+  q = glm::normalize(q);
+  if (q.w < 0.0f) {
+    q = -q;
+  }
+
+  // w must not quantise to zero, or the handedness would get lost
+  constexpr float bias = 1.0f / 32767.0f;
+  if (q.w < bias) {
+    float scale = std::sqrt(1.0f - bias * bias);
+    glm::vec3 xyz = glm::normalize(glm::vec3 { q.x, q.y, q.z }) * scale;
+    q = glm::quat { bias, xyz.x, xyz.y, xyz.z };
+  }
+
+  if (mirrored) {
+    q = -q;
+  }
+
+  CompactVertex ret {};
+  ret.vertexCoord = vertex.vertexCoord;
+  ret.texCoord.values[0] = glm::packHalf1x16(vertex.texCoord.x);
+  ret.texCoord.values[1] = glm::packHalf1x16(vertex.texCoord.y);
+  ret.tangentFrame.values[0] = static_cast<GLshort>(glm::packSnorm1x16(q.x));
+  ret.tangentFrame.values[1] = static_cast<GLshort>(glm::packSnorm1x16(q.y));
+  ret.tangentFrame.values[2] = static_cast<GLshort>(glm::packSnorm1x16(q.z));
+  ret.tangentFrame.values[3] = static_cast<GLshort>(glm::packSnorm1x16(q.w));
+  return ret;
+}
+
 template class CW_DEFINE_VBO_TYPE(PlainVertex, vertexCoord);
 template class CW_DEFINE_VBO_TYPE(SimpleVertex, vertexCoord, vertexNormal);
 template class CW_DEFINE_VBO_TYPE(Vertex, vertexCoord, vertexNormal, texCoord, tangent, biTangent);
+template class CW_DEFINE_VBO_TYPE(CompactVertex, vertexCoord, texCoord, tangentFrame);
 
 } // namespace cw
@@ -1,362 +1,263 @@
 #include "cwglx/Object/WavefrontLoader.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
 #include <QString>
 #include <QDebug>
-#include <QImage>
+#include <QLoggingCategory>
 #include <glm/geometric.hpp>
+#include "cwglx/Base/Texture.h"
+#include "cwglx/Object/AssetStreamer.h"
 #include "cwglx/Object/Object.h"
 #include "cwglx/Object/Material.h"
+#include "cwglx/Object/MeshOptimizer.h"
+#include "cwglx/Object/TextureCache.h"
 #include "util/FileUtil.h"
 
 namespace cw {
 
-static glm::vec2 ParseVertex2(QStringList const& commandBuf);
-static glm::vec3 ParseVertex3(QStringList const& commandBuf);
-static glm::vec4 ParseVertex4(QStringList const& commandBuf);
+// Mesh statistics are only of interest while working on the loader, they are
+// printed with QT_LOGGING_RULES="cw.mesh.info=true"
+Q_LOGGING_CATEGORY(MeshLog, "cw.mesh", QtWarningMsg)
 
-void LoadMaterialLibrary(GLObjectContext *ctx,
-                         GLFunctions *f,
-                         QString const &basePath,
-                         QString const &fileName,
-                         bool linearSampling,
-                         bool anisotropyFilter) {
-  QString currentMaterialName;
-  std::unique_ptr<Material> currentMaterial;
-
-  QString fileContent = cw::ReadToString(
-    QStringLiteral("%1/%2")
-      .arg(basePath)
-      .arg(fileName)
-  );
-  QStringList fileLines = fileContent.split('\n');
-
-  qsizetype lineNo = 0;
-  for (QString const &line: fileLines) {
-    lineNo += 1;
+namespace {
 
-    QString trimmed = line.trimmed();
-    if (trimmed.isEmpty() || trimmed.startsWith('#')) {
-      continue;
-    }
-
-    QStringList parts = trimmed.split(' ');
-    if (parts.length() < 1) {
-      qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                 << "when parsing file"
-                 << fileName
-                 << "line"
-                 << lineNo
-                 << ":"
-                 << "bad command (no valid command parts)";
-      continue;
-    }
+// Bump whenever parsing, deduplication, tangent generation or optimisation
+// change what ends up in the mesh cache. The cache file layout is versioned
+// separately in `MeshCache.cc`
+constexpr std::uint32_t MeshPipelineVersion = 1;
 
-    QString command = parts[0].toLower();
-
-    if (command == "newmtl") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (newmtl expects 1 argument)";
-        continue;
-      }
+// Tangents are accumulated per vertex after deduplication, so they are not
+// part of the key
+struct VertexKey {
+  std::array<GLfloat, 8> values;
 
-      if (currentMaterial) {
-        ctx->AddMaterial(currentMaterialName, std::move(currentMaterial));
+  explicit VertexKey(Vertex const& vertex) noexcept
+    : values {
+        vertex.vertexCoord.x, vertex.vertexCoord.y, vertex.vertexCoord.z,
+        vertex.vertexNormal.x, vertex.vertexNormal.y, vertex.vertexNormal.z,
+        vertex.texCoord.x, vertex.texCoord.y
       }
-
-      currentMaterialName = parts[1];
-      currentMaterial = std::make_unique<Material>();
-
-      continue;
+  {
+    // -0.0f and 0.0f compare equal but hash differently
+    for (GLfloat &value : values) {
+      value += 0.0f;
     }
+  }
 
-    if (!currentMaterial) {
-      qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                 << "when parsing file"
-                 << fileName
-                 << "line"
-                 << lineNo
-                 << ":"
-                 << "bad command (cannot set material properties without a live material)";
-    }
+  bool operator==(VertexKey const& other) const noexcept {
+    return std::memcmp(values.data(), other.values.data(), sizeof(values)) == 0;
+  }
+};
 
-    if (command == "ka" || command == "kd" || command == "ks") {
-      glm::vec4 *portion;
-      if (command == "ka") {
-        portion = &currentMaterial->ambient;
-      } else if (command == "kd") {
-        portion = &currentMaterial->diffuse;
-      } else {
-        portion = &currentMaterial->specular;
-      }
+struct VertexKeyHash {
+  std::size_t operator()(VertexKey const& key) const noexcept {
+    return HashBytes(reinterpret_cast<char const*>(key.values.data()), sizeof(key.values));
+  }
+};
+
+} // namespace
+
+static GLObject UploadObject(GLFunctions *f,
+                             MeshCacheContent const& content,
+                             Material const* material,
+                             std::unique_ptr<VertexArrayObject> &&vao,
+                             std::unique_ptr<CompactVertexVBO> &&vbo,
+                             std::unique_ptr<ElementBufferObject> &&ebo);
+
+// Only the first few, a broken export may otherwise print millions of lines
+static void ReportDiagnostics(char const* function,
+                              QString const& fileName,
+                              std::vector<ObjDiagnostic> const& diagnostics) {
+  constexpr std::size_t MaxReported = 16;
+  for (std::size_t i = 0; i < std::min(diagnostics.size(), MaxReported); i++) {
+    qWarning() << function
+               << "when parsing file"
+               << fileName
+               << "line"
+               << diagnostics[i].lineNo
+               << ":"
+               << diagnostics[i].message;
+  }
+  if (diagnostics.size() > MaxReported) {
+    qWarning() << function
+               << "when parsing file"
+               << fileName
+               << ":"
+               << diagnostics.size() - MaxReported
+               << "more problems not shown";
+  }
+}
 
-      if (parts.length() == 4) {
-        *portion = glm::vec4 { ParseVertex3(parts), portion->a };
-      } else if (parts.length() == 5) {
-        *portion = ParseVertex4(parts);
-      } else {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (k commands expect 3 or 4 arguments)";
-      }
-    } else if (command == "d" || command == "tr") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (d/tr expects 1 argument)";
-        continue;
-      }
+static Texture2D const* LoadTexture(GLObjectContext *ctx,
+                                    GLFunctions *f,
+                                    QString const& basePath,
+                                    std::string const& path,
+                                    bool linearSampling,
+                                    bool anisotropyFilter) {
+  if (path.empty()) {
+    return nullptr;
+  }
 
-      float value = parts[1].toFloat();
-      if (command == "tr") {
-        value = 1.0f - value;
-      }
+  QString texturePath = QString::fromStdString(path);
+  if (ctx->HasTexture(texturePath)) {
+    return ctx->GetTexture(texturePath);
+  }
 
-      currentMaterial->ambient.a = value;
-      currentMaterial->diffuse.a = value;
-      currentMaterial->specular.a = value;
-    } else if (command == "ns") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (ns expects 1 argument)";
-        continue;
-      }
+  TextureData data = PrepareTexture(QStringLiteral("%1/%2").arg(basePath).arg(texturePath));
+  if (data.IsNull()) {
+    qWarning() << "LoadTexture(...):"
+               << "cannot load texture:"
+               << texturePath;
+    return nullptr;
+  }
 
-      float ns = parts[1].toFloat();
-      currentMaterial->shine = ns;
-    } else if (command == "map_ka" || command == "map_kd" || command == "map_ks"
-               || command == "map_bump" || command == "bump") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (map expects 1 argument)";
-        continue;
-      }
+  std::unique_ptr<Texture2D> texture = CreateTexture(f, data, linearSampling, anisotropyFilter);
+  if (!texture) {
+    return nullptr;
+  }
+  return ctx->AddTexture(texturePath, std::move(texture));
+}
 
-      cw::Texture2D const **portion;
-      if (command == "map_ka") {
-        qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "ambient mapping not supported yet";
-        continue;
-      } else if (command == "map_kd") {
-        portion = &currentMaterial->diffuseTexture;
-      } else if (command == "map_ks") {
-        portion = &currentMaterial->specularTexture;
-      } else {
-        portion = &currentMaterial->normalTexture;
-      }
+static bool ReadMaterialLibrary(QString const& basePath,
+                                QString const& fileName,
+                                MtlData *mtl) {
+  std::unique_ptr<MappedFile> file = MappedFile::Open(
+    QStringLiteral("%1/%2")
+      .arg(basePath)
+      .arg(fileName)
+  );
+  if (!file) {
+    return false;
+  }
 
-      QString texturePath = parts[1];
-      if (ctx->HasTexture(texturePath)) {
-        *portion = ctx->GetTexture(texturePath);
-      } else {
-        QImage image;
-        if (!image.load(QStringLiteral("%1/%2").arg(basePath).arg(texturePath))) {
-          qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                     << "when parsing file"
-                     << fileName
-                     << "line"
-                     << lineNo
-                     << ":"
-                     << "cannot load texture:"
-                     << texturePath;
-          continue;
-        }
+  *mtl = ParseMtl(file->GetView());
+  ReportDiagnostics("LoadMaterialLibrary(...):", fileName, mtl->diagnostics);
+  return true;
+}
 
-        std::unique_ptr<Texture2D> texture = std::make_unique<Texture2D>(
-          image,
-          f,
-          linearSampling,
-          anisotropyFilter
-        );
-        *portion = ctx->AddTexture(texturePath, std::move(texture));
-      }
-    } else {
-      qWarning() << "LoadMaterialLibrary(GLObjectContext*, GLFunctions*, QString const&, QString const&):"
-                 << "when parsing file"
-                 << fileName
-                 << "line"
-                 << lineNo
-                 << ":"
-                 << "unsupported command:"
-                 << command;
-    }
+static void AddMaterials(GLObjectContext *ctx,
+                         MtlData const& mtl,
+                         std::function<Texture2D const*(std::string const&)> const& getTexture) {
+  for (MtlMaterial const& parsed : mtl.materials) {
+    std::unique_ptr<Material> material = std::make_unique<Material>();
+    material->ambient = parsed.ambient;
+    material->diffuse = parsed.diffuse;
+    material->specular = parsed.specular;
+    material->shine = parsed.shine;
+    material->diffuseTexture = getTexture(parsed.diffuseMap);
+    material->specularTexture = getTexture(parsed.specularMap);
+    material->normalTexture = getTexture(parsed.normalMap);
+
+    ctx->AddMaterial(QString::fromStdString(parsed.name), std::move(material));
+  }
+}
+
+static Material const* FindMaterial(GLObjectContext *ctx,
+                                    QString const& fileName,
+                                    QString const& materialName) {
+  if (materialName.isEmpty()) {
+    return nullptr;
   }
 
-  if (currentMaterial) {
-    ctx->AddMaterial(currentMaterialName, std::move(currentMaterial));
+  Material const* material = ctx->GetMaterial(materialName);
+  if (!material) {
+    qWarning() << "LoadObject(...):"
+               << "when parsing file"
+               << fileName
+               << ":"
+               << "material not found:"
+               << materialName;
   }
+  return material;
 }
 
-GLObject LoadObject(GLObjectContext *ctx,
-                    GLFunctions *f,
-                    QString const &basePath,
-                    QString const &fileName,
-                    bool linearSampling,
-                    bool anisotropyFilter,
-                    std::unique_ptr<VertexArrayObject> &&vao,
-                    std::unique_ptr<VertexVBO> &&vbo)
-{
-  std::vector<glm::vec3> vertexCoords;
-  std::vector<glm::vec3> vertexNormals;
-  std::vector<glm::vec2> texCoords;
-  std::vector<glm::vec3> tangents;
-  std::vector<glm::vec3> biTangents;
+void LoadMaterialLibrary(GLObjectContext *ctx,
+                         GLFunctions *f,
+                         QString const &basePath,
+                         QString const &fileName,
+                         bool linearSampling,
+                         bool anisotropyFilter) {
+  MtlData mtl;
+  if (!ReadMaterialLibrary(basePath, fileName, &mtl)) {
+    return;
+  }
 
-  std::vector<Vertex> vertices;
-  Material const* material = nullptr;
+  AddMaterials(ctx, mtl, [&](std::string const& path) {
+    return LoadTexture(ctx, f, basePath, path, linearSampling, anisotropyFilter);
+  });
+}
 
-  QString fileContent = cw::ReadToString(
+ObjectData PrepareObject(QString const& basePath, QString const& fileName) {
+  ObjectData data;
+
+  std::unique_ptr<MappedFile> file = MappedFile::Open(
     QStringLiteral("%1/%2")
       .arg(basePath)
       .arg(fileName)
   );
-  QStringList fileLines = fileContent.split('\n');
-
-  size_t lineNo = 0;
-  for (QString const& line : fileLines) {
-    lineNo += 1;
+  if (!file) {
+    qWarning() << "PrepareObject(QString const&, QString const&):"
+               << "cannot open object file"
+               << fileName
+               << "in"
+               << basePath;
+    data.sourceMissing = true;
+    return data;
+  }
 
-    QString trimmed = line.trimmed();
-    if (trimmed.isEmpty() || trimmed.startsWith('#')) {
-      continue;
+  // caches made by an older pipeline hash differently and get rebuilt
+  std::string_view source = file->GetView();
+  std::uint64_t sourceHash = HashBytes(reinterpret_cast<char const*>(&MeshPipelineVersion),
+                                       sizeof(MeshPipelineVersion));
+  sourceHash = HashBytes(source.data(), source.size(), sourceHash);
+
+  // only geometry is cached, materials are always loaded from their source
+  QString cachePath = GetMeshCachePath(basePath, fileName);
+  data.cache = MeshCacheFile::Open(cachePath, sourceHash);
+  if (data.cache) {
+    data.content = data.cache->GetContent();
+  } else {
+    std::vector<glm::vec3> tangents;
+    std::vector<glm::vec3> biTangents;
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> &indices = data.indices;
+    std::unordered_map<VertexKey, GLuint, VertexKeyHash> vertexIndices;
+
+    ObjData obj = ParseObj(source);
+    ReportDiagnostics("LoadObject(...):", fileName, obj.diagnostics);
+
+    for (std::string const& library : obj.materialLibraries) {
+      data.content.materialLibraries.push_back(QString::fromStdString(library));
     }
+    data.content.materialName = QString::fromStdString(obj.materialName);
 
-    QStringList parts = trimmed.split(' ');
-    QString command = parts[0].toLower();
-    if (command == "o" || command == "s") {
-      // do nothing
-    } else if (command == "mtllib") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (mtllib expects 1 argument)";
-        continue;
-      }
-
-      QString materialLibPath = parts[1];
-      LoadMaterialLibrary(ctx, f, basePath, materialLibPath, linearSampling, anisotropyFilter);
-    } else if (command == "usemtl") {
-      if (parts.length() != 2) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (mtllib expects 1 argument)";
-        continue;
-      }
-
-      material = ctx->GetMaterial(parts[1]);
-      if (!material) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "material not found:"
-                   << parts[1];
-      }
-    } else if (command == "v" || command == "vn") {
-      if (parts.length() != 4) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "bad command (v/vn expects 3 arguments)";
-        continue;
-      }
-
-      if (command == "v") {
-        vertexCoords.push_back(ParseVertex3(parts));
-      } else {
-        vertexNormals.push_back(ParseVertex3(parts));
-      }
-    } else if (command == "vt") {
-      if (parts.length() != 3) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (vt expects 2 arguments)";
-        continue;
-      }
-
-      texCoords.push_back(ParseVertex2(parts));
-    } else if (command == "f") {
-      if (parts.length() != 4) {
-        qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                   << "when parsing file"
-                   << fileName
-                   << "line"
-                   << lineNo
-                   << ":"
-                   << "bad command (f expects 3 arguments (i.e. 3 faces))";
-        continue;
-      }
-
+    vertices.reserve(obj.vertexCoords.size());
+    vertexIndices.reserve(obj.vertexCoords.size());
+    indices.reserve(obj.faceVertices.size());
+    for (std::size_t face = 0; face + 2 < obj.faceVertices.size(); face += 3) {
       std::array<Vertex, 3> triangle {};
       bool computeNormal = false;
-      for (int i = 1; i < 4; ++i) {
-        QStringList vertexParts = parts[i].split('/');
-        if (vertexParts.length() != 3) {
-          qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                     << "when parsing file"
-                     << fileName
-                     << "line"
-                     << lineNo
-                     << ":"
-                     << "bad command (f expects each argument to have 3 pieces)";
-          continue;
-        }
-
-        int vertexCoordIndex = vertexParts[0].toInt() - 1;
-        int texCoordIndex = vertexParts[1].toInt() - 1;
-        int normalIndex = vertexParts[2].toInt() - 1;
+      for (std::size_t i = 0; i < 3; ++i) {
+        ObjFaceVertex const& faceVertex = obj.faceVertices[face + i];
 
-        glm::vec3 vertexCoord = vertexCoords[vertexCoordIndex];
-        glm::vec2 texCoord = texCoords[texCoordIndex];
+        glm::vec3 vertexCoord = obj.vertexCoords[faceVertex.vertexCoord];
+        glm::vec2 texCoord { 0.0f };
+        if (faceVertex.texCoord >= 0) {
+          texCoord = obj.texCoords[faceVertex.texCoord];
+        }
         glm::vec3 normal;
-        if (normalIndex >= 0) {
-          normal = vertexNormals[normalIndex];
+        if (faceVertex.normal >= 0) {
+          normal = obj.vertexNormals[faceVertex.normal];
         } else {
           computeNormal = true;
           normal = glm::vec3(0.0);
         }
 
-        triangle[i - 1] = {
+        triangle[i] = {
           vertexCoord,
           normal,
           texCoord,
@@ -379,13 +280,14 @@ GLObject LoadObject(GLObjectContext *ctx,
       glm::vec2 deltaUV1 = uv1 - uv0;
       glm::vec2 deltaUV2 = uv2 - uv0;
 
-      float f1 = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-      glm::vec3 tangent = f1 * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
-      glm::vec3 biTangent = f1 * (-deltaUV2.x * edge1 + deltaUV1.x * edge2);
-
-      for (int i = 0; i < 3; ++i) {
-        triangle[i].tangent = tangent;
-        triangle[i].biTangent = biTangent;
+      // faces with degenerate texture coordinates do not contribute tangents
+      glm::vec3 tangent { 0.0f };
+      glm::vec3 biTangent { 0.0f };
+      float det = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+      if (det != 0.0f) {
+        float f1 = 1.0f / det;
+        tangent = f1 * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
+        biTangent = f1 * (-deltaUV2.x * edge1 + deltaUV1.x * edge2);
       }
 
       if (computeNormal) {
@@ -399,63 +301,253 @@ GLObject LoadObject(GLObjectContext *ctx,
       }
 
       for (int i = 0; i < 3; ++i) {
-        vertices.push_back(triangle[i]);
+        auto [it, inserted] = vertexIndices.try_emplace(
+          VertexKey { triangle[i] },
+          static_cast<GLuint>(vertices.size())
+        );
+        if (inserted) {
+          vertices.push_back(triangle[i]);
+          tangents.emplace_back(0.0f);
+          biTangents.emplace_back(0.0f);
+        }
+
+        GLuint index = it->second;
+        tangents[index] += tangent;
+        biTangents[index] += biTangent;
+        indices.push_back(index);
+      }
+    }
+
+    // Gram-Schmidt the accumulated tangents against the vertex normal, keeping
+    // the handedness given by the accumulated bitangent
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+      glm::vec3 const& normal = vertices[i].vertexNormal;
+      glm::vec3 tangent = tangents[i] - normal * glm::dot(normal, tangents[i]);
+      if (glm::dot(tangent, tangent) <= std::numeric_limits<float>::epsilon()) {
+        vertices[i].tangent = tangents[i];
+        vertices[i].biTangent = biTangents[i];
+        continue;
+      }
+
+      tangent = glm::normalize(tangent);
+      glm::vec3 biTangent = glm::cross(normal, tangent);
+      if (glm::dot(biTangent, biTangents[i]) < 0.0f) {
+        biTangent = -biTangent;
       }
-    } else {
-      qWarning() << "LoadObject(GLObjectContext*, GLFunctions*, QString const&, QString const&, std::unique_ptr<VertexArrayObject>&&, std::unique_ptr<VertexVBO>&&):"
-                 << "when parsing file"
-                 << fileName
-                 << "line"
-                 << lineNo
-                 << ":"
-                 << "unsupported command: "
-                 << command;
+      vertices[i].tangent = tangent;
+      vertices[i].biTangent = biTangent;
     }
+
+    MeshOptimizeStats stats = OptimizeMesh(indices, vertices);
+    qCInfo(MeshLog) << "PrepareObject(QString const&, QString const&):"
+                    << fileName
+                    << "ACMR"
+                    << stats.acmrBefore
+                    << "->"
+                    << stats.acmrAfter;
+
+    std::vector<CompactVertex> &compactVertices = data.vertices;
+    compactVertices.reserve(vertices.size());
+    for (Vertex const& vertex : vertices) {
+      compactVertices.push_back(CompressVertex(vertex));
+    }
+
+    MeshCacheContent &content = data.content;
+    content.sourceHash = sourceHash;
+    content.vertices = compactVertices.data();
+    content.vertexCount = compactVertices.size();
+    content.indices = indices.data();
+    content.indexCount = indices.size();
+    content.indexType = GL_UNSIGNED_INT;
+
+    if (vertices.size() <= std::numeric_limits<GLushort>::max() + 1ull) {
+      data.shortIndices.assign(indices.begin(), indices.end());
+      content.indices = data.shortIndices.data();
+      content.indexType = GL_UNSIGNED_SHORT;
+    }
+
+    WriteMeshCache(cachePath, content);
   }
 
+  for (QString const& materialLibrary : data.content.materialLibraries) {
+    MtlData mtl;
+    if (ReadMaterialLibrary(basePath, materialLibrary, &mtl)) {
+      data.materialLibraries.push_back(std::move(mtl));
+    }
+  }
+  return data;
+}
+
+GLObject LoadObject(GLObjectContext *ctx,
+                    GLFunctions *f,
+                    QString const &basePath,
+                    QString const &fileName,
+                    bool linearSampling,
+                    bool anisotropyFilter,
+                    std::unique_ptr<VertexArrayObject> &&vao,
+                    std::unique_ptr<CompactVertexVBO> &&vbo,
+                    std::unique_ptr<ElementBufferObject> &&ebo)
+{
+  ObjectData data = PrepareObject(basePath, fileName);
+  for (MtlData const& mtl : data.materialLibraries) {
+    AddMaterials(ctx, mtl, [&](std::string const& path) {
+      return LoadTexture(ctx, f, basePath, path, linearSampling, anisotropyFilter);
+    });
+  }
+
+  Material const* material = FindMaterial(ctx, fileName, data.content.materialName);
+  return UploadObject(f, data.content, material, std::move(vao), std::move(vbo), std::move(ebo));
+}
+
+static GLObject UploadObject(GLFunctions *f,
+                             MeshCacheContent const& content,
+                             Material const* material,
+                             std::unique_ptr<VertexArrayObject> &&vao,
+                             std::unique_ptr<CompactVertexVBO> &&vbo,
+                             std::unique_ptr<ElementBufferObject> &&ebo) {
   if (vao == nullptr) {
     vao = std::make_unique<VertexArrayObject>(f);
   }
   vao->Bind(f);
 
   if (vbo == nullptr) {
-    vbo = std::make_unique<VertexVBO>(f);
+    vbo = std::make_unique<CompactVertexVBO>(f);
   }
   vbo->Bind(f);
-  vbo->BufferData(f, vertices.data(), vertices.size(), GL_STATIC_DRAW);
+  vbo->BufferData(f, content.vertices, content.vertexCount, GL_STATIC_DRAW);
+
+  // the element buffer binding is part of the vertex array state
+  if (ebo == nullptr) {
+    ebo = std::make_unique<ElementBufferObject>(f);
+  }
+  ebo->Bind(f);
+  if (content.indexType == GL_UNSIGNED_SHORT) {
+    ebo->BufferData(f,
+                    static_cast<GLushort const*>(content.indices),
+                    content.indexCount,
+                    GL_STATIC_DRAW);
+  } else {
+    ebo->BufferData(f,
+                    static_cast<GLuint const*>(content.indices),
+                    content.indexCount,
+                    GL_STATIC_DRAW);
+  }
 
   vao->Unbind(f);
 
   return GLObject {
     std::move(vao),
     std::move(vbo),
-    static_cast<GLsizei>(vertices.size()),
+    std::move(ebo),
+    static_cast<GLsizei>(content.indexCount),
+    content.indexType,
     material
   };
 }
 
-static glm::vec2 ParseVertex2(QStringList const& commandBuf) {
-  return {
-    commandBuf[1].toFloat(),
-    commandBuf[2].toFloat(),
-  };
-}
+namespace {
+
+// Shared by the callbacks of one `StreamObject` call, all of which run on the
+// render thread
+struct PendingObject {
+  std::shared_ptr<GLObjectContext> ctx;
+  QString fileName;
+  StreamedObject streamed;
+  std::size_t texturesLeft;
+  std::function<void(GLFunctions*, GLObject&&)> done;
+};
+
+} // namespace
+
+static void FinishStreamedObject(GLFunctions *f, PendingObject *pending) {
+  GLObjectContext *ctx = pending->ctx.get();
+  for (MtlData const& mtl : pending->streamed.materialLibraries) {
+    AddMaterials(ctx, mtl, [ctx](std::string const& path) -> Texture2D const* {
+      QString texturePath = QString::fromStdString(path);
+      if (path.empty() || !ctx->HasTexture(texturePath)) {
+        return nullptr;
+      }
+      return ctx->GetTexture(texturePath);
+    });
+  }
 
-static glm::vec3 ParseVertex3(QStringList const& commandBuf) {
-  return {
-    commandBuf[1].toFloat(),
-    commandBuf[2].toFloat(),
-    commandBuf[3].toFloat()
-  };
+  GLObject &object = pending->streamed.object;
+  object.material = FindMaterial(ctx, pending->fileName, pending->streamed.materialName);
+  pending->done(f, std::move(object));
 }
 
-static glm::vec4 ParseVertex4(QStringList const& commandBuf) {
-  return {
-    commandBuf[1].toFloat(),
-    commandBuf[2].toFloat(),
-    commandBuf[3].toFloat(),
-    commandBuf[4].toFloat()
+void StreamObject(AssetStreamer *streamer,
+                  std::shared_ptr<GLObjectContext> const& ctx,
+                  QString const& basePath,
+                  QString const& fileName,
+                  bool linearSampling,
+                  bool anisotropyFilter,
+                  std::function<void(GLFunctions*, GLObject&&)> done) {
+  auto onObject = [=](GLFunctions *f, StreamedObject &&streamed) {
+    std::shared_ptr<PendingObject> pending { new PendingObject {
+      .ctx = ctx,
+      .fileName = fileName,
+      .streamed = std::move(streamed),
+      .texturesLeft = 0,
+      .done = done
+    } };
+
+    std::vector<QString> texturePaths;
+    for (MtlData const& mtl : pending->streamed.materialLibraries) {
+      for (MtlMaterial const& material : mtl.materials) {
+        for (std::string const* path : { &material.diffuseMap,
+                                         &material.specularMap,
+                                         &material.normalMap }) {
+          QString texturePath = QString::fromStdString(*path);
+          if (path->empty()
+              || ctx->HasTexture(texturePath)
+              || std::find(texturePaths.begin(), texturePaths.end(), texturePath)
+                   != texturePaths.end()) {
+            continue;
+          }
+          texturePaths.push_back(std::move(texturePath));
+        }
+      }
+    }
+
+    if (texturePaths.empty()) {
+      FinishStreamedObject(f, pending.get());
+      return;
+    }
+
+    pending->texturesLeft = texturePaths.size();
+    for (QString const& texturePath : texturePaths) {
+      auto onReady = [pending](GLFunctions *f) {
+        pending->texturesLeft -= 1;
+        if (pending->texturesLeft == 0) {
+          FinishStreamedObject(f, pending.get());
+        }
+      };
+      // another object of the same context may be loading it already
+      if (!ctx->WaitForTexture(texturePath, onReady)) {
+        continue;
+      }
+
+      auto onTexture = [ctx, texturePath](GLFunctions *f,
+                                          std::unique_ptr<Texture2D> &&texture) {
+        if (texture) {
+          ctx->AddTexture(texturePath, std::move(texture));
+        } else {
+          qWarning() << "StreamObject(...):"
+                     << "cannot load texture:"
+                     << texturePath;
+        }
+        ctx->NotifyTextureArrived(f, texturePath);
+      };
+
+      streamer->RequestTexture(QStringLiteral("%1/%2").arg(basePath).arg(texturePath),
+                               linearSampling,
+                               anisotropyFilter,
+                               onTexture);
+    }
   };
+
+  streamer->RequestObject(basePath, fileName, onObject);
 }
 
 } // namespace cw
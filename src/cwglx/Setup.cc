@@ -1,18 +1,19 @@
 #include "cwglx/Setup.h"
 #include "include/cwglx/GL/GLImpl.h"
+#include "include/cwglx/GL/GLStateCache.h"
 
 void cw::SetupPreferred(GLFunctions *f) {
   f->initializeOpenGLFunctions();
 
   f->glFrontFace(GL_CCW);
   f->glDepthFunc(GL_LESS);
-  f->glEnable(GL_CULL_FACE);
-  f->glEnable(GL_DEPTH_TEST);
+  // through the current state cache if there is one, so that it knows what
+  // these start out as
+  cw::SetCapability(f, GL_CULL_FACE, true);
+  cw::SetCapability(f, GL_DEPTH_TEST, true);
 
-  f->glEnable(GL_BLEND);
-  f->glBlendFuncSeparate(GL_ONE,
-                         GL_ONE_MINUS_SRC_ALPHA,
-                         GL_ONE,
-                         GL_ONE_MINUS_SRC_ALPHA);
+  cw::SetCapability(f, GL_BLEND, true);
+  // premultiplied alpha, same factors for color and alpha
+  cw::BlendFunc(f, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
   f->glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
 }
@@ -7,14 +7,15 @@
 #include <QDir>
 #include <QMessageBox>
 #include "wgc0310/AttachmentStatus.h"
-#include "ui_next/GLWindow.h"
+#include "ui_next/ExtraControl.h"
+#include "ui_next/GLRenderer.h"
 #include "util/DynLoad.h"
 
 AttachmentControl::AttachmentControl(wgc0310::AttachmentStatus *attachmentStatus,
-                                     GLWindow *glWindow,
+                                     GLRenderer *renderer,
                                      StatusExtra *statusExtra)
   : m_AttachmentStatus(attachmentStatus),
-    m_GLWindow(glWindow),
+    m_Renderer(renderer),
     m_StatusExtra(statusExtra),
     m_ItemSelectMenu(new QMenu(this)),
     m_RightBigArmAttachment(new QPushButton("右侧大臂")),
@@ -42,14 +43,10 @@ AttachmentControl::AttachmentControl(wgc0310::AttachmentStatus *attachmentStatus
   m_LeftSmallArmConfig->setFixedWidth(32);
   m_ReloadButton->setFixedWidth(32);
 
-  connect(m_GLWindow, &GLWindow::OpenGLInitialized,
+  connect(m_Renderer, &GLRenderer::OpenGLInitialized,
           this, &AttachmentControl::ReloadAttachments);
   connect(m_ReloadButton, &QPushButton::clicked,
-          this, [this] {
-            m_GLWindow->RunWithGLContext([this] {
-              ReloadAttachments();
-            });
-          });
+          this, &AttachmentControl::ReloadAttachments);
 
   LinkButtonAndContextMenu(m_RightBigArmAttachment,
                            m_RightBigArmConfig,
@@ -175,9 +172,11 @@ AttachmentControl::AttachmentControl(wgc0310::AttachmentStatus *attachmentStatus
 
 void AttachmentControl::ReloadAttachments() {
   m_AttachmentStatus->Reset();
-  for (const auto &attachment: m_Attachments) {
-    attachment->Delete(m_GLWindow->GL);
-  }
+  m_Renderer->RunWithGLContext([this] {
+    for (const auto &attachment: m_Attachments) {
+      attachment->Delete(m_Renderer->GL);
+    }
+  });
   m_Attachments.clear();
   for (auto sharedObject: m_SharedObjects) {
     cw::DetachSharedObject(sharedObject);
@@ -271,7 +270,9 @@ void AttachmentControl::ReloadAttachments() {
       continue;
     }
 
-    animation->Initialize(m_GLWindow->GL);
+    m_Renderer->RunWithGLContext([this, animation] {
+      animation->Initialize(m_Renderer->GL);
+    });
 
     QAction *action = m_ItemSelectMenu->addAction(animation->GetName());
     action->setData(QVariant { static_cast<uint>(m_Attachments.size()) });
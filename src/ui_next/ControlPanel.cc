@@ -6,7 +6,10 @@
 #include <QMessageBox>
 #include <QTimer>
 #include <QLabel>
+#include "ui_next/GLRenderer.h"
+#include "GlobalConfig.h"
 #include "ui_next/GLWindow.h"
+#include "ui_next/GLDirectWindow.h"
 #include "ui_next/GLInfoDisplay.h"
 #include "ui_next/EntityControl.h"
 #include "ui_next/FaceTrackControl.h"
@@ -37,34 +40,30 @@ static void LinkButtonAndWidget(QPushButton *button, CloseSignallingWidget *widg
 ControlPanel::ControlPanel(bool startHideGL)
   : QWidget(nullptr, Qt::Window),
     m_ScreenDisplayMode(wgc0310::ScreenDisplayMode::CapturedExpression),
-    m_VolumeLevels(0.0),
-    m_VolumeLevelsUpdated(false),
+    m_VolumeLevels(cw::CircularBuffer<qreal, 160>(0.0)),
+    m_ScreenAnimationFrame(0),
     m_StartHideGL(startHideGL),
-    m_GLWindow(new GLWindow(
-      &m_EntityStatus,
-      &m_HeadStatus,
-      &m_BodyStatus,
-      &m_AttachmentStatus,
-      &m_ScreenAnimationStatus,
-      &m_VolumeLevels,
-      &m_VolumeLevelsUpdated,
-      &m_ScreenDisplayMode,
-      &m_ExtraStatus
-    )),
-    m_GLInfoDisplay(new GLInfoDisplay(m_GLWindow)),
+    m_Renderer(new GLRenderer(&m_RenderStatus, &m_HeadStatus, &m_VolumeLevels)),
+    m_GLWindow(cw::GlobalConfig::Instance.directPresent
+               ? nullptr
+               : new GLWindow(m_Renderer)),
+    m_GLDirectWindow(cw::GlobalConfig::Instance.directPresent
+                     ? new GLDirectWindow(m_Renderer)
+                     : nullptr),
+    m_GLInfoDisplay(new GLInfoDisplay(m_Renderer)),
     m_EntityControl(new EntityControl(&m_EntityStatus)),
     m_TrackControl(new TrackControl(&m_HeadStatus, &m_ScreenDisplayMode, &m_WorkerThread)),
     m_ScreenAnimationControl(new ScreenAnimationControl(
-      m_GLWindow,
+      m_Renderer,
       &m_ScreenAnimationStatus,
       &m_ScreenDisplayMode,
       &m_ExtraStatus
     )),
     m_BodyControl(new BodyControl(&m_BodyStatus, this)),
-    m_AttachmentControl(new AttachmentControl(&m_AttachmentStatus, m_GLWindow, &m_ExtraStatus)),
-    m_SoundControl(new SoundControl(&m_VolumeLevels, &m_VolumeLevelsUpdated, &m_WorkerThread)),
-    m_ExtraControl(new ExtraControl(m_GLWindow, &m_ExtraStatus)),
-    m_ShaderEdit(new ShaderEdit(m_GLWindow)),
+    m_AttachmentControl(new AttachmentControl(&m_AttachmentStatus, m_Renderer, &m_ExtraStatus)),
+    m_SoundControl(new SoundControl(&m_VolumeLevels, &m_WorkerThread)),
+    m_ExtraControl(new ExtraControl(m_Renderer, &m_ExtraStatus)),
+    m_ShaderEdit(new ShaderEdit(m_Renderer)),
     m_HelpBox(new HelpBox()),
     m_OpenGLSettingsButton(new QPushButton("OpenGL")),
     m_CameraSettingsButton(new QPushButton("物体位置")),
@@ -81,6 +80,10 @@ ControlPanel::ControlPanel(bool startHideGL)
 
   m_WorkerThread.start();
 
+  // all the widgets connected to `GLRenderer::OpenGLInitialized` by now
+  m_RenderThread.start();
+  m_Renderer->Start(&m_RenderThread);
+
   QTimer *timer = new QTimer(this);
   timer->setTimerType(Qt::PreciseTimer);
   timer->setInterval(1000 / 90);
@@ -90,6 +93,8 @@ ControlPanel::ControlPanel(bool startHideGL)
   LinkButtonAndWidget(m_OpenGLSettingsButton, m_GLInfoDisplay);
   LinkButtonAndWidget(m_CameraSettingsButton, m_EntityControl);
   LinkButtonAndWidget(m_FaceAnimationButton, m_ScreenAnimationControl);
+  connect(m_ScreenAnimationControl, &ScreenAnimationControl::ScreenAnimationChanged,
+          this, &ControlPanel::PublishRenderStatus);
   LinkButtonAndWidget(m_PoseEstimationButton, m_TrackControl);
   LinkButtonAndWidget(m_BodyAnimationButton, m_BodyControl);
   LinkButtonAndWidget(m_AttachmentButton, m_AttachmentControl);
@@ -110,7 +115,11 @@ ControlPanel::ControlPanel(bool startHideGL)
     bool helpBox = m_HelpBox->isVisible();
 
     this->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
-    m_GLWindow->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
+    if (m_GLWindow) {
+      m_GLWindow->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
+    } else {
+      m_GLDirectWindow->setFlag(Qt::WindowStaysOnTopHint, stayOnTop);
+    }
     m_GLInfoDisplay->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
     m_EntityControl->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
     m_TrackControl->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
@@ -123,7 +132,7 @@ ControlPanel::ControlPanel(bool startHideGL)
     m_HelpBox->setWindowFlag(Qt::WindowStaysOnTopHint, stayOnTop);
 
     this->show();
-    m_GLWindow->show();
+    ShowGLWindow();
     if (glInfo) { m_GLInfoDisplay->show(); }
     if (entityControl) { m_EntityControl->show(); }
     if (trackControl) { m_TrackControl->show(); }
@@ -160,13 +169,30 @@ ControlPanel::ControlPanel(bool startHideGL)
 }
 
 ControlPanel::~ControlPanel() noexcept {
+  // the render thread may still be drawing into it, detach while the thread
+  // is still around
+  delete m_GLDirectWindow;
+
+  m_Renderer->Shutdown();
+  m_RenderThread.quit();
+  m_RenderThread.wait();
+  delete m_Renderer;
+
   m_WorkerThread.quit();
   m_WorkerThread.wait();
 }
 
 void ControlPanel::DoneSplash() {
   if (!m_StartHideGL) {
+    ShowGLWindow();
+  }
+}
+
+void ControlPanel::ShowGLWindow() {
+  if (m_GLWindow) {
     m_GLWindow->show();
+  } else {
+    m_GLDirectWindow->show();
   }
 }
 
@@ -181,7 +207,11 @@ void ControlPanel::closeEvent(QCloseEvent *e) {
 #pragma clang diagnostic pop
 
   if (r == 1) {
-    m_GLWindow->close();
+    if (m_GLWindow) {
+      m_GLWindow->close();
+    } else {
+      m_GLDirectWindow->close();
+    }
     m_GLInfoDisplay->close();
     m_EntityControl->close();
     m_TrackControl->close();
@@ -210,5 +240,28 @@ void ControlPanel::NextTick() {
   // m_AttachmentStatus.NextTick();
   // m_ScreenAnimationStatus.NextTick();
   // m_BodyStatus.NextTick();
-  m_GLWindow->update();
+
+  if (m_ScreenAnimationStatus.animation) {
+    m_ScreenAnimationFrame += 1;
+  }
+
+  PublishRenderStatus();
+}
+
+void ControlPanel::PublishRenderStatus() {
+  RenderStatus status {
+    .entityStatus = m_EntityStatus,
+    .bodyStatus = m_BodyStatus,
+    .screenDisplayMode = m_ScreenDisplayMode,
+    .staticScreen = m_ScreenAnimationStatus.staticScreen,
+    .screenAnimation = m_ScreenAnimationStatus.animation,
+    .screenAnimationFrame = m_ScreenAnimationFrame,
+    .customClearColor = m_ExtraStatus.customClearColor,
+    .clearColor = m_ExtraStatus.clearColor
+  };
+  // only wake the renderer up if something actually changed
+  if (status != m_LastRenderStatus) {
+    m_RenderStatus.Publish(status);
+    m_LastRenderStatus = status;
+  }
 }
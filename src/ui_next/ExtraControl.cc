@@ -9,7 +9,7 @@
 
 #include "GlobalConfig.h"
 #include "cwglx/GL/GLImpl.h"
-#include "ui_next/GLWindow.h"
+#include "ui_next/GLRenderer.h"
 
 static QSpinBox *CreateColorSpinBox(GLfloat *linkedValue) {
   QSpinBox *ret = new QSpinBox();
@@ -22,9 +22,9 @@ static QSpinBox *CreateColorSpinBox(GLfloat *linkedValue) {
   return ret;
 }
 
-ExtraControl::ExtraControl(GLWindow *glWindow,
+ExtraControl::ExtraControl(GLRenderer *renderer,
                            StatusExtra *statusExtra)
-  : m_GLWindow(glWindow),
+  : m_Renderer(renderer),
     m_StatusExtra(statusExtra)
 {
   m_StatusExtra->stayOnTop = cw::GlobalConfig::Instance.stayOnTop;
@@ -109,21 +109,21 @@ ExtraControl::ExtraControl(GLWindow *glWindow,
     vBox->addWidget(lineSmooth);
 
     connect(multisample, &QCheckBox::toggled, this, [this](bool toggled) {
-      m_GLWindow->RunWithGLContext([this, toggled] {
+      m_Renderer->RunWithGLContext([this, toggled] {
         if (toggled) {
-          m_GLWindow->GL->glEnable(GL_MULTISAMPLE);
+          m_Renderer->GL->glEnable(GL_MULTISAMPLE);
         } else {
-          m_GLWindow->GL->glDisable(GL_MULTISAMPLE);
+          m_Renderer->GL->glDisable(GL_MULTISAMPLE);
         }
       });
     });
 
     connect(lineSmooth, &QCheckBox::toggled, this, [this](bool toggled) {
-      m_GLWindow->RunWithGLContext([this, toggled] {
+      m_Renderer->RunWithGLContext([this, toggled] {
         if (toggled) {
-          m_GLWindow->GL->glEnable(GL_LINE_SMOOTH);
+          m_Renderer->GL->glEnable(GL_LINE_SMOOTH);
         } else {
-          m_GLWindow->GL->glDisable(GL_LINE_SMOOTH);
+          m_Renderer->GL->glDisable(GL_LINE_SMOOTH);
         }
       });
     });
@@ -137,9 +137,9 @@ ExtraControl::ExtraControl(GLWindow *glWindow,
     groupBox->setLayout(vBox);
 
     QPushButton *reloadModelButton = new QPushButton("重新加载模型");
-    connect(reloadModelButton, &QPushButton::clicked, m_GLWindow, [this] {
-      m_GLWindow->RunWithGLContext([this] {
-        m_GLWindow->ReloadModel();
+    connect(reloadModelButton, &QPushButton::clicked, this, [this] {
+      m_Renderer->RunWithGLContext([this] {
+        m_Renderer->ReloadModel();
       });
     });
     vBox->addWidget(reloadModelButton);
@@ -0,0 +1,69 @@
+#include "ui_next/GLDirectWindow.h"
+
+#include <QPlatformSurfaceEvent>
+#include <QResizeEvent>
+
+#include "ui_next/GLRenderer.h"
+
+GLDirectWindow::GLDirectWindow(GLRenderer *renderer)
+  : QWindow(),
+    m_Renderer(renderer),
+    m_Presenting(false)
+{
+  setSurfaceType(QSurface::OpenGLSurface);
+  // `QWindow` has no `Qt::WA_TranslucentBackground` like `GLWindow` has, an
+  // alpha channel in the surface format is what makes the platform create a
+  // translucent surface, so it's asked for explicitly rather than relying on
+  // the default format carrying one
+  QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+  format.setAlphaBufferSize(8);
+  setFormat(format);
+  setTitle("Project-WG - 绘图输出窗口");
+  setFlags(Qt::Window
+           | Qt::CustomizeWindowHint
+           | Qt::WindowTitleHint
+           | Qt::WindowMaximizeButtonHint);
+  resize(600, 600);
+
+  connect(this, &GLDirectWindow::Resized, m_Renderer, &GLRenderer::Resize);
+}
+
+GLDirectWindow::~GLDirectWindow() {
+  if (m_Presenting) {
+    m_Renderer->SetPresentWindow(nullptr);
+  }
+}
+
+bool GLDirectWindow::event(QEvent *e) {
+  if (e->type() == QEvent::PlatformSurface) {
+    auto *surfaceEvent = static_cast<QPlatformSurfaceEvent*>(e);
+    if (surfaceEvent->surfaceEventType() == QPlatformSurfaceEvent::SurfaceAboutToBeDestroyed
+        && m_Presenting) {
+      // the render thread must let go of the surface before it goes away
+      m_Renderer->SetPresentWindow(nullptr);
+      m_Presenting = false;
+    }
+  }
+  return QWindow::event(e);
+}
+
+void GLDirectWindow::exposeEvent(QExposeEvent *e) {
+  Q_UNUSED(e)
+  UpdatePresenting();
+}
+
+void GLDirectWindow::resizeEvent(QResizeEvent *e) {
+  qreal dpr = devicePixelRatio();
+  emit Resized(static_cast<int>(e->size().width() * dpr),
+               static_cast<int>(e->size().height() * dpr));
+}
+
+void GLDirectWindow::UpdatePresenting() {
+  bool exposed = isExposed();
+  if (exposed == m_Presenting) {
+    return;
+  }
+
+  m_Renderer->SetPresentWindow(exposed ? this : nullptr);
+  m_Presenting = exposed;
+}
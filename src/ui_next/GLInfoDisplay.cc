@@ -1,18 +1,21 @@
 #include "ui_next/GLInfoDisplay.h"
 
+#include <memory>
+#include <QCheckBox>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPlainTextEdit>
 #include <QGridLayout>
 #include <QMenu>
 #include <QTimer>
+#include "GlobalConfig.h"
 #include "cwglx/GL/GLImpl.h"
 #include "cwglx/GL/GLInfo.h"
-#include "ui_next/GLWindow.h"
+#include "ui_next/GLRenderer.h"
 #include "ui_next/SearchDialog.h"
 
-GLInfoDisplay::GLInfoDisplay(GLWindow *glWindow)
-  : m_GLWindow(glWindow),
+GLInfoDisplay::GLInfoDisplay(GLRenderer *renderer)
+  : m_GLRenderer(renderer),
     m_Vendor(new QLineEdit()),
     m_Version(new QLineEdit()),
     m_Renderer(new QLineEdit()),
@@ -65,12 +68,103 @@ GLInfoDisplay::GLInfoDisplay(GLWindow *glWindow)
   layout->addWidget(m_Renderer, 2, 1);
   layout->addWidget(m_Extensions, 3, 1);
 
-  connect(m_GLWindow, &GLWindow::OpenGLInitialized,
+  QLabel *latencyLabel = new QLabel("呈现延迟");
+  latencyLabel->setFont(monospaceFont);
+  QLineEdit *latency = new QLineEdit();
+  latency->setFont(monospaceFont);
+  latency->setReadOnly(true);
+  layout->addWidget(latencyLabel, 6, 0);
+  layout->addWidget(latency, 6, 1);
+
+  QLabel *stateCacheLabel = new QLabel("状态切换 / 帧");
+  stateCacheLabel->setFont(monospaceFont);
+  QLineEdit *stateCache = new QLineEdit();
+  stateCache->setFont(monospaceFont);
+  stateCache->setReadOnly(true);
+  layout->addWidget(stateCacheLabel, 7, 0);
+  layout->addWidget(stateCache, 7, 1);
+
+  QLabel *qualityLabel = new QLabel("渲染质量");
+  qualityLabel->setFont(monospaceFont);
+  QLineEdit *quality = new QLineEdit();
+  quality->setFont(monospaceFont);
+  quality->setReadOnly(true);
+  layout->addWidget(qualityLabel, 8, 0);
+  layout->addWidget(quality, 8, 1);
+
+  QTimer *latencyTimer = new QTimer(this);
+  latencyTimer->setInterval(500);
+  latencyTimer->setTimerType(Qt::VeryCoarseTimer);
+  connect(latencyTimer, &QTimer::timeout, this, [this, latency, stateCache, quality] {
+    qint64 presentLatency = m_GLRenderer->QueryPresentLatency();
+    if (presentLatency != 0) {
+      // averaged per output path, so that both can be compared
+      latency->setText(AddSample(&m_LatencyAverages,
+                                 OutputPathName(),
+                                 static_cast<double>(presentLatency) / 1'000'000.0));
+    }
+
+    cw::GLStateCache::Counters counters = m_GLRenderer->QueryStateCacheCounters();
+    stateCache->setText(QStringLiteral("发出 %1, 省略 %2")
+                          .arg(counters.issued)
+                          .arg(counters.elided));
+
+    QualityGovernor::Decision decision = m_GLRenderer->QueryQualityDecision();
+    // also tells what the GPU time above was measured with
+    quality->setText(QStringLiteral("分辨率 %1%, %2 (%3)")
+                       .arg(static_cast<int>(decision.scale * 100.0f))
+                       .arg(AntiAliasingName())
+                       .arg(cw::GlobalConfig::Instance.dynamicQuality
+                            ? "自动调节"
+                            : "固定"));
+  });
+  latencyTimer->start();
+
+  connect(m_GLRenderer, &GLRenderer::OpenGLInitialized,
           this, &GLInfoDisplay::LoadGLInfo);
 }
 
+QString GLInfoDisplay::AntiAliasingName() const {
+  if (m_GLRenderer->IsFXAAEnabled()) {
+    return QStringLiteral("FXAA");
+  }
+  GLsizei samples = m_GLRenderer->QueryQualityDecision().samples;
+  return samples > 0
+         ? QStringLiteral("MSAA %1x").arg(samples)
+         : QStringLiteral("无抗锯齿");
+}
+
+QString GLInfoDisplay::OutputPathName() const {
+  return m_GLRenderer->IsPresentingDirectly()
+         ? QStringLiteral("直接输出")
+         : QStringLiteral("QOpenGLWidget");
+}
+
+QString GLInfoDisplay::AddSample(QMap<QString, Average> *averages,
+                                 QString const& key,
+                                 double ms) {
+  Average &average = (*averages)[key];
+  average.ms += ms;
+  average.count += 1;
+
+  QStringList texts;
+  for (auto it = averages->cbegin(); it != averages->cend(); ++it) {
+    texts.append(QStringLiteral("%1: %2 ms")
+                   .arg(it.key())
+                   .arg(it->ms / it->count, 0, 'f', 3));
+  }
+  return texts.join(" | ");
+}
+
 void GLInfoDisplay::LoadGLInfo() {
-  cw::GLInfo info = cw::GLInfo::AutoDetect(m_GLWindow->GL);
+  std::unique_ptr<cw::GLInfo> glInfo;
+  m_GLRenderer->RunWithGLContext([this, &glInfo] {
+    glInfo = std::make_unique<cw::GLInfo>(cw::GLInfo::AutoDetect(m_GLRenderer->GL));
+  }, true);
+  if (!glInfo) {
+    return;
+  }
+  cw::GLInfo const& info = *glInfo;
 
   m_Vendor->setText(info.vendor);
   m_Version->setText(info.version);
@@ -93,33 +187,53 @@ void GLInfoDisplay::LoadGLInfo() {
     time->setReadOnly(true);
     layout->addWidget(time, 4, 1);
 
-    m_GLWindow->EnablePerformanceCounter();
+    QCheckBox *fxaa = new QCheckBox("FXAA");
+    fxaa->setFont(fixedFont);
+    fxaa->setChecked(m_GLRenderer->IsFXAAEnabled());
+    connect(fxaa, &QCheckBox::toggled,
+            this, [this](bool checked) { m_GLRenderer->SetFXAA(checked); });
+    layout->addWidget(fxaa, 9, 0);
+    QLineEdit *comparison = new QLineEdit();
+    comparison->setFont(fixedFont);
+    comparison->setReadOnly(true);
+    layout->addWidget(comparison, 9, 1);
+
+    m_GLRenderer->EnablePerformanceCounter();
 
     QTimer *timer = new QTimer(this);
     timer->setInterval(500);
     timer->setTimerType(Qt::VeryCoarseTimer);
-    connect(timer, &QTimer::timeout, this, [this, time] {
-      this->m_GLWindow->RunWithGLContext([this, time] {
-        GLuint64 counter = m_GLWindow->QueryPerformanceCounter();
-        double percentage = (static_cast<double>(counter) / 16'666'666.7) * 100.0;
-        if (counter != 0) {
-          if (counter < 1'000) {
-            time->setText(QStringLiteral("%1 ns (%2%)")
-                            .arg(counter)
-                            .arg(percentage));
-          } if (counter < 1'000'000) {
-            double us = static_cast<double>(counter) / 1'000.0;
-            time->setText(QStringLiteral("%1 μs (%2%)")
-                            .arg(static_cast<int>(us))
-                            .arg(percentage));
-          } else {
-            double ms = static_cast<double>(counter) / 1'000'000.0;
-            time->setText(QStringLiteral("%1 ms (%2%)")
-                            .arg(static_cast<int>(ms))
-                            .arg(percentage));
-          }
+    connect(timer, &QTimer::timeout, this, [this, time, comparison] {
+      // the counter is sampled by the render thread, no context needed here
+      GLuint64 counter = m_GLRenderer->QueryPerformanceCounter();
+      double percentage = (static_cast<double>(counter) / 16'666'666.7) * 100.0;
+      if (counter != 0) {
+        // the direct path has its blit to the window counted in as well
+        QString path = OutputPathName();
+        comparison->setText(AddSample(&m_GPUTimeAverages,
+                                      QStringLiteral("%1, %2")
+                                        .arg(AntiAliasingName(), path),
+                                      static_cast<double>(counter) / 1'000'000.0));
+
+        if (counter < 1'000) {
+          time->setText(QStringLiteral("%1 ns (%2%, %3)")
+                          .arg(counter)
+                          .arg(percentage)
+                          .arg(path));
+        } if (counter < 1'000'000) {
+          double us = static_cast<double>(counter) / 1'000.0;
+          time->setText(QStringLiteral("%1 μs (%2%, %3)")
+                          .arg(static_cast<int>(us))
+                          .arg(percentage)
+                          .arg(path));
+        } else {
+          double ms = static_cast<double>(counter) / 1'000'000.0;
+          time->setText(QStringLiteral("%1 ms (%2%, %3)")
+                          .arg(static_cast<int>(ms))
+                          .arg(percentage)
+                          .arg(path));
         }
-      });
+      }
     });
     timer->start();
   }
@@ -136,27 +250,20 @@ void GLInfoDisplay::LoadGLInfo() {
     mem->setReadOnly(true);
     layout->addWidget(mem, 5, 1);
 
+    if (!m_GLRenderer->EnableMemoryInfo()) {
+      mem->setText("错误");
+      return;
+    }
+
     QTimer *timer = new QTimer(this);
     timer->setInterval(500);
     timer->setTimerType(Qt::VeryCoarseTimer);
-    connect(timer, &QTimer::timeout, this, [this, timer, mem] {
-      this->m_GLWindow->RunWithGLContext([this, timer, mem] {
-        GLint cur, dedicated;
-        m_GLWindow->GL->glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &cur);
-        m_GLWindow->GL->glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicated);
-        GLenum err = m_GLWindow->GL->glGetError();
-        if (err == GL_NO_ERROR) {
-          mem->setText(QStringLiteral("%1 MB / %2 MB")
-                         .arg((dedicated - cur) / 1024)
-                         .arg(dedicated / 1024));
-        } else {
-          mem->setText("错误");
-          qWarning() << "GLInfoDisplay::LoadGLInfo() callback:"
-                     << "OpenGL error:"
-                     << err;
-          timer->stop();
-        }
-      });
+    connect(timer, &QTimer::timeout, this, [this, mem] {
+      // sampled along with each frame, polling must not cost one
+      GLRenderer::MemoryInfo info = m_GLRenderer->QueryMemoryInfo();
+      mem->setText(QStringLiteral("%1 MB / %2 MB")
+                     .arg((info.dedicated - info.available) / 1024)
+                     .arg(info.dedicated / 1024));
     });
     timer->start();
   }
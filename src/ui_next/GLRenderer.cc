@@ -0,0 +1,1161 @@
+#include "ui_next/GLRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <QApplication>
+#include <QMutexLocker>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QThread>
+#include <QTimer>
+#include <QWindow>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "GlobalConfig.h"
+#include "cwglx/Setup.h"
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLStateCache.h"
+#include "cwglx/Object/ProgramCache.h"
+#include "cwglx/Object/TextureCache.h"
+#include "wgc0310/ScreenAnimationStatus.h"
+#include "wgc0310/ScreenImageArray.h"
+
+// the tick the frame timer polls at
+static constexpr int FrameRate = 90;
+
+GLRenderer::GLRenderer(RenderStatusBuffer *renderStatus,
+                       wgc0310::HeadStatusBuffer *headStatus,
+                       VolumeLevelsBuffer *volumeLevels)
+  : QObject(nullptr),
+    GL(new GLFunctions()),
+    m_Context(nullptr),
+    m_Surface(nullptr),
+    m_FrameTimer(nullptr),
+    m_Initialized(false),
+    m_FrameRequested(true),
+    m_PresentWindow(nullptr),
+    m_PresentingDirectly(false),
+    m_PresentLatency(0),
+    m_StateCallsIssued(0),
+    m_StateCallsElided(0),
+    m_RenderStatus(renderStatus),
+    m_HeadStatus(headStatus),
+    m_VolumeLevels(volumeLevels),
+    m_Width(600),
+    m_Height(600),
+    m_RenderWidth(600),
+    m_RenderHeight(600),
+    m_Samples(0),
+    m_ConfiguredSamples(0),
+    m_SceneFBO(0),
+    m_SceneColorBuffer(0),
+    m_SceneDepthBuffer(0),
+    m_FXAA(false),
+    m_SceneColorTexture(0),
+    m_PostVAO(0),
+    m_ResolveFBO(0),
+    m_ResolveColorBuffer(0),
+    m_SceneBufferDirty(true),
+    m_QualityGovernor(nullptr),
+    m_QualityScale(1.0f),
+    m_QualitySamples(0),
+    m_QualityFXAA(false),
+    m_BackIndex(0),
+    m_ReadyIndex(1),
+    m_FrontIndex(2),
+    m_ReadyFresh(false),
+    m_GLObjectContext(std::make_shared<cw::GLObjectContext>()),
+    m_Shader(nullptr),
+    m_Screen(nullptr),
+    m_ScreenImages(nullptr),
+    m_ScreenContentDirty(true),
+    m_ScreenAnimation(nullptr),
+    m_ScreenAnimationFrame(0),
+    m_Projection(1.0f),
+    m_PerformanceCounter(0),
+    m_PerformanceCounterEnabled(false),
+    m_PerformanceCounterPending(false),
+    m_PerformanceCounterValue(0),
+    m_MemoryInfoEnabled(false),
+    m_MemoryAvailable(0),
+    m_MemoryDedicated(0)
+{
+  m_LatencyClock.start();
+}
+
+GLRenderer::~GLRenderer() {
+  if (m_Initialized) {
+    qWarning() << "GLRenderer deleted before releasing relevant OpenGL resources";
+  }
+
+  delete m_Surface;
+  delete GL;
+}
+
+void GLRenderer::SetupSurfaceFormat() {
+  QSurfaceFormat format;
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  format.setVersion(3, 3);
+  format.setAlphaBufferSize(8);
+  format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
+  QSurfaceFormat::setDefaultFormat(format);
+
+  // the renderer and the presenting window live in different contexts,
+  // frames are handed over as shared textures
+  QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+}
+
+void GLRenderer::Start(QThread *renderThread) {
+  // both the context and the offscreen surface must be created on GUI thread
+  m_Context = new QOpenGLContext();
+  m_Context->setFormat(QSurfaceFormat::defaultFormat());
+  m_Context->setShareContext(QOpenGLContext::globalShareContext());
+  if (!m_Context->create()) {
+    qCritical() << "GLRenderer::Start(QThread*):"
+                << "failed creating OpenGL context";
+    std::abort();
+  }
+
+  m_Surface = new QOffscreenSurface();
+  m_Surface->setFormat(m_Context->format());
+  m_Surface->create();
+
+  m_AssetStreamer.Start(m_Context);
+
+  m_Context->moveToThread(renderThread);
+  this->moveToThread(renderThread);
+
+  QMetaObject::invokeMethod(this, &GLRenderer::InitializeGL, Qt::QueuedConnection);
+}
+
+void GLRenderer::Shutdown() {
+  RunWithGLContext([this] {
+    m_FrameTimer->stop();
+    m_AssetStreamer.Shutdown(GL);
+
+    if (m_Shader) {
+      m_Shader->Delete(GL);
+    }
+    if (m_Model) {
+      m_Model->Delete(GL);
+    }
+    m_GLObjectContext->Delete(GL);
+    if (m_PendingObjectContext) {
+      m_PendingObjectContext->Delete(GL);
+    }
+    for (std::shared_ptr<cw::GLObjectContext> const& ctx : m_SupersededObjectContexts) {
+      ctx->Delete(GL);
+    }
+    m_SupersededObjectContexts.clear();
+    m_Screen->Delete(GL);
+    m_ScreenImages->Delete(GL);
+    m_FrameUniforms->Delete(GL);
+
+    for (GLRenderTarget &target : m_Targets) {
+      if (target.writeFence) {
+        GL->glDeleteSync(target.writeFence);
+      }
+      if (target.readFence) {
+        GL->glDeleteSync(target.readFence);
+      }
+      m_StateCache.ForgetFramebuffer(target.fbo);
+      m_StateCache.ForgetTexture(target.texture);
+      GL->glDeleteFramebuffers(1, &target.fbo);
+      GL->glDeleteTextures(1, &target.texture);
+      target = GLRenderTarget {};
+    }
+
+    GL->glDeleteFramebuffers(1, &m_SceneFBO);
+    GL->glDeleteRenderbuffers(1, &m_SceneColorBuffer);
+    GL->glDeleteRenderbuffers(1, &m_SceneDepthBuffer);
+    if (m_SceneColorTexture) {
+      m_StateCache.ForgetTexture(m_SceneColorTexture);
+      GL->glDeleteTextures(1, &m_SceneColorTexture);
+    }
+    if (m_PostVAO) {
+      m_StateCache.ForgetVertexArray(m_PostVAO);
+      GL->glDeleteVertexArrays(1, &m_PostVAO);
+    }
+    if (m_ResolveFBO) {
+      GL->glDeleteFramebuffers(1, &m_ResolveFBO);
+      GL->glDeleteRenderbuffers(1, &m_ResolveColorBuffer);
+    }
+
+    if (m_PerformanceCounterEnabled) {
+      GL->glDeleteQueries(1, &m_PerformanceCounter);
+    }
+
+    cw::GLStateCache::DoneCurrent();
+    m_Context->doneCurrent();
+    delete m_Context;
+    m_Context = nullptr;
+    m_Initialized = false;
+  });
+}
+
+void GLRenderer::RunWithGLContext(std::function<void(void)> const& f, bool readOnly) {
+  auto run = [this, &f, readOnly] {
+    if (!m_Initialized) {
+      qWarning() << "GLRenderer::RunWithGLContext(std::function<void(void)> const&, bool):"
+                 << "OpenGL context not initialized yet";
+      return;
+    }
+    f();
+    if (readOnly) {
+      return;
+    }
+    // whatever `f` did probably changed what's on screen, and may have
+    // changed OpenGL state without going through the state cache
+    m_StateCache.Invalidate();
+    m_FrameRequested = true;
+  };
+
+  if (QThread::currentThread() == this->thread()) {
+    run();
+  } else {
+    QMetaObject::invokeMethod(this, run, Qt::BlockingQueuedConnection);
+  }
+}
+
+void GLRenderer::EnablePerformanceCounter() {
+  RunWithGLContext([this] {
+    if (!m_PerformanceCounterEnabled) {
+      GL->glGenQueries(1, &m_PerformanceCounter);
+      m_PerformanceCounterEnabled = true;
+    }
+  }, true);
+}
+
+GLuint64 GLRenderer::QueryPerformanceCounter() const noexcept {
+  return m_PerformanceCounterValue.load(std::memory_order_relaxed);
+}
+
+bool GLRenderer::ForgetScreenAnimation(wgc0310::WGAPIAnimation *animation) {
+  // otherwise the next frame may still read the status it was published
+  // with. The frame requested by `RunWithGLContext` draws the new one
+  m_RenderStatus->Update();
+
+  if (m_ScreenAnimation == animation) {
+    m_ScreenAnimation = nullptr;
+    m_ScreenContentDirty = true;
+  }
+
+  if (m_RenderStatus->Read().screenAnimation == animation) {
+    qWarning() << "GLRenderer::ForgetScreenAnimation(wgc0310::WGAPIAnimation*):"
+               << "animation still referred to by the latest status";
+    return false;
+  }
+  return true;
+}
+
+bool GLRenderer::EnableMemoryInfo() {
+  GLenum error = GL_NO_ERROR;
+  RunWithGLContext([this, &error] {
+    // probed once here, so that the frame loop needs no glGetError
+    SampleMemoryInfo();
+    error = GL->glGetError();
+    m_MemoryInfoEnabled = error == GL_NO_ERROR;
+  }, true);
+
+  if (error != GL_NO_ERROR) {
+    qWarning() << "GLRenderer::EnableMemoryInfo():"
+               << "OpenGL error:"
+               << error;
+  }
+  return m_MemoryInfoEnabled;
+}
+
+GLRenderer::MemoryInfo GLRenderer::QueryMemoryInfo() const noexcept {
+  return MemoryInfo {
+    .available = m_MemoryAvailable.load(std::memory_order_relaxed),
+    .dedicated = m_MemoryDedicated.load(std::memory_order_relaxed)
+  };
+}
+
+void GLRenderer::SampleMemoryInfo() {
+  GLint available = 0;
+  GLint dedicated = 0;
+  GL->glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+  GL->glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicated);
+  m_MemoryAvailable.store(available, std::memory_order_relaxed);
+  m_MemoryDedicated.store(dedicated, std::memory_order_relaxed);
+}
+
+qint64 GLRenderer::QueryPresentLatency() const noexcept {
+  return m_PresentLatency.load(std::memory_order_relaxed);
+}
+
+QualityGovernor::Decision GLRenderer::QueryQualityDecision() const noexcept {
+  return QualityGovernor::Decision {
+    .scale = m_QualityScale.load(std::memory_order_relaxed),
+    .samples = m_QualitySamples.load(std::memory_order_relaxed)
+  };
+}
+
+void GLRenderer::SetFXAA(bool enabled) {
+  RunWithGLContext([this, enabled] {
+    if (enabled != m_FXAA) {
+      SetupAntiAliasing(enabled);
+    }
+  });
+}
+
+bool GLRenderer::IsFXAAEnabled() const noexcept {
+  return m_QualityFXAA.load(std::memory_order_relaxed);
+}
+
+cw::GLStateCache::Counters GLRenderer::QueryStateCacheCounters() const noexcept {
+  return cw::GLStateCache::Counters {
+    .issued = m_StateCallsIssued.load(std::memory_order_relaxed),
+    .elided = m_StateCallsElided.load(std::memory_order_relaxed)
+  };
+}
+
+void GLRenderer::SetPresentWindow(QWindow *window) {
+  // not going through `RunWithGLContext`, the window may get exposed before
+  // the context is initialized
+  auto set = [this, window] {
+    m_PresentWindow = window;
+    m_PresentingDirectly.store(window != nullptr, std::memory_order_relaxed);
+    m_FrameRequested = true;
+  };
+
+  if (QThread::currentThread() == this->thread()) {
+    set();
+  } else {
+    QMetaObject::invokeMethod(this, set, Qt::BlockingQueuedConnection);
+  }
+}
+
+bool GLRenderer::IsPresentingDirectly() const noexcept {
+  return m_PresentingDirectly.load(std::memory_order_relaxed);
+}
+
+cw::AssetStreamer *GLRenderer::GetAssetStreamer() noexcept {
+  return &m_AssetStreamer;
+}
+
+void GLRenderer::CompileShaderAsync(
+  wgc0310::ShaderText text,
+  QObject *receiver,
+  std::function<void(bool success, QString const& error)> done
+) {
+  m_AssetStreamer.RequestUpload([this, text, receiver, done](GLFunctions *f) {
+    // programs are shared between contexts, only the uniform locations and
+    // block bindings resolved here are needed by the render thread
+    QString errorMessage;
+    std::shared_ptr<std::unique_ptr<wgc0310::ShaderCollection>> shader =
+      std::make_shared<std::unique_ptr<wgc0310::ShaderCollection>>(
+        wgc0310::CompileShader(f, text, &errorMessage)
+      );
+
+    auto report = [receiver, done](bool success, QString const& errorMessage) {
+      QMetaObject::invokeMethod(
+        receiver,
+        [done, success, errorMessage] { done(success, errorMessage); },
+        Qt::QueuedConnection
+      );
+    };
+
+    if (!*shader) {
+      report(false, errorMessage);
+      return cw::AssetStreamer::UploadResult {};
+    }
+
+    return cw::AssetStreamer::UploadResult {
+      .complete = [this, shader, report](GLFunctions*) {
+        // `Poll` runs before anything of the frame is drawn
+        SetShader(std::move(*shader));
+        report(true, QString());
+      },
+      .discard = [shader](GLFunctions *f) {
+        (*shader)->Delete(f);
+      }
+    };
+  });
+}
+
+void GLRenderer::PrefetchScreenImages(
+  std::vector<std::shared_ptr<wgc0310::StaticScreenImage const>> images
+) {
+  QMetaObject::invokeMethod(
+    this,
+    [this, images = std::move(images)] {
+      if (!m_Initialized) {
+        return;
+      }
+      for (auto const& image : images) {
+        LoadScreenImage(*image);
+      }
+    },
+    Qt::QueuedConnection
+  );
+}
+
+void GLRenderer::ReleaseScreenImages(std::vector<std::uint64_t> imageIds) {
+  QMetaObject::invokeMethod(
+    this,
+    [this, imageIds = std::move(imageIds)] {
+      if (!m_Initialized) {
+        return;
+      }
+      for (std::uint64_t imageId : imageIds) {
+        m_ScreenImages->RemoveImage(imageId);
+      }
+    },
+    Qt::QueuedConnection
+  );
+}
+
+void GLRenderer::ReloadModel() {
+  // a reload still streaming in gets superseded, it cleans up after itself
+  // once it finishes
+  if (m_PendingObjectContext) {
+    m_SupersededObjectContexts.push_back(std::move(m_PendingObjectContext));
+  }
+  std::shared_ptr<cw::GLObjectContext> ctx = std::make_shared<cw::GLObjectContext>();
+  m_PendingObjectContext = ctx;
+
+  wgc0310::StreamWGCModel(
+    &m_AssetStreamer,
+    ctx,
+    [this, ctx](GLFunctions *f, wgc0310::WGCModel &&model) {
+      if (m_PendingObjectContext != ctx) {
+        model.Delete(f);
+        ctx->Delete(f);
+        std::erase(m_SupersededObjectContexts, ctx);
+        return;
+      }
+
+      if (m_Model) {
+        m_Model->Delete(f);
+      }
+      m_GLObjectContext->Delete(f);
+
+      m_Model = std::make_unique<wgc0310::WGCModel>(std::move(model));
+      m_GLObjectContext = std::move(m_PendingObjectContext);
+      m_FrameRequested = true;
+    }
+  );
+}
+
+bool GLRenderer::SetShader(std::unique_ptr<wgc0310::ShaderCollection> &&shader) {
+  Q_ASSERT(QThread::currentThread() == this->thread());
+  if (m_Shader) {
+    m_Shader->Delete(GL);
+  }
+  m_Shader = std::move(shader);
+  UpdateProjection();
+  m_FrameRequested = true;
+
+  return true;
+}
+
+void GLRenderer::RequestFrame() noexcept {
+  m_FrameRequested = true;
+}
+
+GLRenderTarget *GLRenderer::AcquireFrontTarget(std::size_t *index) {
+  {
+    QMutexLocker locker(&m_TargetMutex);
+    if (m_ReadyFresh) {
+      std::swap(m_FrontIndex, m_ReadyIndex);
+      m_ReadyFresh = false;
+    }
+    *index = m_FrontIndex;
+  }
+
+  GLRenderTarget *target = &m_Targets[*index];
+  return target->texture != 0 ? target : nullptr;
+}
+
+void GLRenderer::ReportPresented(GLRenderTarget const* target) noexcept {
+  m_PresentLatency.store(m_LatencyClock.nsecsElapsed() - target->frameStart,
+                         std::memory_order_relaxed);
+}
+
+void GLRenderer::Resize(int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  m_Width = width;
+  m_Height = height;
+  m_SceneBufferDirty = true;
+  m_FrameRequested = true;
+  UpdateProjection();
+}
+
+void GLRenderer::InitializeGL() {
+  if (!m_Context->makeCurrent(m_Surface)) {
+    qCritical() << "GLRenderer::InitializeGL():"
+                << "failed making OpenGL context current";
+    std::abort();
+  }
+
+  // made current first, the preferred state is set through it
+  m_StateCache.MakeCurrent();
+  cw::SetupPreferred(GL);
+  cw::DetectTextureCompression(GL);
+  cw::DetectProgramBinarySupport(GL);
+
+  if (cw::GlobalConfig::Instance.multisampling) {
+    m_ConfiguredSamples = cw::GlobalConfig::Instance.multisamplingSamples;
+
+    // renderbuffer storage fails for more samples than the driver supports,
+    // and the quality governor must not start from such a count either
+    GLint maxSamples = 0;
+    GL->glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    if (m_ConfiguredSamples > maxSamples) {
+      qWarning() << "GLRenderer::InitializeGL():"
+                 << "multisampling samples"
+                 << m_ConfiguredSamples
+                 << "exceed GL_MAX_SAMPLES, clamped to"
+                 << maxSamples;
+      m_ConfiguredSamples = maxSamples;
+    }
+  }
+  SetupAntiAliasing(cw::GlobalConfig::Instance.fxaa);
+
+  if (cw::GlobalConfig::Instance.lineSmoothHint) {
+    GL->glEnable(GL_LINE_SMOOTH);
+    GL->glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+  } else {
+    GL->glDisable(GL_LINE_SMOOTH);
+  }
+
+  m_Initialized = true;
+
+  if (cw::GlobalConfig::Instance.dynamicQuality) {
+    // the governor lives off the same timer query
+    EnablePerformanceCounter();
+  }
+
+  m_Screen = std::make_unique<wgc0310::Screen>(
+    GL,
+    cw::GlobalConfig::Instance.proceduralScreen
+  );
+  m_ScreenImages = std::make_unique<wgc0310::ScreenImageArray>(
+    GL,
+    static_cast<std::size_t>(cw::GlobalConfig::Instance.screenImageBudget) * 1024 * 1024
+  );
+  m_FrameUniforms = std::make_unique<cw::FrameUBO>(GL);
+  m_FrameUniforms->Allocate(GL, FrameBlockCount);
+  ReloadModel();
+
+  m_FrameTimer = new QTimer(this);
+  m_FrameTimer->setTimerType(Qt::PreciseTimer);
+  m_FrameTimer->setInterval(1000 / FrameRate);
+  connect(m_FrameTimer, &QTimer::timeout, this, &GLRenderer::RenderFrame);
+  m_FrameTimer->start();
+  m_SinceLastFrame.start();
+
+  emit OpenGLInitialized();
+}
+
+void GLRenderer::RenderFrame() {
+  if (m_AssetStreamer.Poll(GL)) {
+    m_FrameRequested = true;
+  }
+  if (m_ScreenImages->Update(GL)) {
+    m_FrameRequested = true;
+  }
+
+  if (!m_Shader) {
+    // shader not compiled yet
+    return;
+  }
+
+  if (!ShouldRenderFrame()) {
+    return;
+  }
+
+  if (m_SceneBufferDirty) {
+    ReallocateSceneBuffer();
+  }
+
+  RenderStatus const& status = m_RenderStatus->Read();
+  qint64 frameStart = m_LatencyClock.nsecsElapsed();
+
+  bool queryStarted = false;
+  if (m_PerformanceCounterEnabled) {
+    if (m_PerformanceCounterPending) {
+      GLint available = 0;
+      GL->glGetQueryObjectiv(m_PerformanceCounter, GL_QUERY_RESULT_AVAILABLE, &available);
+      if (available) {
+        GLuint64 result = 0;
+        GL->glGetQueryObjectui64v(m_PerformanceCounter, GL_QUERY_RESULT, &result);
+        m_PerformanceCounterValue.store(result, std::memory_order_relaxed);
+        m_PerformanceCounterPending = false;
+
+        if (m_QualityGovernor && m_QualityGovernor->AddSample(result)) {
+          ApplyQualityDecision();
+        }
+      }
+    }
+
+    if (!m_PerformanceCounterPending) {
+      GL->glBeginQuery(GL_TIME_ELAPSED, m_PerformanceCounter);
+      queryStarted = true;
+    }
+  }
+
+  if (m_MemoryInfoEnabled) {
+    SampleMemoryInfo();
+  }
+
+  glm::mat4 modelView = glm::identity<glm::mat4x4>();
+  modelView = glm::scale(modelView, glm::vec3(0.01f, 0.01f, 0.01f));
+  status.entityStatus.ToMatrix(modelView);
+
+  // prepare screen content, kept from previous frames unless it changed. A
+  // screen that cannot be seen stays dirty until it can
+  glm::mat4 screenModelView = ScreenModelView(modelView);
+  glm::mat4 screenTransform = m_Projection * screenModelView;
+  bool screenVisible = m_Screen->IsVisible(screenTransform);
+  if (screenVisible) {
+    if (m_Screen->UpdateResolution(GL, screenTransform, m_RenderWidth, m_RenderHeight)) {
+      m_ScreenContentDirty = true;
+    }
+    if (m_ScreenContentDirty) {
+      m_Screen->BeginScreenContext(GL);
+      m_ScreenContentDirty = !DrawScreenContent(status);
+      m_Screen->DoneScreenContext(GL);
+    }
+  }
+
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, m_SceneFBO);
+  GL->glViewport(0, 0, m_RenderWidth, m_RenderHeight);
+
+  if (status.customClearColor) {
+    GL->glClearColor(status.clearColor.r,
+                     status.clearColor.g,
+                     status.clearColor.b,
+                     status.clearColor.a);
+  } else {
+    GL->glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  }
+  GL->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // drawn ahead of the queue, so that opaque objects depth test against the
+  // screen and translucent ones blend over it. `proceduralScreen` only picks
+  // how its surface is generated
+  if (screenVisible) {
+    UploadFrameUniforms(ScreenFrameBlock, screenModelView);
+    m_Screen->Draw(GL, *m_Shader, screenTransform, m_RenderWidth, m_RenderHeight);
+  }
+
+  UploadFrameUniforms(SceneFrameBlock, modelView);
+  m_RenderQueue.Clear();
+  if (m_Model) {
+    m_Model->Submit(&m_RenderQueue, modelView);
+  }
+  m_RenderQueue.Sort();
+  m_RenderQueue.Execute(GL, *m_Shader, modelView);
+
+  // resolve into the back render target
+  GLRenderTarget *target = &m_Targets[m_BackIndex];
+  PrepareRenderTarget(target);
+  target->frameStart = frameStart;
+  if (m_FXAA) {
+    DrawFXAA(target);
+  } else {
+    bool scaled = m_RenderWidth != m_Width || m_RenderHeight != m_Height;
+    cw::BindFramebuffer(GL, GL_READ_FRAMEBUFFER, m_SceneFBO);
+    if (scaled && m_Samples > 0) {
+      // multisampled buffers only resolve at their own size
+      cw::BindFramebuffer(GL, GL_DRAW_FRAMEBUFFER, m_ResolveFBO);
+      GL->glBlitFramebuffer(0, 0, m_RenderWidth, m_RenderHeight,
+                            0, 0, m_RenderWidth, m_RenderHeight,
+                            GL_COLOR_BUFFER_BIT,
+                            GL_NEAREST);
+      cw::BindFramebuffer(GL, GL_READ_FRAMEBUFFER, m_ResolveFBO);
+    }
+    cw::BindFramebuffer(GL, GL_DRAW_FRAMEBUFFER, target->fbo);
+    // bilinear is all the upscale gets, it has to stay cheaper than what
+    // lowering the resolution saved
+    GL->glBlitFramebuffer(0, 0, m_RenderWidth, m_RenderHeight,
+                          0, 0, m_Width, m_Height,
+                          GL_COLOR_BUFFER_BIT,
+                          scaled ? GL_LINEAR : GL_NEAREST);
+  }
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, 0);
+
+  cw::GLStateCache::Counters counters = m_StateCache.TakeCounters();
+  m_StateCallsIssued.store(counters.issued, std::memory_order_relaxed);
+  m_StateCallsElided.store(counters.elided, std::memory_order_relaxed);
+
+  if (m_PresentWindow) {
+    // same context reads the target right away, no hand-over needed. The
+    // blit to the window is part of this path's GPU time, so the query is
+    // ended there
+    PresentDirectly(target, queryStarted);
+    return;
+  }
+
+  // the composition done by `GLWindow` runs in another context and isn't
+  // covered by the query
+  if (queryStarted) {
+    GL->glEndQuery(GL_TIME_ELAPSED);
+    m_PerformanceCounterPending = true;
+  }
+
+  // the presenter waits on this fence from its own context, so it must be
+  // flushed before handing over
+  target->writeFence = GL->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  GL->glFlush();
+
+  {
+    QMutexLocker locker(&m_TargetMutex);
+    std::swap(m_BackIndex, m_ReadyIndex);
+    m_ReadyFresh = true;
+  }
+  emit FrameReady();
+}
+
+bool GLRenderer::ShouldRenderFrame() {
+  // the frame timer only polls here, so tracking samples arriving faster than
+  // the frame rate simply replace each other, only the latest one gets drawn
+  bool statusChanged = m_RenderStatus->Update();
+  bool headChanged = m_HeadStatus->Update();
+  bool volumeChanged = m_VolumeLevels->Update()
+                       && m_RenderStatus->Read().screenDisplayMode
+                          == wgc0310::ScreenDisplayMode::SoundWave;
+  if (volumeChanged) {
+    m_ScreenContentDirty = true;
+  }
+
+  // a playing animation advances the frame counter every tick, which alone
+  // is only worth a frame if the animation drew something new
+  RenderStatus const& status = m_RenderStatus->Read();
+  bool screenChanged = UpdateScreenContent(status);
+  if (statusChanged) {
+    m_RenderedStatus.screenAnimationFrame = status.screenAnimationFrame;
+    statusChanged = status != m_RenderedStatus;
+  }
+
+  bool keepAlive = false;
+  int keepAliveFrameRate = cw::GlobalConfig::Instance.keepAliveFrameRate;
+  if (keepAliveFrameRate > 0) {
+    keepAlive = m_SinceLastFrame.elapsed() >= 1000 / keepAliveFrameRate;
+  }
+
+  if (!(m_FrameRequested
+        || statusChanged
+        || headChanged
+        || volumeChanged
+        || screenChanged
+        || keepAlive)) {
+    return false;
+  }
+
+  // recorded for every frame, `ForgetScreenAnimation` may have picked up a
+  // status without it counting as changed here
+  m_RenderedStatus = status;
+  m_FrameRequested = false;
+  m_SinceLastFrame.restart();
+  return true;
+}
+
+void GLRenderer::PresentDirectly(GLRenderTarget const* target, bool queryStarted) {
+  // queries belong to the context, not to the surface it's current on
+  auto endQuery = [this, queryStarted] {
+    if (queryStarted) {
+      GL->glEndQuery(GL_TIME_ELAPSED);
+      m_PerformanceCounterPending = true;
+    }
+  };
+
+  if (!m_Context->makeCurrent(m_PresentWindow)) {
+    qWarning() << "GLRenderer::PresentDirectly(GLRenderTarget const*, bool):"
+               << "failed making OpenGL context current on output window";
+    m_Context->makeCurrent(m_Surface);
+    endQuery();
+    return;
+  }
+
+  cw::BindFramebuffer(GL, GL_READ_FRAMEBUFFER, target->fbo);
+  cw::BindFramebuffer(GL, GL_DRAW_FRAMEBUFFER, m_Context->defaultFramebufferObject());
+  GL->glBlitFramebuffer(0, 0, target->width, target->height,
+                        0, 0, target->width, target->height,
+                        GL_COLOR_BUFFER_BIT,
+                        GL_NEAREST);
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, 0);
+  // ended before the swap, which may wait for vsync
+  endQuery();
+  m_Context->swapBuffers(m_PresentWindow);
+
+  ReportPresented(target);
+  m_Context->makeCurrent(m_Surface);
+}
+
+void GLRenderer::PrepareRenderTarget(GLRenderTarget *target) {
+  if (target->writeFence) {
+    // this frame got replaced by a newer one before being presented
+    GL->glDeleteSync(target->writeFence);
+    target->writeFence = nullptr;
+  }
+
+  if (target->readFence) {
+    GL->glWaitSync(target->readFence, 0, GL_TIMEOUT_IGNORED);
+    GL->glDeleteSync(target->readFence);
+    target->readFence = nullptr;
+  }
+
+  if (target->texture == 0) {
+    GL->glGenTextures(1, &target->texture);
+    cw::BindTexture2D(GL, target->texture);
+    GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+
+  if (target->width != m_Width || target->height != m_Height) {
+    cw::BindTexture2D(GL, target->texture);
+    GL->glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_RGBA8,
+                     m_Width,
+                     m_Height,
+                     0,
+                     GL_RGBA,
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+    target->width = m_Width;
+    target->height = m_Height;
+  }
+
+  if (target->fbo == 0) {
+    GL->glGenFramebuffers(1, &target->fbo);
+    cw::BindFramebuffer(GL, GL_FRAMEBUFFER, target->fbo);
+    GL->glFramebufferTexture2D(GL_FRAMEBUFFER,
+                               GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D,
+                               target->texture,
+                               0);
+  }
+}
+
+void GLRenderer::ApplyQualityDecision() {
+  QualityGovernor::Decision decision = m_QualityGovernor->GetDecision();
+  m_Samples = decision.samples;
+  m_SceneBufferDirty = true;
+  m_FrameRequested = true;
+
+  m_QualityScale.store(decision.scale, std::memory_order_relaxed);
+  m_QualitySamples.store(decision.samples, std::memory_order_relaxed);
+}
+
+void GLRenderer::SetupAntiAliasing(bool fxaa) {
+  // FXAA replaces multisampling rather than adding to it
+  m_FXAA = fxaa;
+  m_Samples = fxaa ? 0 : m_ConfiguredSamples;
+  if (m_Samples > 0) {
+    GL->glEnable(GL_MULTISAMPLE);
+  } else {
+    GL->glDisable(GL_MULTISAMPLE);
+  }
+  if (fxaa && m_PostVAO == 0) {
+    GL->glGenVertexArrays(1, &m_PostVAO);
+  }
+  m_SceneBufferDirty = true;
+
+  // the governor's ladder starts from the sample count, so it starts over
+  m_QualityScale.store(1.0f, std::memory_order_relaxed);
+  m_QualitySamples.store(m_Samples, std::memory_order_relaxed);
+  m_QualityFXAA.store(fxaa, std::memory_order_relaxed);
+  if (cw::GlobalConfig::Instance.dynamicQuality) {
+    // leaves a quarter of the tick to the CPU side and the presenter
+    m_QualityGovernor = std::make_unique<QualityGovernor>(
+      static_cast<GLuint64>(1'000'000'000 / FrameRate * 3 / 4),
+      m_Samples
+    );
+  }
+}
+
+void GLRenderer::DrawFXAA(GLRenderTarget const* target) {
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, target->fbo);
+  GL->glViewport(0, 0, m_Width, m_Height);
+  // overwrites every pixel, alpha included. Whatever the scene passes left
+  // is put back afterwards, answered by the state cache without a round trip
+  bool depthTest = cw::IsCapabilityEnabled(GL, GL_DEPTH_TEST);
+  bool blend = cw::IsCapabilityEnabled(GL, GL_BLEND);
+  cw::SetCapability(GL, GL_DEPTH_TEST, false);
+  cw::SetCapability(GL, GL_BLEND, false);
+
+  m_Shader->fxaaShader.UseProgram(GL);
+  cw::ActiveTexture(GL, GL_TEXTURE0);
+  cw::BindTexture2D(GL, m_SceneColorTexture);
+  cw::ShaderProgram::SetUniform(GL, m_Shader->fxaaUniforms.sceneTexture, 0);
+  cw::ShaderProgram::SetUniform(GL, m_Shader->fxaaUniforms.sceneTexelSize, glm::vec2 {
+    1.0f / static_cast<float>(m_RenderWidth),
+    1.0f / static_cast<float>(m_RenderHeight)
+  });
+  cw::BindVertexArray(GL, m_PostVAO);
+  GL->glDrawArrays(GL_TRIANGLES, 0, 3);
+
+  cw::SetCapability(GL, GL_BLEND, blend);
+  cw::SetCapability(GL, GL_DEPTH_TEST, depthTest);
+}
+
+void GLRenderer::ReallocateSceneBuffer() {
+  float scale = m_QualityScale.load(std::memory_order_relaxed);
+  m_RenderWidth = std::max(static_cast<GLsizei>(static_cast<float>(m_Width) * scale), 1);
+  m_RenderHeight = std::max(static_cast<GLsizei>(static_cast<float>(m_Height) * scale), 1);
+
+  if (m_SceneFBO == 0) {
+    GL->glGenFramebuffers(1, &m_SceneFBO);
+    GL->glGenRenderbuffers(1, &m_SceneDepthBuffer);
+  }
+
+  // only the color buffer of the current mode is kept, the other one is
+  // released when anti-aliasing gets switched
+  if (m_FXAA) {
+    if (m_SceneColorBuffer) {
+      GL->glDeleteRenderbuffers(1, &m_SceneColorBuffer);
+      m_SceneColorBuffer = 0;
+    }
+    if (m_SceneColorTexture == 0) {
+      GL->glGenTextures(1, &m_SceneColorTexture);
+      cw::BindTexture2D(GL, m_SceneColorTexture);
+      // FXAA samples between pixels, and upscales while at it
+      GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      GL->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    cw::BindTexture2D(GL, m_SceneColorTexture);
+    GL->glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_RGBA8,
+                     m_RenderWidth,
+                     m_RenderHeight,
+                     0,
+                     GL_RGBA,
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+  } else {
+    if (m_SceneColorTexture) {
+      m_StateCache.ForgetTexture(m_SceneColorTexture);
+      GL->glDeleteTextures(1, &m_SceneColorTexture);
+      m_SceneColorTexture = 0;
+    }
+    if (m_SceneColorBuffer == 0) {
+      GL->glGenRenderbuffers(1, &m_SceneColorBuffer);
+    }
+    GL->glBindRenderbuffer(GL_RENDERBUFFER, m_SceneColorBuffer);
+    if (m_Samples > 0) {
+      GL->glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_RGBA8, m_RenderWidth, m_RenderHeight);
+    } else {
+      GL->glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_RenderWidth, m_RenderHeight);
+    }
+  }
+
+  GL->glBindRenderbuffer(GL_RENDERBUFFER, m_SceneDepthBuffer);
+  if (m_Samples > 0) {
+    GL->glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_DEPTH_COMPONENT24, m_RenderWidth, m_RenderHeight);
+  } else {
+    GL->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_RenderWidth, m_RenderHeight);
+  }
+  GL->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, m_SceneFBO);
+  if (m_FXAA) {
+    GL->glFramebufferTexture2D(GL_FRAMEBUFFER,
+                               GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D,
+                               m_SceneColorTexture,
+                               0);
+  } else {
+    GL->glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                  GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER,
+                                  m_SceneColorBuffer);
+  }
+  GL->glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                GL_DEPTH_ATTACHMENT,
+                                GL_RENDERBUFFER,
+                                m_SceneDepthBuffer);
+  if (GL->glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    qCritical() << "GLRenderer::ReallocateSceneBuffer():"
+                << "failed creating scene framebuffer";
+    std::abort();
+  }
+
+  if (m_Samples > 0 && (m_RenderWidth != m_Width || m_RenderHeight != m_Height)) {
+    if (m_ResolveFBO == 0) {
+      GL->glGenFramebuffers(1, &m_ResolveFBO);
+      GL->glGenRenderbuffers(1, &m_ResolveColorBuffer);
+    }
+
+    GL->glBindRenderbuffer(GL_RENDERBUFFER, m_ResolveColorBuffer);
+    GL->glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_RenderWidth, m_RenderHeight);
+    GL->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    cw::BindFramebuffer(GL, GL_FRAMEBUFFER, m_ResolveFBO);
+    GL->glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                  GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER,
+                                  m_ResolveColorBuffer);
+    if (GL->glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      qCritical() << "GLRenderer::ReallocateSceneBuffer():"
+                  << "failed creating resolve framebuffer";
+      std::abort();
+    }
+  }
+  cw::BindFramebuffer(GL, GL_FRAMEBUFFER, 0);
+
+  m_SceneBufferDirty = false;
+}
+
+void GLRenderer::UpdateProjection() {
+  m_Projection = glm::perspective<float>(
+    glm::radians(45.0f),
+    static_cast<float>(m_Width) / static_cast<float>(m_Height),
+    0.1f,
+    100.0f
+  );
+
+  if (!m_Shader) {
+    return;
+  }
+
+  // programs using the frame block get the projection with every frame,
+  // only those with plain uniforms need to be updated here
+  std::pair<cw::ShaderProgram*, cw::ObjectShaderInterface*> programs[] = {
+    { &m_Shader->emissiveShader, &m_Shader->emissiveUniforms },
+    { &m_Shader->translucentShader, &m_Shader->translucentUniforms },
+    { &m_Shader->opaqueShader, &m_Shader->opaqueUniforms }
+  };
+  for (auto [program, uniforms] : programs) {
+    if (uniforms->projection.IsResolved()) {
+      program->UseProgram(GL);
+      cw::ShaderProgram::SetUniform(GL, uniforms->projection, m_Projection);
+    }
+  }
+}
+
+void GLRenderer::UploadFrameUniforms(std::size_t index, glm::mat4 const& modelView) {
+  // the camera sits at the origin, and so do the lights for now
+  cw::FrameBlock block {
+    .projection = m_Projection,
+    .modelView = modelView,
+    .viewPos = glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f },
+    .light0Pos = glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f },
+    .light1Pos = glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f }
+  };
+  // frames redrawn for the screen alone keep the same camera and model, the
+  // buffer still holds what they need. The block has no padding to compare
+  std::optional<cw::FrameBlock> &uploaded = m_UploadedFrameBlocks[index];
+  if (!uploaded || std::memcmp(&*uploaded, &block, sizeof(block)) != 0) {
+    m_FrameUniforms->BufferSubData(GL, block, index);
+    uploaded = block;
+  }
+  m_FrameUniforms->BindRange(GL, cw::FrameBlockBinding, index);
+}
+
+bool GLRenderer::UpdateScreenContent(RenderStatus const& status) {
+  bool changed = false;
+  if (status.screenAnimation != m_ScreenAnimation) {
+    m_ScreenAnimation = status.screenAnimation;
+    m_ScreenAnimationFrame = status.screenAnimationFrame;
+    if (m_ScreenAnimation) {
+      m_ScreenAnimation->Rewind();
+    }
+    changed = true;
+  } else if (m_ScreenAnimation) {
+    // ticked even while the screen cannot be seen, so that the animation
+    // keeps its pace. Every tick is run, an animation may only report a
+    // change in one of them
+    for (; m_ScreenAnimationFrame < status.screenAnimationFrame; m_ScreenAnimationFrame++) {
+      if (m_ScreenAnimation->NextTick()) {
+        changed = true;
+      }
+    }
+  }
+
+  ScreenContentKey content {
+    .staticScreenId = status.staticScreen ? status.staticScreen->id : 0,
+    .displayMode = status.screenDisplayMode
+  };
+  if (status.screenDisplayMode == wgc0310::ScreenDisplayMode::CapturedExpression) {
+    wgc0310::HeadStatus const& head = m_HeadStatus->Read();
+    content.leftEye = head.leftEye;
+    content.rightEye = head.rightEye;
+    content.mouthStatus = head.mouthStatus;
+  }
+  if (content != m_ScreenContent) {
+    m_ScreenContent = content;
+    changed = true;
+  }
+  if (changed) {
+    m_ScreenContentDirty = true;
+  }
+  return changed;
+}
+
+glm::mat4 GLRenderer::ScreenModelView(glm::mat4 const& modelView) const {
+  // the screen turns with the head
+  wgc0310::HeadStatus const& head = m_HeadStatus->Read();
+  glm::mat4 screenModelView = glm::rotate(modelView,
+                                          glm::radians(head.rotationY),
+                                          glm::vec3(0.0f, 1.0f, 0.0f));
+  screenModelView = glm::rotate(screenModelView,
+                                glm::radians(head.rotationX),
+                                glm::vec3(1.0f, 0.0f, 0.0f));
+  screenModelView = glm::rotate(screenModelView,
+                                glm::radians(head.rotationZ),
+                                glm::vec3(0.0f, 0.0f, 1.0f));
+  return screenModelView;
+}
+
+bool GLRenderer::DrawScreenContent(RenderStatus const& status) {
+  GL->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  GL->glClear(GL_COLOR_BUFFER_BIT);
+
+  if (status.staticScreen) {
+    GLint layer = m_ScreenImages->Use(status.staticScreen->id);
+    if (layer < 0) {
+      // shown on the frame after it finished uploading, which `Update` may
+      // spread over several frames. Only an image that failed loading is
+      // final, it stays blank
+      LoadScreenImage(*status.staticScreen);
+      return m_ScreenImages->HasFailed(status.staticScreen->id);
+    }
+
+    // switching images is nothing more than another layer index
+    m_ScreenImages->Draw(GL,
+                         m_Shader->screenImageShader,
+                         m_Shader->screenImageUniforms,
+                         layer);
+  } else if (m_ScreenAnimation) {
+    m_ScreenAnimation->Draw(GL, wgc0310::WGAPIScreenViewport {
+      .width = m_Screen->GetWidth(),
+      .height = m_Screen->GetHeight(),
+      .scale = m_Screen->GetScale()
+    });
+    // plugins do not know about the state cache
+    m_StateCache.Invalidate();
+  }
+  return true;
+}
+
+void GLRenderer::LoadScreenImage(wgc0310::StaticScreenImage const& image) {
+  if (m_ScreenImages->IsKnown(image.id)) {
+    return;
+  }
+
+  std::uint64_t imageId = image.id;
+  m_ScreenImages->MarkLoading(imageId);
+  m_AssetStreamer.RequestImage(
+    image.filePath,
+    QSize(wgc0310::ScreenWidth, wgc0310::ScreenHeight),
+    [this, imageId](GLFunctions *f, QImage &&decoded) {
+      if (decoded.isNull()) {
+        emit ScreenImageLoadFailed(imageId);
+      }
+      m_ScreenImages->AddImage(f, imageId, decoded);
+    }
+  );
+}
@@ -0,0 +1,80 @@
+#include "ui_next/QualityGovernor.h"
+
+#include <iterator>
+
+static constexpr float Scales[] = { 0.875f, 0.75f, 0.625f, 0.5f };
+
+// weight of the latest sample in the running average
+static constexpr double Smoothing = 0.2;
+// stepping down is urgent, frames are already being missed
+static constexpr int StepDownAfter = 5;
+// stepping up is not, and should not push the frame time right back over
+// the target
+static constexpr int StepUpAfter = 60;
+static constexpr double StepUpHeadroom = 0.6;
+
+QualityGovernor::QualityGovernor(GLuint64 targetTime, GLsizei maxSamples)
+  : m_Step(0),
+    m_TargetTime(targetTime),
+    m_AverageTime(0.0),
+    m_SlowSamples(0),
+    m_FastSamples(0)
+{
+  GLsizei samples = maxSamples;
+  m_Ladder.push_back(Decision { .scale = 1.0f, .samples = samples });
+  while (samples > 2) {
+    samples /= 2;
+    m_Ladder.push_back(Decision { .scale = 1.0f, .samples = samples });
+  }
+  for (float scale : Scales) {
+    m_Ladder.push_back(Decision { .scale = scale, .samples = samples });
+  }
+  if (samples > 0) {
+    m_Ladder.push_back(Decision { .scale = Scales[std::size(Scales) - 1], .samples = 0 });
+  }
+}
+
+bool QualityGovernor::AddSample(GLuint64 gpuTime) noexcept {
+  double time = static_cast<double>(gpuTime);
+  if (m_AverageTime == 0.0) {
+    m_AverageTime = time;
+  } else {
+    m_AverageTime += (time - m_AverageTime) * Smoothing;
+  }
+
+  double target = static_cast<double>(m_TargetTime);
+  if (m_AverageTime > target) {
+    m_FastSamples = 0;
+    if (++m_SlowSamples >= StepDownAfter && m_Step + 1 < m_Ladder.size()) {
+      m_Step += 1;
+      ResetAverage();
+      return true;
+    }
+  } else if (m_AverageTime < target * StepUpHeadroom) {
+    m_SlowSamples = 0;
+    if (++m_FastSamples >= StepUpAfter && m_Step > 0) {
+      m_Step -= 1;
+      ResetAverage();
+      return true;
+    }
+  } else {
+    m_SlowSamples = 0;
+    m_FastSamples = 0;
+  }
+  return false;
+}
+
+QualityGovernor::Decision QualityGovernor::GetDecision() const noexcept {
+  return m_Ladder[m_Step];
+}
+
+GLuint64 QualityGovernor::GetTargetTime() const noexcept {
+  return m_TargetTime;
+}
+
+void QualityGovernor::ResetAverage() noexcept {
+  // frame times from before the change say nothing about the new cost
+  m_AverageTime = 0.0;
+  m_SlowSamples = 0;
+  m_FastSamples = 0;
+}
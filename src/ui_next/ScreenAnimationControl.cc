@@ -1,6 +1,7 @@
 #include "ui_next/ScreenAnimationControl.h"
 
 #include <QDir>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QPushButton>
@@ -9,20 +10,22 @@
 #include <QLabel>
 
 #include "GlobalConfig.h"
-#include "cwglx/Base/Texture.h"
 #include "wgc0310/ScreenAnimationStatus.h"
-#include "ui_next/GLWindow.h"
+#include "ui_next/ExtraControl.h"
+#include "ui_next/GLRenderer.h"
 #include "util/DynLoad.h"
 
-ScreenAnimationControl::ScreenAnimationControl(GLWindow *glWindow,
+ScreenAnimationControl::ScreenAnimationControl(GLRenderer *renderer,
                                                wgc0310::ScreenAnimationStatus *animationStatus,
                                                wgc0310::ScreenDisplayMode *screenDisplayMode,
                                                StatusExtra *statusExtra)
   : CloseSignallingWidget(nullptr, Qt::Window),
-    m_GLWindow(glWindow),
+    m_Renderer(renderer),
     m_ScreenAnimationStatus(animationStatus),
     m_ScreenDisplayMode(screenDisplayMode),
     m_StatusExtra(statusExtra),
+    m_NextStaticImageId(1),
+    m_AnimationUseClock(0),
     m_StaticImageButtonsLayout(new QHBoxLayout()),
     m_StaticImageButtonsLayoutV(new QVBoxLayout()),
     m_ScreenAnimationButtonsLayout(new QHBoxLayout()),
@@ -30,10 +33,14 @@ ScreenAnimationControl::ScreenAnimationControl(GLWindow *glWindow,
   setWindowTitle("屏幕画面");
   setMinimumWidth(600);
 
-  connect(m_GLWindow,
-          &GLWindow::OpenGLInitialized,
+  connect(m_Renderer,
+          &GLRenderer::OpenGLInitialized,
           this,
           &ScreenAnimationControl::GLContextReady);
+  connect(m_Renderer,
+          &GLRenderer::ScreenImageLoadFailed,
+          this,
+          &ScreenAnimationControl::StaticImageLoadFailed);
 
   QVBoxLayout *mainLayout = new QVBoxLayout();
   this->setLayout(mainLayout);
@@ -89,9 +96,7 @@ ScreenAnimationControl::ScreenAnimationControl(GLWindow *glWindow,
     } else {
       m_PlayingCapturedExpression->setChecked(true);
     }
-    m_GLWindow->RunWithGLContext([this] {
-      this->ReloadStaticImages();
-    });
+    this->ReloadStaticImages();
   };
 
   QGroupBox *staticImageMinimized = new QGroupBox("静态图像");
@@ -147,9 +152,7 @@ ScreenAnimationControl::ScreenAnimationControl(GLWindow *glWindow,
     } else {
       m_PlayingCapturedExpression->setChecked(true);
     }
-    m_GLWindow->RunWithGLContext([this] {
-      this->ReloadScreenAnimations();
-    });
+    this->ReloadScreenAnimations();
   };
 
   QGroupBox *animationMinimized = new QGroupBox("动画");
@@ -237,9 +240,12 @@ static void ClearLayout(QLayout *layout) {
 }
 
 void ScreenAnimationControl::ReloadStaticImages() {
+  std::vector<std::uint64_t> released;
+  released.reserve(m_StaticImages.size());
   for (const auto &image : m_StaticImages) {
-    image.texture->Delete(m_GLWindow->GL);
+    released.push_back(image->id);
   }
+  m_Renderer->ReleaseScreenImages(std::move(released));
   m_StaticImages.clear();
 
   QDir dir(QStringLiteral("animations/static"));
@@ -247,68 +253,77 @@ void ScreenAnimationControl::ReloadStaticImages() {
   filters << QStringLiteral("*.bmp")
           << QStringLiteral("*.png");
 
+  // only registered here, the renderer loads each image when it's first shown
   QStringList files = dir.entryList(filters, QDir::Files);
   for (const auto &file : files) {
-    QString fileName = QStringLiteral("animations/static/") + file;
+    m_StaticImages.push_back(std::make_shared<wgc0310::StaticScreenImage const>(
+      wgc0310::StaticScreenImage {
+        .id = m_NextStaticImageId++,
+        .imageName = file,
+        .filePath = QStringLiteral("animations/static/") + file
+      }
+    ));
+  }
 
-    QImage image;
-    image.load(fileName);
-    if (image.isNull()) {
+  RebuildStaticImageButtons();
+}
+
+void ScreenAnimationControl::StaticImageLoadFailed(quint64 imageId) {
+  for (const auto &image : m_StaticImages) {
+    if (image->id == imageId) {
       QMessageBox::warning(
         this,
         "警告",
-        QString("加载图片文件 %1 失败，该图片将不可用\n")
-          .arg(fileName));
-      continue;
+        QString("加载图片文件 %1 失败，该图片将不可用\n").arg(image->filePath));
+      return;
     }
-
-    auto texture = std::make_unique<cw::Texture2D>(
-      image,
-      m_GLWindow->GL,
-      cw::GlobalConfig::Instance.linearSampling,
-      cw::GlobalConfig::Instance.anisotropyFilter
-    );
-    m_StaticImages.push_back(wgc0310::StaticScreenImage {
-      .imageName = file,
-      .texture = std::move(texture)
-    });
   }
+}
 
+void ScreenAnimationControl::RebuildStaticImageButtons() {
   ClearLayout(m_StaticImageButtonsLayout);
   ClearLayout(m_StaticImageButtonsLayoutV);
-  {
-    int i = 0;
-    for (auto &image: m_StaticImages) {
-      wgc0310::StaticScreenImage *imagePtr = &image;
-
-      QPushButton *hButton = new QPushButton(QString::number(i));
-      hButton->setFixedWidth(32);
-      hButton->setToolTip(image.imageName);
-      QPushButton *vButton = new QPushButton(image.imageName);
-
-      auto clickHandler = [this, imagePtr] {
-        m_PlayingStaticImage->setChecked(true);
-        m_ScreenAnimationStatus->PlayStaticAnimation(imagePtr);
-      };
-
-      connect(hButton, &QPushButton::clicked, hButton, clickHandler);
-      connect(vButton, &QPushButton::clicked, vButton, clickHandler);
-      m_StaticImageButtonsLayout->addWidget(hButton);
-      m_StaticImageButtonsLayoutV->addWidget(vButton);
-      i += 1;
-    }
+  for (std::size_t i = 0; i < m_StaticImages.size(); i++) {
+    wgc0310::StaticScreenImage const& image = *m_StaticImages[i];
+
+    QPushButton *hButton = new QPushButton(QString::number(i));
+    hButton->setFixedWidth(32);
+    hButton->setToolTip(image.imageName);
+    QPushButton *vButton = new QPushButton(image.imageName);
+
+    auto clickHandler = [this, i] {
+      m_PlayingStaticImage->setChecked(true);
+      m_ScreenAnimationStatus->PlayStaticAnimation(m_StaticImages[i]);
+
+      // images tend to be stepped through one after another
+      std::vector<std::shared_ptr<wgc0310::StaticScreenImage const>> neighbours;
+      if (i > 0) {
+        neighbours.push_back(m_StaticImages[i - 1]);
+      }
+      if (i + 1 < m_StaticImages.size()) {
+        neighbours.push_back(m_StaticImages[i + 1]);
+      }
+      m_Renderer->PrefetchScreenImages(std::move(neighbours));
+    };
+
+    connect(hButton, &QPushButton::clicked, hButton, clickHandler);
+    connect(vButton, &QPushButton::clicked, vButton, clickHandler);
+    m_StaticImageButtonsLayout->addWidget(hButton);
+    m_StaticImageButtonsLayoutV->addWidget(vButton);
   }
 }
 
 void ScreenAnimationControl::ReloadScreenAnimations() {
-  for (const auto &animation : m_ScreenAnimations) {
-    animation->Delete(m_GLWindow->GL);
+  if (m_ScreenAnimationStatus->animation) {
+    m_ScreenAnimationStatus->Reset();
   }
-  m_ScreenAnimations.clear();
-  for (const auto &sharedObject : m_SharedObjects) {
-    cw::DetachSharedObject(sharedObject);
+  for (auto &entry : m_ScreenAnimations) {
+    if (!UnloadScreenAnimation(&entry)) {
+      // leaked rather than unloaded under the render thread
+      static_cast<void>(entry.animation.release());
+    }
   }
-  m_SharedObjects.clear();
+  m_ScreenAnimations.clear();
 
   QDir dir(QStringLiteral("animations/dynamic"));
   QStringList filters;
@@ -318,106 +333,185 @@ void ScreenAnimationControl::ReloadScreenAnimations() {
     filters << "*.so";
   #endif
 
+  // only registered here, shared objects are opened when first played
   QStringList files = dir.entryList(filters, QDir::Files);
   for (const auto &file : files) {
-    QString filePath = QStringLiteral("animations/dynamic/") + file;
-    void *sharedObject = cw::LoadSharedObject(filePath);
-    if (!sharedObject) {
-      QMessageBox::warning(
-        this,
-        "动画加载错误",
-        QString("无法打开共享对象 %1").arg(filePath)
-      );
-      continue;
-    }
+    m_ScreenAnimations.push_back(ScreenAnimationEntry {
+      .fileName = file
+    });
+  }
+
+  ClearLayout(m_ScreenAnimationButtonsLayout);
+  ClearLayout(m_ScreenAnimationButtonsLayoutV);
+  for (std::size_t i = 0; i < m_ScreenAnimations.size(); i++) {
+    ScreenAnimationEntry &entry = m_ScreenAnimations[i];
+
+    // named after the file until the animation tells its own name
+    QString animationName = QFileInfo(entry.fileName).completeBaseName();
+    QPushButton *hButton = new QPushButton(QString::number(i));
+    hButton->setFixedWidth(32);
+    hButton->setToolTip(animationName);
+    QPushButton *vButton = new QPushButton(animationName);
+    entry.hButton = hButton;
+    entry.vButton = vButton;
+
+    auto clickHandler = [this, i] {
+      PlayScreenAnimation(i);
+    };
+
+    connect(hButton, &QPushButton::clicked, hButton, clickHandler);
+    connect(vButton, &QPushButton::clicked, vButton, clickHandler);
+    m_ScreenAnimationButtonsLayout->addWidget(hButton);
+    m_ScreenAnimationButtonsLayoutV->addWidget(vButton);
+  }
+}
 
-    wgc0310::CheckVersionFn checkVersionFn = cw::TryReadSymbol<wgc0310::CheckVersionFn>(
-      sharedObject,
-      "GetWGAPIVersion"
+void ScreenAnimationControl::PlayScreenAnimation(std::size_t index) {
+  ScreenAnimationEntry &entry = m_ScreenAnimations[index];
+  if (!entry.animation && !LoadScreenAnimation(&entry)) {
+    return;
+  }
+
+  entry.lastUse = ++m_AnimationUseClock;
+  m_PlayingDynamicAnimation->setChecked(true);
+  m_ScreenAnimationStatus->PlayAnimation(entry.animation.get());
+
+  EvictScreenAnimations();
+}
+
+bool ScreenAnimationControl::LoadScreenAnimation(ScreenAnimationEntry *entry) {
+  QString filePath = QStringLiteral("animations/dynamic/") + entry->fileName;
+  void *sharedObject = cw::LoadSharedObject(filePath);
+  if (!sharedObject) {
+    QMessageBox::warning(
+      this,
+      "动画加载错误",
+      QString("无法打开共享对象 %1").arg(filePath)
     );
-    if (!checkVersionFn) {
-      QMessageBox::warning(
-        this,
-        "动画加载错误",
-        QString("无法在共享对象 %1 上定位 <code>GetWGAPIVersion</code>")
-          .arg(filePath)
-      );
-      cw::DetachSharedObject(sharedObject);
-      continue;
-    }
+    return false;
+  }
 
-    if (checkVersionFn() != WGAPI_VERSION) {
-      QMessageBox::warning(
-        this,
-        "动画加载错误",
-        QString("共享对象 %1 使用的 <code>WGAPI</code> 版本与 Project-WG 程序不匹配")
-          .arg(filePath)
-      );
-      cw::DetachSharedObject(sharedObject);
-      continue;
-    }
+  wgc0310::CheckVersionFn checkVersionFn = cw::TryReadSymbol<wgc0310::CheckVersionFn>(
+    sharedObject,
+    "GetWGAPIVersion"
+  );
+  if (!checkVersionFn) {
+    QMessageBox::warning(
+      this,
+      "动画加载错误",
+      QString("无法在共享对象 %1 上定位 <code>GetWGAPIVersion</code>")
+        .arg(filePath)
+    );
+    cw::DetachSharedObject(sharedObject);
+    return false;
+  }
 
-    wgc0310::LoadAnimationFn loadAnimationFn = cw::TryReadSymbol<wgc0310::LoadAnimationFn>(
-      sharedObject,
-      "LoadAnimation"
+  if (checkVersionFn() != WGAPI_VERSION) {
+    QMessageBox::warning(
+      this,
+      "动画加载错误",
+      QString("共享对象 %1 使用的 <code>WGAPI</code> 版本与 Project-WG 程序不匹配")
+        .arg(filePath)
     );
-    if (!loadAnimationFn) {
-      QMessageBox::warning(
-        this,
-        "动画加载错误",
-        QString("无法在共享对象 %1 上定位 <code>LoadAnimation</code>")
-          .arg(filePath)
-      );
-      cw::DetachSharedObject(sharedObject);
-      continue;
-    }
+    cw::DetachSharedObject(sharedObject);
+    return false;
+  }
 
-    wgc0310::WGAPIAnimation *animation = loadAnimationFn();
-    if (!animation) {
-      QMessageBox::warning(
-        this,
-        "动画加载错误",
-        QString("共享对象 %1 的 <code>LoadAnimation</code> 返回了 <code>nullptr</code>")
-          .arg(filePath)
-      );
-      cw::DetachSharedObject(sharedObject);
-      continue;
-    }
+  wgc0310::LoadAnimationFn loadAnimationFn = cw::TryReadSymbol<wgc0310::LoadAnimationFn>(
+    sharedObject,
+    "LoadAnimation"
+  );
+  if (!loadAnimationFn) {
+    QMessageBox::warning(
+      this,
+      "动画加载错误",
+      QString("无法在共享对象 %1 上定位 <code>LoadAnimation</code>")
+        .arg(filePath)
+    );
+    cw::DetachSharedObject(sharedObject);
+    return false;
+  }
 
-    animation->Initialize(m_GLWindow->GL);
+  wgc0310::WGAPIAnimation *animation = loadAnimationFn();
+  if (!animation) {
+    QMessageBox::warning(
+      this,
+      "动画加载错误",
+      QString("共享对象 %1 的 <code>LoadAnimation</code> 返回了 <code>nullptr</code>")
+        .arg(filePath)
+    );
+    cw::DetachSharedObject(sharedObject);
+    return false;
+  }
+
+  m_Renderer->RunWithGLContext([this, animation] {
+    animation->Initialize(m_Renderer->GL);
+  });
+
+  entry->animation.reset(animation);
+  entry->sharedObject = sharedObject;
 
-    m_ScreenAnimations.emplace_back(animation);
-    m_SharedObjects.push_back(sharedObject);
+  QString animationName(animation->GetName());
+  entry->hButton->setToolTip(animationName);
+  entry->vButton->setText(animationName);
+
+  QWidget *controlWidget = animation->GetControlWidget();
+  if (controlWidget) {
+    connect(this, &CloseSignallingWidget::AboutToClose, controlWidget, &QWidget::close);
+  }
+  return true;
+}
+
+bool ScreenAnimationControl::UnloadScreenAnimation(ScreenAnimationEntry *entry) {
+  if (!entry->animation) {
+    return true;
+  }
 
-    QWidget *controlWidget = animation->GetControlWidget();
-    if (controlWidget) {
-      connect(this, &CloseSignallingWidget::AboutToClose, controlWidget, &QWidget::close);
+  // the render thread keeps playing the status published last, which may
+  // still refer to this animation
+  emit ScreenAnimationChanged();
+  bool released = false;
+  m_Renderer->RunWithGLContext([this, entry, &released] {
+    released = m_Renderer->ForgetScreenAnimation(entry->animation.get());
+    if (released) {
+      entry->animation->Delete(m_Renderer->GL);
     }
+  });
+  if (!released) {
+    return false;
   }
 
-  ClearLayout(m_ScreenAnimationButtonsLayout);
-  ClearLayout(m_ScreenAnimationButtonsLayoutV);
-  {
-    int i = 0;
-    for (auto &animation : m_ScreenAnimations) {
-      wgc0310::WGAPIAnimation *animationPtr = animation.get();
-
-      QPushButton *hButton = new QPushButton(QString::number(i));
-      hButton->setFixedWidth(32);
-      QString animationName(animation->GetName());
-      hButton->setToolTip(animationName);
-      QPushButton *vButton = new QPushButton(animationName);
-
-      auto clickHandler = [this, animationPtr] {
-        m_PlayingDynamicAnimation->setChecked(true);
-        m_ScreenAnimationStatus->PlayAnimation(animationPtr);
-      };
-
-      connect(hButton, &QPushButton::clicked, hButton, clickHandler);
-      connect(vButton, &QPushButton::clicked, vButton, clickHandler);
-      m_ScreenAnimationButtonsLayout->addWidget(hButton);
-      m_ScreenAnimationButtonsLayoutV->addWidget(vButton);
-      i += 1;
+  // the animation's code lives in the shared object
+  entry->animation.reset();
+  cw::DetachSharedObject(entry->sharedObject);
+  entry->sharedObject = nullptr;
+  return true;
+}
+
+void ScreenAnimationControl::EvictScreenAnimations() {
+  std::size_t maxLoaded = static_cast<std::size_t>(
+    std::max(cw::GlobalConfig::Instance.maxLoadedAnimations, 1)
+  );
+
+  for (;;) {
+    std::size_t loaded = 0;
+    ScreenAnimationEntry *victim = nullptr;
+    for (auto &entry : m_ScreenAnimations) {
+      if (!entry.animation) {
+        continue;
+      }
+      loaded += 1;
+      if (entry.animation.get() == m_ScreenAnimationStatus->animation) {
+        continue;
+      }
+      if (!victim || entry.lastUse < victim->lastUse) {
+        victim = &entry;
+      }
+    }
+
+    // tried again with the next animation played
+    if (loaded <= maxLoaded || !victim || !UnloadScreenAnimation(victim)) {
+      return;
     }
   }
 }
@@ -11,16 +11,17 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include "wgc0310/Shader.h"
-#include "ui_next/GLWindow.h"
+#include "ui_next/GLRenderer.h"
 #include "ui_next/ShaderHighlighter.h"
 #include "util/FileUtil.h"
 #include "ui_next/CodeEdit.h"
 
-ShaderEdit::ShaderEdit(GLWindow *glWindow)
+ShaderEdit::ShaderEdit(GLRenderer *renderer)
   : m_ShaderText(wgc0310::GetDefaultShaderText()),
-    m_GLWindow(glWindow),
+    m_Renderer(renderer),
     m_ShaderPrevIndex(0),
-    m_ShaderSubPrevIndex(0)
+    m_ShaderSubPrevIndex(0),
+    m_CompileGeneration(0)
 {
   this->setWindowTitle("着色器编辑器");
 
@@ -114,15 +115,15 @@ ShaderEdit::ShaderEdit(GLWindow *glWindow)
   auto saveCurrentShaderCode = [=, this] () {
     if (m_ShaderPrevIndex == 0) {
       if (m_ShaderSubPrevIndex == 0) {
-        m_ShaderText.opaqueVS = codeEdit->toPlainText();
+        m_ShaderText.opaqueVS = codeEdit->toPlainText().toUtf8();
       } else {
-        m_ShaderText.opaqueFS = codeEdit->toPlainText();
+        m_ShaderText.opaqueFS = codeEdit->toPlainText().toUtf8();
       }
     } else {
       if (m_ShaderSubPrevIndex == 0) {
-        m_ShaderText.translucentVS = codeEdit->toPlainText();
+        m_ShaderText.translucentVS = codeEdit->toPlainText().toUtf8();
       } else {
-        m_ShaderText.translucentFS = codeEdit->toPlainText();
+        m_ShaderText.translucentFS = codeEdit->toPlainText().toUtf8();
       }
     }
   };
@@ -133,15 +134,15 @@ ShaderEdit::ShaderEdit(GLWindow *glWindow)
 
     if (shaderComboBox->currentIndex() == 0) {
       if (shaderSubComboBox->currentIndex() == 0) {
-        codeEdit->setPlainText(m_ShaderText.opaqueVS);
+        codeEdit->setPlainText(QString::fromUtf8(m_ShaderText.opaqueVS));
       } else {
-        codeEdit->setPlainText(m_ShaderText.opaqueFS);
+        codeEdit->setPlainText(QString::fromUtf8(m_ShaderText.opaqueFS));
       }
     } else {
       if (shaderSubComboBox->currentIndex() == 0) {
-        codeEdit->setPlainText(m_ShaderText.translucentVS);
+        codeEdit->setPlainText(QString::fromUtf8(m_ShaderText.translucentVS));
       } else {
-        codeEdit->setPlainText(m_ShaderText.translucentFS);
+        codeEdit->setPlainText(QString::fromUtf8(m_ShaderText.translucentFS));
       }
     }
   };
@@ -265,32 +266,43 @@ ShaderEdit::ShaderEdit(GLWindow *glWindow)
 
   connect(compileButton, &QPushButton::clicked, this, [=, this] {
     saveCurrentShaderCode();
-    m_GLWindow->RunWithGLContext([=, this] {
+    statusLabel->setText("编译中…");
+
+    // the current shaders keep rendering until the new ones are ready.
+    // Compilations finish in the order they were started, so only the
+    // latest one gets to report
+    std::uint64_t generation = ++m_CompileGeneration;
+    m_Renderer->CompileShaderAsync(
+      m_ShaderText,
+      this,
+      [=, this](bool success, QString const& errorMessage) {
+        if (generation != m_CompileGeneration) {
+          return;
+        }
+
+        if (!success) {
+          outputText->setPlainText(errorMessage);
+          outputText->setVisible(true);
+          statusLabel->setText("编译失败");
+        } else {
+          outputText->setVisible(false);
+          statusLabel->setText("编译成功");
+        }
+      }
+    );
+  });
+
+  connect(m_Renderer, &GLRenderer::OpenGLInitialized, this, [this] {
+    m_Renderer->RunWithGLContext([this] {
       QString errorMessage;
       std::unique_ptr<wgc0310::ShaderCollection> shader =
-        wgc0310::CompileShader(m_GLWindow->GL, m_ShaderText, &errorMessage);
-
+        wgc0310::CompileShader(m_Renderer->GL, m_ShaderText, &errorMessage);
       if (!shader) {
-        outputText->setPlainText(errorMessage);
-        outputText->setVisible(true);
-        statusLabel->setText("编译失败");
-      } else {
-        outputText->setVisible(false);
-        statusLabel->setText("编译成功");
-        m_GLWindow->SetShader(std::move(shader));
+        std::abort();
       }
-    });
-  });
 
-  connect(m_GLWindow, &GLWindow::OpenGLInitialized, this, [=, this] {
-    QString errorMessage;
-    std::unique_ptr<wgc0310::ShaderCollection> shader =
-      wgc0310::CompileShader(m_GLWindow->GL, m_ShaderText, &errorMessage);
-    if (!shader) {
-      std::abort();
-    }
-
-    m_GLWindow->SetShader(std::move(shader));
+      m_Renderer->SetShader(std::move(shader));
+    });
   });
 
   loadShaderCode();
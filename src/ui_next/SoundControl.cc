@@ -7,6 +7,7 @@
 #include <QMessageBox>
 #include <QComboBox>
 #include <QProgressBar>
+#include <QTimer>
 #include <QVBoxLayout>
 
 // directly copied from Qt example
@@ -36,12 +37,16 @@ class SoundAnalysisWorker : public QObject {
   Q_OBJECT
 
 public:
-  SoundAnalysisWorker() = default;
+  SoundAnalysisWorker(cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>> *volumeLevelsBuffer,
+                      std::atomic<int> *latestLevel)
+    : m_VolumeLevelsBuffer(volumeLevelsBuffer),
+      m_LatestLevel(latestLevel),
+      m_VolumeLevels(0.0)
+  {}
 
 signals:
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "NotImplementedFunctions"
-  void SampleReady(qreal sample);
   void SoundAnalysisError(QString const& reason);
 #pragma clang diagnostic pop
 
@@ -65,11 +70,14 @@ public slots:
       static const qint64 BufferSize = 4096;
       const qint64 len = qMin(m_AudioSource->bytesAvailable(), BufferSize);
 
-      QByteArray buffer(len, 0);
-      qint64 l = io->read(buffer.data(), len);
+      m_ReadBuffer.resize(len);
+      qint64 l = io->read(m_ReadBuffer.data(), len);
       if (l > 0) {
-        const qreal level = calculateLevel(format, buffer.constData(), l);
-        emit SampleReady(level);
+        const qreal level = calculateLevel(format, m_ReadBuffer.constData(), l);
+        m_LatestLevel->store(static_cast<int>(level * 100.0), std::memory_order_relaxed);
+        m_VolumeLevels.PopFront();
+        m_VolumeLevels.PushBack(level * 1.5);
+        m_VolumeLevelsBuffer->Publish(m_VolumeLevels);
       }
     });
   }
@@ -80,13 +88,17 @@ public slots:
 
 private:
   std::unique_ptr<QAudioSource> m_AudioSource;
+  QByteArray m_ReadBuffer;
+
+  cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>> *m_VolumeLevelsBuffer;
+  std::atomic<int> *m_LatestLevel;
+  cw::CircularBuffer<qreal, 160> m_VolumeLevels;
 };
 
-SoundControl::SoundControl(cw::CircularBuffer<qreal, 160> *volumeLevels,
-                           bool *volumeLevelsUpdated,
+SoundControl::SoundControl(cw::SnapshotBuffer<cw::CircularBuffer<qreal, 160>> *volumeLevels,
                            QThread *workerThread)
   : m_VolumeLevels(volumeLevels),
-    m_VolumeLevelsUpdated(volumeLevelsUpdated),
+    m_LatestLevel(0),
     m_DeviceSelect(new QComboBox()),
     m_VolumeLevel(new QProgressBar()),
     m_MediaDevices(new QMediaDevices(this)),
@@ -99,14 +111,20 @@ SoundControl::SoundControl(cw::CircularBuffer<qreal, 160> *volumeLevels,
   m_VolumeLevel->setValue(0);
   m_VolumeLevel->setTextVisible(false);
 
-  SoundAnalysisWorker *worker = new SoundAnalysisWorker();
+  SoundAnalysisWorker *worker = new SoundAnalysisWorker(m_VolumeLevels, &m_LatestLevel);
   worker->moveToThread(m_WorkerThread);
 
   connect(this, &SoundControl::StartAnalysis, worker, &SoundAnalysisWorker::StartAnalysis);
   connect(this, &SoundControl::StopAnalysis, worker, &SoundAnalysisWorker::StopAnalysis);
-  connect(worker, &SoundAnalysisWorker::SampleReady, this, &SoundControl::HandleSample);
   connect(worker, &SoundAnalysisWorker::SoundAnalysisError, this, &SoundControl::HandleError);
 
+  // samples go straight to the renderer, the level meter only needs polling
+  QTimer *levelTimer = new QTimer(this);
+  levelTimer->setInterval(50);
+  levelTimer->setTimerType(Qt::CoarseTimer);
+  connect(levelTimer, &QTimer::timeout, this, &SoundControl::UpdateLevelMeter);
+  levelTimer->start();
+
   connect(m_MediaDevices, &QMediaDevices::audioInputsChanged, this, &SoundControl::ReloadAudioDevices);
   connect(m_MediaDevices, &QMediaDevices::audioInputsChanged, this, &SoundControl::StopAnalysis);
 
@@ -149,11 +167,10 @@ void SoundControl::ReloadAudioDevices() {
   m_DeviceSelect->setCurrentIndex(0);
 }
 
-void SoundControl::HandleSample(qreal sample) {
-  m_VolumeLevel->setValue(static_cast<int>(sample * 100.0));
-  m_VolumeLevels->PopFront();
-  m_VolumeLevels->PushBack(sample * 1.5);
-  *m_VolumeLevelsUpdated = true;
+void SoundControl::UpdateLevelMeter() {
+  if (isVisible()) {
+    m_VolumeLevel->setValue(m_LatestLevel.load(std::memory_order_relaxed));
+  }
 }
 
 void SoundControl::HandleError(const QString &reason) {
@@ -5,7 +5,7 @@
 #include <QLabel>
 #include "TrackControlImpl.h"
 
-TrackControl::TrackControl(wgc0310::HeadStatus *headStatus,
+TrackControl::TrackControl(wgc0310::HeadStatusBuffer *headStatus,
                            wgc0310::ScreenDisplayMode *screenDisplayMode,
                            QThread *workerThread)
   : CloseSignallingWidget(nullptr, Qt::Window),
@@ -8,5 +8,5 @@ void MPTrackControl::HandleError(const QString& error) {
 }
 
 void MPTrackControl::HandleHeadStatus(wgc0310::HeadStatus headStatus) {
-  *m_HeadStatus = headStatus;
+  m_HeadStatus->Publish(headStatus, wgc0310::TrackerWriter);
 }
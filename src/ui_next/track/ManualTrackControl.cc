@@ -13,9 +13,9 @@ using wgc0310::ScreenDisplayMode;
 
 class ManualTrackWidget : public QWidget {
 public:
-  explicit ManualTrackWidget(wgc0310::HeadStatus *headStatus,
+  explicit ManualTrackWidget(wgc0310::HeadStatusBuffer *headStatusBuffer,
                              wgc0310::ScreenDisplayMode *screenDisplayMode)
-    : m_HeadStatus(headStatus),
+    : m_HeadStatusBuffer(headStatusBuffer),
       m_ScreenDisplayMode(screenDisplayMode)
   {
     this->setSizePolicy(QSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed));
@@ -38,14 +38,14 @@ public:
       painter.drawRect(100, 100, 300, 300);
       painter.drawRect(245, 245, 10, 10);
 
-      if (m_HeadStatus->mouthStatus == HeadStatus::MouthStatus::Close) {
+      if (m_HeadStatus.mouthStatus == HeadStatus::MouthStatus::Close) {
         painter.setBrush(QColor(0, 0xcd, 0));
       } else {
         painter.setBrush(QColor(0xcd, 0, 0));
       }
 
-      painter.drawEllipse(static_cast<int>(m_HeadStatus->rotationZ * -10.0) + 242,
-                          static_cast<int>(m_HeadStatus->rotationX * -10.0) + 242,
+      painter.drawEllipse(static_cast<int>(m_HeadStatus.rotationZ * -10.0) + 242,
+                          static_cast<int>(m_HeadStatus.rotationX * -10.0) + 242,
                           16,
                           16);
 
@@ -54,8 +54,8 @@ public:
       } else {
         painter.setBrush(QColor(0xcd, 0, 0));
       }
-      painter.drawEllipse(static_cast<int>(m_HeadStatus->rotationZ * -10.0) + 245,
-                          static_cast<int>(m_HeadStatus->rotationX * -10.0) + 245,
+      painter.drawEllipse(static_cast<int>(m_HeadStatus.rotationZ * -10.0) + 245,
+                          static_cast<int>(m_HeadStatus.rotationX * -10.0) + 245,
                           10,
                           10);
     }
@@ -68,7 +68,8 @@ public:
         update();
         return;
       case Qt::Key_W:
-        m_HeadStatus->mouthStatus = cw::FlipEnum(m_HeadStatus->mouthStatus);
+        m_HeadStatus.mouthStatus = cw::FlipEnum(m_HeadStatus.mouthStatus);
+        m_HeadStatusBuffer->Publish(m_HeadStatus, wgc0310::ManualWriter);
         update();
         return;
       case Qt::Key_Escape:
@@ -121,21 +122,23 @@ protected:
       float zRotation = static_cast<float>(dx) / -10.0f;
       float xRotation = static_cast<float>(dy) / -10.0f;
 
-      m_HeadStatus->rotationY = m_HeadStatus->rotationY * 0.5f + yRotation * 0.5f;
-      m_HeadStatus->rotationX = m_HeadStatus->rotationX * 0.5f + xRotation * 0.5f;
-      m_HeadStatus->rotationZ = m_HeadStatus->rotationZ * 0.5f + zRotation * 0.5f;
+      m_HeadStatus.rotationY = m_HeadStatus.rotationY * 0.5f + yRotation * 0.5f;
+      m_HeadStatus.rotationX = m_HeadStatus.rotationX * 0.5f + xRotation * 0.5f;
+      m_HeadStatus.rotationZ = m_HeadStatus.rotationZ * 0.5f + zRotation * 0.5f;
+      m_HeadStatusBuffer->Publish(m_HeadStatus, wgc0310::ManualWriter);
 
       update();
     }
   }
 
 private:
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatusBuffer;
+  wgc0310::HeadStatus m_HeadStatus;
   wgc0310::ScreenDisplayMode *m_ScreenDisplayMode;
 };
 
 
-ManualTrackControl::ManualTrackControl(wgc0310::HeadStatus *headStatus,
+ManualTrackControl::ManualTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                                        wgc0310::ScreenDisplayMode *screenDisplayMode,
                                        QWidget *parent)
   : QWidget(parent),
@@ -19,8 +19,10 @@ class OSFTrackWorker : public QObject {
   Q_OBJECT
 
 public:
-  explicit OSFTrackWorker(QObject *parent = nullptr)
+  explicit OSFTrackWorker(wgc0310::HeadStatusBuffer *headStatus,
+                          QObject *parent = nullptr)
     : QObject(parent),
+      m_HeadStatus(headStatus),
       m_Socket(nullptr),
       m_Parameter(),
       m_SmoothBuffer { wgc0310::HeadStatus {} }
@@ -32,7 +34,6 @@ public:
 signals:
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "NotImplementedFunctions"
-  void HeadPoseUpdated(wgc0310::HeadStatus headPose);
   void TrackingError(QString const& reason);
 #pragma clang diagnostic pop
 
@@ -67,6 +68,7 @@ private slots:
   void HandleData();
 
 private:
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   QUdpSocket *m_Socket;
   OSFTrackParameter2 m_Parameter;
   cw::CircularBuffer<wgc0310::HeadStatus, 128> m_SmoothBuffer;
@@ -234,7 +236,7 @@ void OSFTrackWorker::HandleData() {
     rightEyeSum = 1.0f;
   }
 
-  emit HeadPoseUpdated(wgc0310::HeadStatus {
+  m_HeadStatus->Publish(wgc0310::HeadStatus {
     xSum,
     ySum,
     -zSum,
@@ -243,7 +245,7 @@ void OSFTrackWorker::HandleData() {
     1.0f, 1.0f,
     mouthStatus > 0 ? wgc0310::HeadStatus::MouthStatus::Open
                     : wgc0310::HeadStatus::MouthStatus::Close
-  });
+  }, wgc0310::TrackerWriter);
 }
 
 static QDoubleSpinBox *createAngleSpinBox(double value) {
@@ -254,14 +256,14 @@ static QDoubleSpinBox *createAngleSpinBox(double value) {
   return ret;
 }
 
-OSFTrackControl::OSFTrackControl(wgc0310::HeadStatus *headStatus,
+OSFTrackControl::OSFTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                                  QThread *workerThread,
                                  QWidget *parent)
   : QWidget(parent),
     m_HeadStatus(headStatus),
     m_WorkerThread(workerThread)
 {
-  OSFTrackWorker *worker = new OSFTrackWorker();
+  OSFTrackWorker *worker = new OSFTrackWorker(m_HeadStatus);
   worker->moveToThread(workerThread);
 
   connect(this, &OSFTrackControl::StartTracking,
@@ -272,8 +274,6 @@ OSFTrackControl::OSFTrackControl(wgc0310::HeadStatus *headStatus,
           worker, &OSFTrackWorker::SetParameter);
   connect(worker, &OSFTrackWorker::TrackingError,
           this, &OSFTrackControl::HandleError);
-  connect(worker, &OSFTrackWorker::HeadPoseUpdated,
-          this, &OSFTrackControl::HandleHeadStatus);
 
   QVBoxLayout *layout = new QVBoxLayout(this);
 
@@ -387,8 +387,4 @@ void OSFTrackControl::HandleError(const QString& error) {
   QMessageBox::warning(this, "OSF 面部捕捉错误", error);
 }
 
-void OSFTrackControl::HandleHeadStatus(wgc0310::HeadStatus headStatus) {
-  *m_HeadStatus = headStatus;
-}
-
 #include "OSFTrackControl.moc"
@@ -10,7 +10,7 @@ class VTSTrackControl : public QWidget {
   Q_OBJECT
 
 public:
-  VTSTrackControl(wgc0310::HeadStatus *headStatus,
+  VTSTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                   QThread *workerThread,
                   QWidget *parent = nullptr);
 
@@ -23,10 +23,9 @@ signals:
 
 public slots:
   void HandleError(const QString& error);
-  void HandleHeadStatus(wgc0310::HeadStatus headStatus);
 
 private:
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   QThread *m_WorkerThread;
 };
 
@@ -44,7 +43,7 @@ class OSFTrackControl final : public QWidget {
   Q_OBJECT
 
 public:
-  OSFTrackControl(wgc0310::HeadStatus *headStatus,
+  OSFTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                   QThread *workerThread,
                   QWidget *parent = nullptr);
   ~OSFTrackControl() noexcept final;
@@ -59,10 +58,9 @@ signals:
 
 public slots:
   void HandleError(const QString& error);
-  void HandleHeadStatus(wgc0310::HeadStatus headStatus);
 
 private:
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   QThread *m_WorkerThread;
 };
 
@@ -76,7 +74,7 @@ public slots:
   void HandleHeadStatus(wgc0310::HeadStatus headStatus);
 
 private:
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   wgc0310::BodyStatus *m_BodyStatus;
   QThread *m_WorkerThread;
 };
@@ -85,12 +83,12 @@ class ManualTrackControl : public QWidget {
   Q_OBJECT
 
 public:
-  ManualTrackControl(wgc0310::HeadStatus *headStatus,
+  ManualTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                      wgc0310::ScreenDisplayMode *screenDisplayMode,
                      QWidget *parent = nullptr);
 
 private:
-  wgc0310::HeadStatus *m_HeadStatus;
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   wgc0310::ScreenDisplayMode *m_ScreenDisplayMode;
 };
 
@@ -21,7 +21,8 @@ class VTSTrackWorker : public QObject {
   Q_OBJECT
 
 public:
-  VTSTrackWorker() :
+  explicit VTSTrackWorker(wgc0310::HeadStatusBuffer *headStatus) :
+    m_HeadStatus(headStatus),
     m_Websocket(nullptr),
     m_Timer(nullptr),
     m_LastRequestId(0),
@@ -35,7 +36,6 @@ public:
 signals:
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "NotImplementedFunctions"
-  void HeadPoseUpdated(wgc0310::HeadStatus headPose);
   void TrackingError(QString const& reason);
 #pragma clang diagnostic pop
 
@@ -256,7 +256,7 @@ private slots:
     ySum /= smoothBufferSize;
     zSum /= smoothBufferSize;
 
-    emit HeadPoseUpdated(wgc0310::HeadStatus {
+    m_HeadStatus->Publish(wgc0310::HeadStatus {
       xSum,
       ySum,
       zSum,
@@ -265,12 +265,13 @@ private slots:
       1.0f, 1.0f,
       mouthStatus > 0 ? wgc0310::HeadStatus::MouthStatus::Open
                       : wgc0310::HeadStatus::MouthStatus::Close
-    });
+    }, wgc0310::TrackerWriter);
 
     m_LastResponseId = responseId;
   }
 
 private:
+  wgc0310::HeadStatusBuffer *m_HeadStatus;
   QWebSocket *m_Websocket;
   QTimer *m_Timer;
 
@@ -280,14 +281,14 @@ private:
   cw::CircularBuffer<wgc0310::HeadStatus, 4> m_SmoothBuffer;
 };
 
-VTSTrackControl::VTSTrackControl(wgc0310::HeadStatus *headStatus,
+VTSTrackControl::VTSTrackControl(wgc0310::HeadStatusBuffer *headStatus,
                                  QThread *workerThread,
                                  QWidget *parent)
   : QWidget(parent),
     m_HeadStatus(headStatus),
     m_WorkerThread(workerThread)
 {
-  VTSTrackWorker *worker = new VTSTrackWorker();
+  VTSTrackWorker *worker = new VTSTrackWorker(m_HeadStatus);
   worker->moveToThread(workerThread);
 
   connect(this, &VTSTrackControl::StartTracking,
@@ -296,8 +297,6 @@ VTSTrackControl::VTSTrackControl(wgc0310::HeadStatus *headStatus,
           worker, &VTSTrackWorker::StopCommunication);
   connect(worker, &VTSTrackWorker::TrackingError,
           this, &VTSTrackControl::HandleError);
-  connect(worker, &VTSTrackWorker::HeadPoseUpdated,
-          this, &VTSTrackControl::HandleHeadStatus);
 
   QVBoxLayout *layout = new QVBoxLayout(this);
 
@@ -352,8 +351,4 @@ void VTSTrackControl::HandleError(const QString &error) {
   QMessageBox::warning(this, "VTS 面部捕捉错误", error);
 }
 
-void VTSTrackControl::HandleHeadStatus(wgc0310::HeadStatus headStatus) {
-  *m_HeadStatus = headStatus;
-}
-
 #include "VTSTrackControl.moc"
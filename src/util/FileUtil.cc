@@ -2,10 +2,15 @@
 
 #include <QDebug>
 #include <QFile>
+#include <QResource>
 #include <QTextStream>
 
 namespace cw {
 
+static bool IsResourcePath(QString const& fileName) {
+  return fileName.startsWith(QStringLiteral(":/"));
+}
+
 bool IsFileExists(QString const& fileName) {
   return QFile::exists(fileName);
 }
@@ -23,6 +28,27 @@ QString ReadToString(QString const& fileName) {
   return textStream.readAll();
 }
 
+QByteArray ReadToBytes(QString const& fileName) {
+  if (IsResourcePath(fileName)) {
+    QResource resource(fileName);
+    // resource data lives as long as the program
+    if (resource.isValid() && resource.compressionAlgorithm() == QResource::NoCompression) {
+      return QByteArray::fromRawData(reinterpret_cast<char const*>(resource.data()),
+                                     static_cast<qsizetype>(resource.size()));
+    }
+  }
+
+  QFile f(fileName);
+  f.open(QIODevice::ReadOnly);
+  if (!f.isOpen()) {
+    qCritical() << "ReadToBytes(QString const&): cannot read from file"
+                << fileName;
+    return {};
+  }
+
+  return f.readAll();
+}
+
 bool WriteToFile(const QString &fileName, const QString &content) {
   QFile f(fileName);
   f.open(QIODevice::WriteOnly);
@@ -33,4 +59,62 @@ bool WriteToFile(const QString &fileName, const QString &content) {
   return f.error() == QFileDevice::NoError;
 }
 
+MappedFile::MappedFile(QString const& fileName)
+  : m_File(fileName),
+    m_Mapped(nullptr),
+    m_Data(nullptr),
+    m_Size(0)
+{}
+
+MappedFile::~MappedFile() {
+  if (m_Mapped) {
+    m_File.unmap(m_Mapped);
+  }
+}
+
+std::unique_ptr<MappedFile> MappedFile::Open(QString const& fileName) {
+  std::unique_ptr<MappedFile> ret { new MappedFile(fileName) };
+
+  if (IsResourcePath(fileName)) {
+    QResource resource(fileName);
+    if (!resource.isValid()) {
+      qCritical() << "MappedFile::Open(QString const&): cannot read from file"
+                  << fileName;
+      return nullptr;
+    }
+
+    if (resource.compressionAlgorithm() == QResource::NoCompression) {
+      ret->m_Data = reinterpret_cast<char const*>(resource.data());
+      ret->m_Size = static_cast<std::size_t>(resource.size());
+    } else {
+      ret->m_Buffer = resource.uncompressedData();
+      ret->m_Data = ret->m_Buffer.constData();
+      ret->m_Size = static_cast<std::size_t>(ret->m_Buffer.size());
+    }
+    return ret;
+  }
+
+  if (!ret->m_File.open(QIODevice::ReadOnly)) {
+    qCritical() << "MappedFile::Open(QString const&): cannot read from file"
+                << fileName;
+    return nullptr;
+  }
+
+  qint64 size = ret->m_File.size();
+  if (size > 0) {
+    ret->m_Mapped = ret->m_File.map(0, size);
+  }
+
+  if (ret->m_Mapped) {
+    ret->m_Data = reinterpret_cast<char const*>(ret->m_Mapped);
+    ret->m_Size = static_cast<std::size_t>(size);
+  } else {
+    // empty files cannot be mapped, neither can files on some devices
+    ret->m_Buffer = ret->m_File.readAll();
+    ret->m_Data = ret->m_Buffer.constData();
+    ret->m_Size = static_cast<std::size_t>(ret->m_Buffer.size());
+  }
+  return ret;
+}
+
 } // namespace cw
@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <QDebug>
+#include "util/StringView.h"
 
 namespace cw {
 
@@ -132,46 +133,51 @@ GENERATE_GET_VALUE2(float, GetFloatValue)
 GENERATE_GET_VALUE2(double, GetDoubleValue)
 GENERATE_GET_VALUE2(bool, GetBoolValue)
 
-IniFileData IniFileData::Parse(QString const& data) {
+static QString ToQString(std::string_view text) {
+  return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+IniFileData IniFileData::Parse(std::string_view data) {
   IniFileData result;
   std::unique_ptr<IniSection> currentSection = nullptr;
 
-  QStringList lines = data.split('\n');
+  data = SkipByteOrderMark(data);
   std::size_t lineNo = 0;
-
-  for (QString const& line : lines) {
+  while (!data.empty()) {
+    std::string_view trimmed = Trim(NextLine(&data));
     lineNo += 1;
-    QString trimmed = line.trimmed();
-    if (trimmed.isEmpty() || trimmed.startsWith(';') || trimmed.startsWith('#')) {
+    if (trimmed.empty() || trimmed.starts_with(';') || trimmed.starts_with('#')) {
       continue;
     }
 
-    if (trimmed.startsWith('[') && trimmed.endsWith(']')) {
-      QString sectionName = trimmed.mid(1, trimmed.size() - 2);
+    if (trimmed.starts_with('[') && trimmed.ends_with(']')) {
+      std::string_view sectionName = trimmed.substr(1, trimmed.size() - 2);
       if (currentSection) {
         result.AddSection(std::move(*currentSection));
       }
       currentSection = std::make_unique<IniSection>(
-        sectionName,
+        ToQString(sectionName),
         SecretInternalsDoNotUseOrYouWillBeFired
       );
     } else {
-      QStringList parts = trimmed.split('=');
-      if (parts.size() != 2) {
-        qWarning() << "IniFileData::Parse(QString const&): Invalid line in ini file at line"
+      std::size_t equalSign = trimmed.find('=');
+      if (equalSign == std::string_view::npos
+          || trimmed.find('=', equalSign + 1) != std::string_view::npos) {
+        qWarning() << "IniFileData::Parse(std::string_view): Invalid line in ini file at line"
                    << lineNo
                    << "(not a key-value pair)";
         continue;
       }
 
       if (!currentSection) {
-        qWarning() << "IniFileData::Parse(QString const&): Invalid line in ini file at line"
+        qWarning() << "IniFileData::Parse(std::string_view): Invalid line in ini file at line"
                    << lineNo
                    << "(cannot add value without a valid section)";
         continue;
       }
 
-      currentSection->AddData(parts[0].trimmed(), parts[1].trimmed());
+      currentSection->AddData(ToQString(Trim(trimmed.substr(0, equalSign))),
+                              ToQString(Trim(trimmed.substr(equalSign + 1))));
     }
   }
 
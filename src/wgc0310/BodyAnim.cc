@@ -2,8 +2,8 @@
 #include "wgc0310/BodyStatus.h"
 
 #include <QDebug>
-#include <QFile>
-#include <QTextStream>
+#include "util/FileUtil.h"
+#include "util/StringView.h"
 
 namespace wgc0310 {
 
@@ -29,49 +29,41 @@ void AnimationSection::ApplyAnimationFrame(BodyStatus *bodyStatus,
   }
 }
 
-#define PARSE_DOUBLE(v, s, r) \
-  double v = (s).toDouble(&(r)); \
-  if (!(r)) { \
+#define PARSE_NUMBER(TYPE, v, s) \
+  TYPE v; \
+  if (!cw::ParseNumber((s), &v)) { \
     qWarning() << "error processing file:" \
                << fileName      \
                << "line:"       \
                << lineNo        \
-               << "(invalid float value)"; \
-    continue; \
-  }
-
-#define PARSE_UINT(v, s, r) \
-  std::size_t v = (s).toUInt(&(r)); \
-  if (!(r)) { \
-    qWarning() << "error processing file:" \
-               << fileName    \
-               << "line:"     \
-               << lineNo      \
-               << "(invalid int value)"; \
+               << "(invalid number)"; \
     continue; \
   }
 
 std::unique_ptr<BodyAnimation> LoadBodyAnimation(const char *fileName) {
-  QFile file(fileName);
-  if (!file.open(QIODevice::ReadOnly)) {
+  std::unique_ptr<cw::MappedFile> file = cw::MappedFile::Open(fileName);
+  if (!file) {
     qWarning() << "cannot open animation file:" << fileName;
     return nullptr;
   }
 
-  QTextStream textStream(&file);
+  std::string_view rest = cw::SkipByteOrderMark(file->GetView());
   std::unique_ptr<BodyAnimation> animation = std::make_unique<BodyAnimation>();
 
   std::size_t lineNo = 0;
-  while (!textStream.atEnd()) {
-    QString line = textStream.readLine().trimmed();
+  while (!rest.empty()) {
+    std::string_view line = cw::Trim(cw::NextLine(&rest));
     lineNo += 1;
 
-    if (line.isEmpty() || line.startsWith('#')) {
+    if (line.empty() || line.starts_with('#')) {
       continue;
     }
 
-    if (line.startsWith("n=")) {
-      animation->SetAnimationName(line.replace("n=", "").trimmed());
+    if (line.starts_with("n=")) {
+      std::string_view name = cw::Trim(line.substr(2));
+      animation->SetAnimationName(
+        QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size()))
+      );
       continue;
     }
 
@@ -80,13 +72,17 @@ std::unique_ptr<BodyAnimation> LoadBodyAnimation(const char *fileName) {
       continue;
     }
 
-    QStringList parts = line.split(' ');
-    if (parts.length() == 4 && (parts[0] == "l" || parts[0] == "r")) {
+    std::string_view parts[4];
+    for (std::string_view &part : parts) {
+      part = cw::NextToken(&line);
+    }
+    if (!parts[3].empty()
+        && cw::NextToken(&line).empty()
+        && (parts[0] == "l" || parts[0] == "r")) {
       bool isLeft = parts[0] == "l";
-      bool success;
-      PARSE_UINT(axisIndex, parts[1], success)
-      PARSE_DOUBLE(rotation, parts[2], success)
-      PARSE_UINT(frameCount, parts[3], success)
+      PARSE_NUMBER(std::size_t, axisIndex, parts[1])
+      PARSE_NUMBER(double, rotation, parts[2])
+      PARSE_NUMBER(std::size_t, frameCount, parts[3])
 
       animation->AddCommand(fileName, lineNo, AnimationCommand {
         .isLeft = isLeft,
@@ -107,8 +103,7 @@ std::unique_ptr<BodyAnimation> LoadBodyAnimation(const char *fileName) {
   return animation;
 }
 
-#undef PARSE_DOUBLE
-#undef PARSE_INT
+#undef PARSE_NUMBER
 
 void BodyAnimation::AddSection() noexcept {
   m_Sections.emplace_back();
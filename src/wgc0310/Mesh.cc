@@ -8,23 +8,20 @@
 
 namespace wgc0310 {
 
-static cw::GLObject
-LoadObjectEx(cw::GLObjectContext *ctx, GLFunctions *f, QString const& objectFile) {
+static QString GetModelBasePath(QString const& objectFile) {
   QString patchPath = QStringLiteral("./patch/model/%1").arg(objectFile);
   if (cw::IsFileExists(patchPath)) {
-    return cw::LoadObject(
-      ctx,
-      f,
-      "./patch/model",
-      objectFile,
-      cw::GlobalConfig::Instance.linearSampling,
-      cw::GlobalConfig::Instance.anisotropyFilter
-    );
+    return QStringLiteral("./patch/model");
   }
+  return QStringLiteral(":/model");
+}
+
+static cw::GLObject
+LoadObjectEx(cw::GLObjectContext *ctx, GLFunctions *f, QString const& objectFile) {
   return cw::LoadObject(
     ctx,
     f,
-    ":/model",
+    GetModelBasePath(objectFile),
     objectFile,
     cw::GlobalConfig::Instance.linearSampling,
     cw::GlobalConfig::Instance.anisotropyFilter
@@ -32,9 +29,33 @@ LoadObjectEx(cw::GLObjectContext *ctx, GLFunctions *f, QString const& objectFile
 }
 
 WGCModel LoadWGCModel(cw::GLObjectContext *ctx, GLFunctions *f) {
-  return {
+  WGCModel model {
     .testObject = LoadObjectEx(ctx, f, "TestObject.obj")
   };
+  ctx->UploadMaterials(f);
+  return model;
+}
+
+void StreamWGCModel(cw::AssetStreamer *streamer,
+                    std::shared_ptr<cw::GLObjectContext> const& ctx,
+                    std::function<void(GLFunctions*, WGCModel&&)> done) {
+  QString objectFile = QStringLiteral("TestObject.obj");
+  cw::StreamObject(
+    streamer,
+    ctx,
+    GetModelBasePath(objectFile),
+    objectFile,
+    cw::GlobalConfig::Instance.linearSampling,
+    cw::GlobalConfig::Instance.anisotropyFilter,
+    [ctx, done](GLFunctions *f, cw::GLObject &&testObject) {
+      ctx->UploadMaterials(f);
+      done(f, WGCModel { .testObject = std::move(testObject) });
+    }
+  );
+}
+
+void WGCModel::Submit(RenderQueue *queue, glm::mat4 const& modelView) const {
+  queue->Submit(&testObject, modelView);
 }
 
 void WGCModel::Delete(GLFunctions *f) {
@@ -0,0 +1,138 @@
+#include "wgc0310/RenderQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <glm/mat4x4.hpp>
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLStateCache.h"
+#include "cwglx/Object/Object.h"
+#include "wgc0310/Shader.h"
+
+namespace wgc0310 {
+
+namespace {
+
+// non-negative floats order the same way as their bit patterns, so the upper
+// 24 bits make a good enough depth key without knowing the depth range
+std::uint64_t QuantizeDepth(GLfloat depth) noexcept {
+  depth = std::max(depth, 0.0f);
+  return std::bit_cast<std::uint32_t>(depth) >> 8;
+}
+
+std::uint64_t ComputeSortKey(RenderPass pass,
+                             cw::GLObject const* object,
+                             GLfloat depth) noexcept {
+  std::uint64_t passBits = static_cast<std::uint64_t>(pass) & 0x3;
+  // one program per pass for now
+  std::uint64_t shaderBits = passBits;
+  std::uint64_t materialBits = object->material->uniformIndex & 0xFFFF;
+  std::uint64_t textureBits = object->material->diffuseTexture
+                              ? object->material->diffuseTexture->GetTextureId() & 0xFFFF
+                              : 0;
+  std::uint64_t depthBits = QuantizeDepth(depth);
+
+  if (pass == RenderPass::Translucent) {
+    return (passBits << 62)
+           | (shaderBits << 56)
+           | ((0xFFFFFF - depthBits) << 32)
+           | (materialBits << 16)
+           | textureBits;
+  }
+
+  return (passBits << 62)
+         | (shaderBits << 56)
+         | (materialBits << 40)
+         | (textureBits << 24)
+         | depthBits;
+}
+
+void BeginPass(GLFunctions *f, RenderPass pass) {
+  if (pass == RenderPass::Translucent) {
+    cw::SetCapability(f, GL_BLEND, true);
+    cw::DepthMask(f, GL_FALSE);
+  } else {
+    cw::SetCapability(f, GL_BLEND, false);
+    cw::DepthMask(f, GL_TRUE);
+  }
+}
+
+} // namespace
+
+void RenderQueue::Clear() noexcept {
+  m_Items.clear();
+}
+
+void RenderQueue::Submit(RenderPass pass, cw::GLObject const* object, GLfloat depth) {
+  m_Items.push_back(DrawItem {
+    .sortKey = ComputeSortKey(pass, object, depth),
+    .pass = pass,
+    .object = object
+  });
+}
+
+void RenderQueue::Submit(cw::GLObject const* object, glm::mat4 const& modelView) {
+  RenderPass pass = object->material->diffuse.a < 1.0f
+                    ? RenderPass::Translucent
+                    : RenderPass::Opaque;
+  // the camera looks down -Z
+  GLfloat depth = -(modelView * glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f }).z;
+  Submit(pass, object, depth);
+}
+
+void RenderQueue::Sort() {
+  std::sort(m_Items.begin(), m_Items.end(),
+            [] (DrawItem const& lhs, DrawItem const& rhs) {
+              return lhs.sortKey < rhs.sortKey;
+            });
+}
+
+void RenderQueue::Execute(GLFunctions *f,
+                          ShaderCollection const& shaders,
+                          glm::mat4 const& modelView) const {
+  if (m_Items.empty()) {
+    return;
+  }
+
+  cw::ShaderProgram const* program = nullptr;
+  cw::ObjectShaderInterface const* uniforms = nullptr;
+  RenderPass currentPass = m_Items.front().pass;
+  cw::Material const* currentMaterial = nullptr;
+
+  for (DrawItem const& item : m_Items) {
+    if (!program || item.pass != currentPass) {
+      currentPass = item.pass;
+      switch (currentPass) {
+        case RenderPass::Opaque:
+          program = &shaders.opaqueShader;
+          uniforms = &shaders.opaqueUniforms;
+          break;
+        case RenderPass::Emissive:
+          program = &shaders.emissiveShader;
+          uniforms = &shaders.emissiveUniforms;
+          break;
+        case RenderPass::Translucent:
+          program = &shaders.translucentShader;
+          uniforms = &shaders.translucentUniforms;
+          break;
+      }
+
+      BeginPass(f, currentPass);
+      program->UseProgram(f);
+      cw::ShaderProgram::SetUniform(f, uniforms->modelView, modelView);
+      // plain material uniforms belong to the program, must be set again
+      currentMaterial = nullptr;
+    }
+
+    if (item.object->material != currentMaterial) {
+      item.object->ApplyMaterial(f, *uniforms);
+      currentMaterial = item.object->material;
+    }
+    item.object->DrawVertices(f);
+  }
+
+  // leave depth writes on, `glClear` depends on it
+  cw::SetCapability(f, GL_BLEND, true);
+  cw::DepthMask(f, GL_TRUE);
+}
+
+} // namespace wgc0310
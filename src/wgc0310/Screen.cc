@@ -1,9 +1,14 @@
 #include "include/wgc0310/Screen.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <QImage>
 #include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
 #include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLStateCache.h"
 #include "cwglx/Base/VertexArrayObject.h"
 #include "cwglx/Base/VertexBufferObject.h"
 #include "cwglx/Base/VertexBufferObjectImpl.h"
@@ -24,24 +29,70 @@ struct ScreenVertex {
 
 using ScreenVertexVBO = CW_DEFINE_VBO_TYPE(ScreenVertex, vertexCoord, texCoord);
 
+static constexpr double SurfaceWidth = 25.0;
+static constexpr double SurfaceHeight = 18.75;
+static constexpr double SurfaceBulb = 1.25;
+
+struct ScreenLevel {
+  GLint columns;
+  GLint rows;
+};
+
+// finest first. ComputeScreenVertices wants even segment counts
+static constexpr std::array<ScreenLevel, 5> ScreenLevels {{
+  { 160, 120 },
+  { 80, 60 },
+  { 40, 30 },
+  { 16, 12 },
+  { 8, 6 }
+}};
+
+// a level is fine enough once none of its quads spans more pixels than this
+static constexpr float PixelsPerQuad = 4.0f;
+
+static constexpr GLushort StripRestartIndex = 0xFFFF;
+
+// render target sizes relative to the nominal screen size, largest first
+static constexpr std::array<float, 5> ResolutionScales {
+  2.0f, 1.0f, 0.5f, 0.25f, 0.125f
+};
+static constexpr std::size_t NominalResolution = 1;
+// frames a smaller render target must have been enough before shrinking
+static constexpr int ShrinkDelay = 45;
+
+struct StripRange {
+  // in indices
+  std::size_t offset = 0;
+  GLsizei count = 0;
+};
+
 class ScreenImpl {
 public:
-  explicit ScreenImpl(GLFunctions *f);
+  ScreenImpl(GLFunctions *f, bool procedural);
   ~ScreenImpl();
 
   bool deleted;
+  bool procedural;
 
+  // left without any buffer attached on the procedural path, core profile
+  // refuses to draw without a vertex array bound
   std::unique_ptr<cw::VertexArrayObject> vao;
   std::unique_ptr<ScreenVertexVBO> vbo;
   std::unique_ptr<cw::ElementBufferObject> ebo;
+  std::array<StripRange, ScreenLevels.size()> strips;
 
   GLuint fbo;
   GLuint screenTextureId;
+  GLsizei width;
+  GLsizei height;
+  std::size_t resolution;
+  int shrinkFrames;
 
   CW_DERIVE_UNCOPYABLE(ScreenImpl)
   CW_DERIVE_UNMOVABLE(ScreenImpl)
 
   void Delete(GLFunctions *f);
+  void AllocateTexture(GLFunctions *f, std::size_t resolution);
 
 private:
   void Initialize3D(GLFunctions *f);
@@ -50,8 +101,13 @@ private:
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cppcoreguidelines-pro-type-member-init"
-ScreenImpl::ScreenImpl(GLFunctions *f)
-  : deleted(false)
+ScreenImpl::ScreenImpl(GLFunctions *f, bool procedural)
+  : deleted(false),
+    procedural(procedural),
+    width(0),
+    height(0),
+    resolution(NominalResolution),
+    shrinkFrames(0)
 {
   Initialize3D(f);
   InitializeTexture(f);
@@ -66,43 +122,58 @@ ScreenImpl::~ScreenImpl() {
 }
 
 void ScreenImpl::Initialize3D(GLFunctions *f) {
-  std::vector<std::vector<glm::vec3>> screenVertices =
-      ComputeScreenVertices(25.0, 18.75, 1.25, 160, 120);
+  vao = std::make_unique<cw::VertexArrayObject>(f);
+  if (procedural) {
+    return;
+  }
 
+  // all levels share one vertex buffer and one index buffer, together they
+  // still fit into 16-bit indices
   std::vector<ScreenVertex> vertices;
-  vertices.reserve(160 * 120);
-  for (int y = 0; y <= 120; y++) {
-    for (int x = 0; x <= 160; x++) {
-      GLfloat u = static_cast<GLfloat>(x) / 160.0f;
-      GLfloat v = static_cast<GLfloat>(y) / 120.0f;
-
-      vertices.push_back(ScreenVertex {
-        .vertexCoord = screenVertices[y][x],
-        .texCoord = glm::vec2 { u, v },
-      });
+  std::vector<GLushort> indices;
+  for (std::size_t level = 0; level < ScreenLevels.size(); level++) {
+    auto [columns, rows] = ScreenLevels[level];
+    std::vector<std::vector<glm::vec3>> screenVertices = ComputeScreenVertices(
+      SurfaceWidth,
+      SurfaceHeight,
+      SurfaceBulb,
+      static_cast<std::size_t>(columns),
+      static_cast<std::size_t>(rows)
+    );
+
+    std::size_t base = vertices.size();
+    for (GLint y = 0; y <= rows; y++) {
+      for (GLint x = 0; x <= columns; x++) {
+        GLfloat u = static_cast<GLfloat>(x) / static_cast<GLfloat>(columns);
+        GLfloat v = static_cast<GLfloat>(y) / static_cast<GLfloat>(rows);
+
+        vertices.push_back(ScreenVertex {
+          .vertexCoord = screenVertices[y][x],
+          .texCoord = glm::vec2 { u, v },
+        });
+      }
     }
-  }
-
-  std::vector<GLuint> indices;
-  indices.reserve(160 * 120 * 2);
-  for (int y = 0; y < 120; y ++) {
-    for (int x = 0; x < 160; x ++) {
-      int pointA = x + y * 161;
-      int pointB = x + (y + 1) * 161;
-      int pointC = (x + 1) + (y + 1) * 161;
-      int pointD = (x + 1) + y * 161;
 
-      indices.push_back(static_cast<GLuint>(pointA));
-      indices.push_back(static_cast<GLuint>(pointB));
-      indices.push_back(static_cast<GLuint>(pointC));
-
-      indices.push_back(static_cast<GLuint>(pointA));
-      indices.push_back(static_cast<GLuint>(pointC));
-      indices.push_back(static_cast<GLuint>(pointD));
+    // one strip per row
+    std::size_t offset = indices.size();
+    for (GLint y = 0; y < rows; y++) {
+      for (GLint x = 0; x <= columns; x++) {
+        std::size_t pointA = base + static_cast<std::size_t>(x + y * (columns + 1));
+        std::size_t pointB = base + static_cast<std::size_t>(x + (y + 1) * (columns + 1));
+
+        indices.push_back(static_cast<GLushort>(pointA));
+        indices.push_back(static_cast<GLushort>(pointB));
+      }
+      indices.push_back(StripRestartIndex);
     }
+
+    strips[level] = StripRange {
+      .offset = offset,
+      .count = static_cast<GLsizei>(indices.size() - offset)
+    };
   }
+  Q_ASSERT(vertices.size() < StripRestartIndex && "screen vertices overflow 16-bit indices");
 
-  vao = std::make_unique<cw::VertexArrayObject>(f);
   vao->Bind(f);
 
   vbo = std::make_unique<ScreenVertexVBO>(f);
@@ -121,21 +192,15 @@ void ScreenImpl::Initialize3D(GLFunctions *f) {
 void ScreenImpl::InitializeTexture(GLFunctions *f) {
   // initialize FBO first
   f->glGenFramebuffers(1, &fbo);
-  f->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  cw::BindFramebuffer(f, GL_FRAMEBUFFER, fbo);
 
   f->glGenTextures(1, &screenTextureId);
-  f->glBindTexture(GL_TEXTURE_2D, screenTextureId);
-  f->glTexImage2D(GL_TEXTURE_2D,
-                  0,
-                  GL_RGB,
-                  640,
-                  480,
-                  0,
-                  GL_RGB,
-                  GL_UNSIGNED_BYTE,
-                  GL_FALSE);
+  AllocateTexture(f, NominalResolution);
+  // the screen is mostly seen smaller than its render target, and at an angle
   f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
   f->glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, screenTextureId, 0);
   GLenum DrawBuffers[1] = {GL_COLOR_ATTACHMENT0};
@@ -150,21 +215,48 @@ void ScreenImpl::InitializeTexture(GLFunctions *f) {
   }
 }
 
+void ScreenImpl::AllocateTexture(GLFunctions *f, std::size_t resolution) {
+  this->resolution = resolution;
+  width = static_cast<GLsizei>(static_cast<float>(ScreenWidth) * ResolutionScales[resolution]);
+  height = static_cast<GLsizei>(static_cast<float>(ScreenHeight) * ResolutionScales[resolution]);
+
+  cw::BindTexture2D(f, screenTextureId);
+  f->glTexImage2D(GL_TEXTURE_2D,
+                  0,
+                  GL_RGB8,
+                  width,
+                  height,
+                  0,
+                  GL_RGB,
+                  GL_UNSIGNED_BYTE,
+                  nullptr);
+  // mipmaps left from the previous size would make the texture incomplete
+  f->glGenerateMipmap(GL_TEXTURE_2D);
+}
+
 void ScreenImpl::Delete(GLFunctions *f) {
   if (!deleted) {
+    if (cw::GLStateCache *cache = cw::GLStateCache::Current()) {
+      cache->ForgetTexture(screenTextureId);
+      cache->ForgetFramebuffer(fbo);
+    }
     f->glDeleteTextures(1, &screenTextureId);
     f->glDeleteFramebuffers(1, &fbo);
 
     vao->Delete(f);
-    vbo->Delete(f);
-    ebo->Delete(f);
+    if (vbo) {
+      vbo->Delete(f);
+    }
+    if (ebo) {
+      ebo->Delete(f);
+    }
 
     deleted = true;
   }
 }
 
-Screen::Screen(GLFunctions *f)
-  : m_Impl(new ScreenImpl(f))
+Screen::Screen(GLFunctions *f, bool procedural)
+  : m_Impl(new ScreenImpl(f, procedural))
 {}
 
 Screen::~Screen() {
@@ -172,24 +264,206 @@ Screen::~Screen() {
 }
 
 void Screen::BeginScreenContext(GLFunctions *f) const noexcept {
-  f->glBindFramebuffer(GL_FRAMEBUFFER, m_Impl->fbo);
-  f->glDisable(GL_DEPTH_TEST);
+  cw::BindFramebuffer(f, GL_FRAMEBUFFER, m_Impl->fbo);
+  cw::SetCapability(f, GL_DEPTH_TEST, false);
+  f->glViewport(0, 0, m_Impl->width, m_Impl->height);
 }
 
 void Screen::DoneScreenContext(GLFunctions *f) const noexcept {
-  Q_UNUSED(this)
-  f->glEnable(GL_DEPTH_TEST);
+  cw::SetCapability(f, GL_DEPTH_TEST, true);
+  // only done when the content changed, cheap compared to drawing it
+  cw::BindTexture2D(f, m_Impl->screenTextureId);
+  f->glGenerateMipmap(GL_TEXTURE_2D);
   // no need to restore frame buffer here, we'll do that somewhere else
 }
 
-void Screen::Draw(GLFunctions *f, cw::ShaderProgram *shaderProgram) const noexcept {
-  f->glActiveTexture(GL_TEXTURE0);
-  f->glBindTexture(GL_TEXTURE_2D, m_Impl->screenTextureId);
-  shaderProgram->SetUniform(f, QStringLiteral("screenTexture"), 0);
+bool Screen::UpdateResolution(GLFunctions *f,
+                              glm::mat4 const& transform,
+                              GLsizei viewportWidth,
+                              GLsizei viewportHeight) {
+  glm::vec2 size;
+  if (!ProjectedSize(transform, viewportWidth, viewportHeight, &size)) {
+    return false;
+  }
+
+  // the smallest render target still covering every pixel of the screen
+  std::size_t wanted = 0;
+  for (std::size_t i = ResolutionScales.size(); i-- > 0;) {
+    if (static_cast<float>(ScreenWidth) * ResolutionScales[i] >= size.x
+        && static_cast<float>(ScreenHeight) * ResolutionScales[i] >= size.y) {
+      wanted = i;
+      break;
+    }
+  }
+
+  if (wanted == m_Impl->resolution) {
+    m_Impl->shrinkFrames = 0;
+    return false;
+  }
+  if (wanted > m_Impl->resolution && ++m_Impl->shrinkFrames < ShrinkDelay) {
+    return false;
+  }
+
+  m_Impl->shrinkFrames = 0;
+  m_Impl->AllocateTexture(f, wanted);
+  return true;
+}
+
+GLsizei Screen::GetWidth() const noexcept {
+  return m_Impl->width;
+}
+
+GLsizei Screen::GetHeight() const noexcept {
+  return m_Impl->height;
+}
+
+float Screen::GetScale() const noexcept {
+  return ResolutionScales[m_Impl->resolution];
+}
+
+// counter-clockwise when looking at the front of the screen
+static std::array<glm::vec4, 4> OutlineCorners(float z) noexcept {
+  float halfWidth = static_cast<float>(SurfaceWidth / 2.0);
+  float halfHeight = static_cast<float>(SurfaceHeight / 2.0);
+  return {
+    glm::vec4 { -halfWidth, -halfHeight, z, 1.0f },
+    glm::vec4 { halfWidth, -halfHeight, z, 1.0f },
+    glm::vec4 { halfWidth, halfHeight, z, 1.0f },
+    glm::vec4 { -halfWidth, halfHeight, z, 1.0f }
+  };
+}
+
+// Width and height of the screen in viewport pixels. Returns false if the
+// screen reaches behind the camera, its size is anyone's guess then
+static bool ProjectedSize(glm::mat4 const& transform,
+                          GLsizei viewportWidth,
+                          GLsizei viewportHeight,
+                          glm::vec2 *size) noexcept {
+  std::array<glm::vec4, 4> corners = OutlineCorners(0.0f);
+
+  glm::vec2 viewport { static_cast<float>(viewportWidth), static_cast<float>(viewportHeight) };
+  glm::vec2 projected[4];
+  for (std::size_t i = 0; i < 4; i++) {
+    glm::vec4 clip = transform * corners[i];
+    if (clip.w <= 0.0f) {
+      return false;
+    }
+    projected[i] = (glm::vec2 { clip } / clip.w * 0.5f + 0.5f) * viewport;
+  }
+
+  size->x = std::max(glm::distance(projected[0], projected[1]),
+                     glm::distance(projected[3], projected[2]));
+  size->y = std::max(glm::distance(projected[0], projected[3]),
+                     glm::distance(projected[1], projected[2]));
+  return true;
+}
+
+static std::size_t PickLevel(glm::mat4 const& transform,
+                             GLsizei viewportWidth,
+                             GLsizei viewportHeight) noexcept {
+  glm::vec2 size;
+  if (!ProjectedSize(transform, viewportWidth, viewportHeight, &size)) {
+    return 0;
+  }
+  auto [width, height] = size;
+
+  for (std::size_t level = ScreenLevels.size() - 1; level > 0; level--) {
+    ScreenLevel const& candidate = ScreenLevels[level];
+    if (static_cast<float>(candidate.columns) * PixelsPerQuad >= width
+        && static_cast<float>(candidate.rows) * PixelsPerQuad >= height) {
+      return level;
+    }
+  }
+  return 0;
+}
+
+bool Screen::IsVisible(glm::mat4 const& transform) const noexcept {
+  Q_UNUSED(this)
+
+  // the surface lies between its flat outline and the same outline moved to
+  // where it bulges the most
+  std::array<glm::vec4, 8> clip;
+  std::array<glm::vec4, 4> back = OutlineCorners(0.0f);
+  std::array<glm::vec4, 4> front = OutlineCorners(static_cast<float>(SurfaceBulb));
+  for (std::size_t i = 0; i < 4; i++) {
+    clip[i] = transform * back[i];
+    clip[i + 4] = transform * front[i];
+  }
+
+  // outside the frustum if every point is beyond the same plane
+  for (glm::length_t axis = 0; axis < 3; axis++) {
+    bool allBelow = true;
+    bool allAbove = true;
+    for (glm::vec4 const& point : clip) {
+      allBelow = allBelow && point[axis] < -point.w;
+      allAbove = allAbove && point[axis] > point.w;
+    }
+    if (allBelow || allAbove) {
+      return false;
+    }
+  }
+
+  // the winding only tells anything if the outline is entirely in front of
+  // the camera
+  for (std::size_t i = 0; i < 4; i++) {
+    if (clip[i].w <= 0.0f) {
+      return true;
+    }
+  }
+
+  float area = 0.0f;
+  for (std::size_t i = 0; i < 4; i++) {
+    glm::vec2 a = glm::vec2 { clip[i] } / clip[i].w;
+    glm::vec2 b = glm::vec2 { clip[(i + 1) % 4] } / clip[(i + 1) % 4].w;
+    area += a.x * b.y - b.x * a.y;
+  }
+  return area > 0.0f;
+}
+
+void Screen::Draw(GLFunctions *f,
+                  ShaderCollection const& shaders,
+                  glm::mat4 const& transform,
+                  GLsizei viewportWidth,
+                  GLsizei viewportHeight) const noexcept {
+  std::size_t level = PickLevel(transform, viewportWidth, viewportHeight);
+  auto [columns, rows] = ScreenLevels[level];
+
+  cw::ShaderProgram const& program = m_Impl->procedural
+                                     ? shaders.proceduralScreenShader
+                                     : shaders.emissiveShader;
+  ScreenShaderInterface const& uniforms = m_Impl->procedural
+                                          ? shaders.proceduralScreenUniforms
+                                          : shaders.emissiveScreenUniforms;
+
+  program.UseProgram(f);
+  cw::ActiveTexture(f, GL_TEXTURE0);
+  cw::BindTexture2D(f, m_Impl->screenTextureId);
+  cw::ShaderProgram::SetUniform(f, uniforms.screenTexture, 0);
 
   m_Impl->vao->Bind(f);
-  f->glDrawElements(GL_TRIANGLES, 120 * 160 * 6, GL_UNSIGNED_INT, nullptr);
-  m_Impl->vao->Unbind(f);
+  if (m_Impl->procedural) {
+    ProceduralScreenShaderInterface const& surface = shaders.proceduralScreenUniforms;
+    cw::ShaderProgram::SetUniform(f,
+                                  surface.screenGeometry,
+                                  glm::vec3 {
+                                    static_cast<float>(SurfaceWidth),
+                                    static_cast<float>(SurfaceHeight),
+                                    static_cast<float>(SurfaceBulb)
+                                  });
+    cw::ShaderProgram::SetUniform(f, surface.screenColumns, columns);
+    cw::ShaderProgram::SetUniform(f, surface.screenRows, rows);
+    f->glDrawArrays(GL_TRIANGLES, 0, columns * rows * 6);
+    return;
+  }
+
+  StripRange const& strip = m_Impl->strips[level];
+  f->glPrimitiveRestartIndex(StripRestartIndex);
+  cw::SetCapability(f, GL_PRIMITIVE_RESTART, true);
+  f->glDrawElements(GL_TRIANGLE_STRIP,
+                    strip.count,
+                    GL_UNSIGNED_SHORT,
+                    reinterpret_cast<void const*>(strip.offset * sizeof(GLushort)));
+  cw::SetCapability(f, GL_PRIMITIVE_RESTART, false);
 }
 
 void Screen::Delete(GLFunctions *f) const noexcept {
@@ -4,6 +4,7 @@
 #include <QWidget>
 #include "cwglx/GL/GLImpl.h"
 #include "cwglx/Base/Texture.h"
+#include "wgc0310/Screen.h"
 
 namespace wgc0310 {
 
@@ -13,9 +14,9 @@ ScreenAnimationStatus::ScreenAnimationStatus()
     m_NeedRewind(false)
   {}
 
-void ScreenAnimationStatus::PlayStaticAnimation(StaticScreenImage *staticScreen) {
+void ScreenAnimationStatus::PlayStaticAnimation(std::shared_ptr<StaticScreenImage const> staticScreen) {
   Reset();
-  this->staticScreen = staticScreen;
+  this->staticScreen = std::move(staticScreen);
 }
 
 void ScreenAnimationStatus::PlayAnimation(WGAPIAnimation *animation) {
@@ -37,7 +38,11 @@ void ScreenAnimationStatus::DrawOnScreen(GLFunctions *f) const noexcept {
       animation->Rewind();
     }
 
-    animation->Draw(f);
+    animation->Draw(f, WGAPIScreenViewport {
+      .width = ScreenWidth,
+      .height = ScreenHeight,
+      .scale = 1.0f
+    });
   }
 }
 
@@ -53,10 +58,11 @@ void ScreenAnimationStatus::Reset() {
   animation = nullptr;
 }
 
-void ScreenAnimationStatus::NextTick() {
+bool ScreenAnimationStatus::NextTick() {
   if (animation) {
-    animation->NextTick();
+    return animation->NextTick();
   }
+  return false;
 }
 
 } // namespace wgc0310
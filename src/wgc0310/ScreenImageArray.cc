@@ -0,0 +1,298 @@
+#include "wgc0310/ScreenImageArray.h"
+
+#include <algorithm>
+#include <QDebug>
+#include "cwglx/GL/GLImpl.h"
+#include "cwglx/GL/GLStateCache.h"
+#include "wgc0310/Screen.h"
+
+namespace wgc0310 {
+
+static constexpr GLsizei InitialLayers = 8;
+static constexpr std::size_t UploadsPerUpdate = 2;
+static constexpr std::size_t LayerSize =
+  static_cast<std::size_t>(ScreenWidth) * static_cast<std::size_t>(ScreenHeight) * 4;
+
+ScreenImageArray::ScreenImageArray(GLFunctions *f, std::size_t budget)
+  : m_TextureId(0),
+    m_CopyFBO(0),
+    m_EmptyVAO(0),
+    m_MaxLayers(0),
+    m_UseClock(0),
+    m_CurrentKey(0),
+    m_Deleted(false)
+{
+  f->glGenFramebuffers(1, &m_CopyFBO);
+  f->glGenVertexArrays(1, &m_EmptyVAO);
+
+  GLint maxLayers = 0;
+  f->glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+  std::size_t budgetLayers = std::max<std::size_t>(budget / LayerSize, 1);
+  m_MaxLayers = static_cast<GLsizei>(
+    std::min(budgetLayers, static_cast<std::size_t>(maxLayers))
+  );
+}
+
+ScreenImageArray::~ScreenImageArray() {
+  if (!m_Deleted) {
+    qWarning() << "ScreenImageArray::~ScreenImageArray():"
+               << "texture array not deleted";
+  }
+}
+
+GLint ScreenImageArray::Use(std::uint64_t key) noexcept {
+  m_CurrentKey = key;
+
+  auto it = m_KeyLayers.find(key);
+  if (it == m_KeyLayers.end()) {
+    return -1;
+  }
+
+  Layer &layer = m_Layers[static_cast<std::size_t>(it->second)];
+  layer.lastUse = ++m_UseClock;
+  return layer.state == LayerState::Ready ? it->second : -1;
+}
+
+bool ScreenImageArray::IsKnown(std::uint64_t key) const noexcept {
+  return m_KeyLayers.contains(key) || m_Loading.contains(key) || m_Failed.contains(key);
+}
+
+void ScreenImageArray::MarkLoading(std::uint64_t key) {
+  m_Loading.insert(key);
+}
+
+bool ScreenImageArray::HasFailed(std::uint64_t key) const noexcept {
+  return m_Failed.contains(key);
+}
+
+bool ScreenImageArray::AddImage(GLFunctions *f, std::uint64_t key, QImage const& image) {
+  if (m_Loading.erase(key) == 0) {
+    return false;
+  }
+  if (image.isNull()) {
+    m_Failed.insert(key);
+    return false;
+  }
+
+  // a prefetched image finding the budget taken by the image on screen is
+  // simply dropped, it gets requested again once it is needed
+  if (m_FreeLayers.empty() && !Grow(f) && !Evict()) {
+    return false;
+  }
+
+  GLint layer = m_FreeLayers.back();
+  m_FreeLayers.pop_back();
+  m_Layers[static_cast<std::size_t>(layer)] = Layer {
+    .state = LayerState::Pending,
+    .key = key,
+    .lastUse = ++m_UseClock
+  };
+  m_KeyLayers.emplace(key, layer);
+
+  // images from `AssetStreamer::RequestImage` already come in the right shape
+  QImage prepared = image;
+  if (prepared.width() != ScreenWidth || prepared.height() != ScreenHeight) {
+    prepared = prepared.scaled(ScreenWidth,
+                               ScreenHeight,
+                               Qt::IgnoreAspectRatio,
+                               Qt::SmoothTransformation);
+  }
+  if (prepared.format() != QImage::Format_RGBA8888) {
+    prepared = prepared.convertToFormat(QImage::Format_RGBA8888);
+  }
+
+  m_PendingUploads.push_back(PendingUpload { layer, std::move(prepared) });
+  return true;
+}
+
+void ScreenImageArray::RemoveImage(std::uint64_t key) {
+  m_Loading.erase(key);
+  m_Failed.erase(key);
+
+  auto it = m_KeyLayers.find(key);
+  if (it == m_KeyLayers.end()) {
+    return;
+  }
+  FreeLayer(it->second);
+  m_KeyLayers.erase(it);
+}
+
+bool ScreenImageArray::Update(GLFunctions *f) {
+  if (m_PendingUploads.empty()) {
+    return false;
+  }
+
+  std::size_t count = std::min(m_PendingUploads.size(), UploadsPerUpdate);
+  f->glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureId);
+  for (std::size_t i = 0; i < count; i++) {
+    PendingUpload const& upload = m_PendingUploads[i];
+    f->glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                       0,
+                       0,
+                       0,
+                       upload.layer,
+                       ScreenWidth,
+                       ScreenHeight,
+                       1,
+                       GL_RGBA,
+                       GL_UNSIGNED_BYTE,
+                       upload.image.constBits());
+    m_Layers[static_cast<std::size_t>(upload.layer)].state = LayerState::Ready;
+  }
+  m_PendingUploads.erase(m_PendingUploads.begin(),
+                         m_PendingUploads.begin() + static_cast<std::ptrdiff_t>(count));
+  return true;
+}
+
+void ScreenImageArray::Draw(GLFunctions *f,
+                            cw::ShaderProgram const& program,
+                            ScreenImageShaderInterface const& uniforms,
+                            GLint layer) const noexcept {
+  if (layer < 0
+      || static_cast<std::size_t>(layer) >= m_Layers.size()
+      || m_Layers[static_cast<std::size_t>(layer)].state != LayerState::Ready) {
+    return;
+  }
+
+  program.UseProgram(f);
+  cw::ActiveTexture(f, GL_TEXTURE0);
+  f->glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureId);
+  cw::ShaderProgram::SetUniform(f, uniforms.screenImages, 0);
+  cw::ShaderProgram::SetUniform(f, uniforms.screenImageLayer, layer);
+
+  cw::BindVertexArray(f, m_EmptyVAO);
+  f->glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void ScreenImageArray::Delete(GLFunctions *f) {
+  if (m_Deleted) {
+    return;
+  }
+
+  if (cw::GLStateCache *cache = cw::GLStateCache::Current()) {
+    cache->ForgetFramebuffer(m_CopyFBO);
+    cache->ForgetVertexArray(m_EmptyVAO);
+  }
+  if (m_TextureId) {
+    f->glDeleteTextures(1, &m_TextureId);
+  }
+  f->glDeleteFramebuffers(1, &m_CopyFBO);
+  f->glDeleteVertexArrays(1, &m_EmptyVAO);
+
+  m_Layers.clear();
+  m_FreeLayers.clear();
+  m_PendingUploads.clear();
+  m_KeyLayers.clear();
+  m_Loading.clear();
+  m_Failed.clear();
+  m_Deleted = true;
+}
+
+bool ScreenImageArray::Grow(GLFunctions *f) {
+  GLsizei oldCapacity = static_cast<GLsizei>(m_Layers.size());
+  if (oldCapacity >= m_MaxLayers) {
+    return false;
+  }
+  GLsizei capacity = oldCapacity == 0
+                     ? std::min(InitialLayers, m_MaxLayers)
+                     : std::min(oldCapacity * 2, m_MaxLayers);
+
+  GLuint textureId = 0;
+  f->glGenTextures(1, &textureId);
+  f->glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+  f->glTexImage3D(GL_TEXTURE_2D_ARRAY,
+                  0,
+                  GL_RGBA8,
+                  ScreenWidth,
+                  ScreenHeight,
+                  capacity,
+                  0,
+                  GL_RGBA,
+                  GL_UNSIGNED_BYTE,
+                  nullptr);
+  // images are drawn at their own size, there's no need for mipmaps
+  f->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+
+  GLenum error = f->glGetError();
+  if (error != GL_NO_ERROR) {
+    qWarning() << "ScreenImageArray::Grow(GLFunctions*):"
+               << "failed allocating"
+               << capacity
+               << "layers, glGetError() ="
+               << error;
+    f->glDeleteTextures(1, &textureId);
+    f->glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureId);
+    return false;
+  }
+
+  if (m_TextureId) {
+    // copied on the GPU, layer by layer, through a framebuffer reading from
+    // the old array. Pending layers get their upload into the new one
+    cw::BindFramebuffer(f, GL_READ_FRAMEBUFFER, m_CopyFBO);
+    for (GLsizei layer = 0; layer < oldCapacity; layer++) {
+      if (m_Layers[static_cast<std::size_t>(layer)].state != LayerState::Ready) {
+        continue;
+      }
+      f->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER,
+                                   GL_COLOR_ATTACHMENT0,
+                                   m_TextureId,
+                                   0,
+                                   layer);
+      f->glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                             0,
+                             0,
+                             0,
+                             layer,
+                             0,
+                             0,
+                             ScreenWidth,
+                             ScreenHeight);
+    }
+    f->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
+    f->glDeleteTextures(1, &m_TextureId);
+  }
+  m_TextureId = textureId;
+
+  m_Layers.resize(static_cast<std::size_t>(capacity));
+  // lowest layers get handed out first
+  for (GLsizei layer = capacity - 1; layer >= oldCapacity; layer--) {
+    m_FreeLayers.push_back(layer);
+  }
+  return true;
+}
+
+bool ScreenImageArray::Evict() {
+  GLint victim = -1;
+  std::uint64_t oldestUse = 0;
+  for (std::size_t i = 0; i < m_Layers.size(); i++) {
+    Layer const& layer = m_Layers[i];
+    if (layer.state == LayerState::Free || layer.key == m_CurrentKey) {
+      continue;
+    }
+    if (victim < 0 || layer.lastUse < oldestUse) {
+      victim = static_cast<GLint>(i);
+      oldestUse = layer.lastUse;
+    }
+  }
+
+  if (victim < 0) {
+    return false;
+  }
+  m_KeyLayers.erase(m_Layers[static_cast<std::size_t>(victim)].key);
+  FreeLayer(victim);
+  return true;
+}
+
+void ScreenImageArray::FreeLayer(GLint layer) {
+  std::erase_if(m_PendingUploads, [layer](PendingUpload const& upload) {
+    return upload.layer == layer;
+  });
+  m_Layers[static_cast<std::size_t>(layer)] = Layer {};
+  m_FreeLayers.push_back(layer);
+}
+
+} // namespace wgc0310
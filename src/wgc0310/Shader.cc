@@ -2,23 +2,43 @@
 
 #include <QDebug>
 #include "cwglx/Base/Shader.h"
+#include "cwglx/Object/ProgramCache.h"
+#include "cwglx/Object/UniformBlock.h"
 #include "util/FileUtil.h"
 
 namespace wgc0310 {
 
 void wgc0310::ShaderCollection::Delete(GLFunctions *f) {
   emissiveShader.Delete(f);
+  proceduralScreenShader.Delete(f);
+  screenImageShader.Delete(f);
+  fxaaShader.Delete(f);
   translucentShader.Delete(f);
   opaqueShader.Delete(f);
 }
 
+static void BindUniformBlocks(GLFunctions *f, cw::ShaderProgram *program) {
+  program->BindUniformBlock(f, cw::FrameBlock::BlockName, cw::FrameBlockBinding);
+  program->BindUniformBlock(f, cw::MaterialBlock::BlockName, cw::MaterialBlockBinding);
+}
+
+// Uniforms are left to the caller, each program has its own interface to
+// resolve once this succeeded
 static bool CompileShaderPair(GLFunctions *f,
                               cw::ShaderProgram *program,
                               QString const& role,
-                              QString const& vs,
-                              QString const& fs,
+                              QByteArray const& vs,
+                              QByteArray const& fs,
                               QString *err = nullptr)
 {
+  // only programs whose text changed since they were last linked, on this
+  // very driver, get compiled from source
+  std::uint64_t sourceHash = cw::HashProgramSource(vs, fs);
+  if (cw::LoadCachedProgram(f, program, sourceHash)) {
+    BindUniformBlocks(f, program);
+    return true;
+  }
+
   auto critical = qCritical().noquote();
 
   program->InitCompilation(f);
@@ -71,6 +91,9 @@ static bool CompileShaderPair(GLFunctions *f,
     goto cleanup;
   }
 
+  BindUniformBlocks(f, program);
+  cw::StoreCachedProgram(f, *program, sourceHash);
+
   success = true;
 cleanup:
   vertexShader.Delete(f);
@@ -79,15 +102,46 @@ cleanup:
 }
 
 static bool CompileCommonShader(GLFunctions *f, ShaderCollection *c, QString *err = nullptr) {
-  auto ret = std::make_unique<ShaderCollection>();
   if (!CompileShaderPair(f, &c->emissiveShader, QStringLiteral("发光体"),
-                         cw::ReadToString(QStringLiteral(":/shader/common/emissive.vert")),
-                         cw::ReadToString(QStringLiteral(":/shader/common/emissive.frag")),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/emissive.vert")),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/emissive.frag")),
                          err))
   {
-    ret->Delete(f);
+    c->Delete(f);
+    return false;
+  }
+  c->emissiveUniforms.Resolve(f, c->emissiveShader);
+  c->emissiveScreenUniforms.Resolve(f, c->emissiveShader);
+
+  if (!CompileShaderPair(f, &c->proceduralScreenShader, QStringLiteral("屏幕"),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/screen.vert")),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/emissive.frag")),
+                         err))
+  {
+    c->Delete(f);
+    return false;
+  }
+  c->proceduralScreenUniforms.Resolve(f, c->proceduralScreenShader);
+
+  if (!CompileShaderPair(f, &c->screenImageShader, QStringLiteral("屏幕静态图像"),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/screen-image.vert")),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/screen-image.frag")),
+                         err))
+  {
+    c->Delete(f);
+    return false;
+  }
+  c->screenImageUniforms.Resolve(f, c->screenImageShader);
+
+  if (!CompileShaderPair(f, &c->fxaaShader, QStringLiteral("FXAA"),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/fxaa.vert")),
+                         cw::ReadToBytes(QStringLiteral(":/shader/common/fxaa.frag")),
+                         err))
+  {
+    c->Delete(f);
     return false;
   }
+  c->fxaaUniforms.Resolve(f, c->fxaaShader);
 
   return true;
 }
@@ -105,6 +159,7 @@ CompileShader(GLFunctions *f, ShaderText const& text, QString *err) {
     ret->Delete(f);
     return nullptr;
   }
+  ret->opaqueUniforms.Resolve(f, ret->opaqueShader);
 
   if (!CompileShaderPair(f, &ret->translucentShader, QStringLiteral("半透明体"),
                          text.translucentVS, text.translucentFS, err))
@@ -112,27 +167,28 @@ CompileShader(GLFunctions *f, ShaderText const& text, QString *err) {
     ret->Delete(f);
     return nullptr;
   }
+  ret->translucentUniforms.Resolve(f, ret->translucentShader);
 
   return ret;
 }
 
 ShaderText GetStandardShaderText() {
   return ShaderText {
-    .opaqueVS = cw::ReadToString(QStringLiteral(":/shader/standard/opaque.vert")),
-    .opaqueFS = cw::ReadToString(QStringLiteral(":/shader/standard/opaque.frag")),
-    .translucentVS = cw::ReadToString(QStringLiteral(":/shader/standard/translucent.vert")),
-    .translucentFS = cw::ReadToString(QStringLiteral(":/shader/standard/translucent.frag"))
+    .opaqueVS = cw::ReadToBytes(QStringLiteral(":/shader/standard/opaque.vert")),
+    .opaqueFS = cw::ReadToBytes(QStringLiteral(":/shader/standard/opaque.frag")),
+    .translucentVS = cw::ReadToBytes(QStringLiteral(":/shader/standard/translucent.vert")),
+    .translucentFS = cw::ReadToBytes(QStringLiteral(":/shader/standard/translucent.frag"))
   };
 }
 
-static QString GetShaderTextEx(QString const& shaderFileName) {
+static QByteArray GetShaderTextEx(QString const& shaderFileName) {
   QString patchPath = QStringLiteral("./patch/shader/%1").arg(shaderFileName);
   if (cw::IsFileExists(patchPath)) {
-    return cw::ReadToString(patchPath);
+    return cw::ReadToBytes(patchPath);
   }
 
   QString builtinPath = QStringLiteral(":/shader/standard/%1").arg(shaderFileName);
-  return cw::ReadToString(builtinPath);
+  return cw::ReadToBytes(builtinPath);
 }
 
 ShaderText GetDefaultShaderText() {
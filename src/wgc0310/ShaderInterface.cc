@@ -0,0 +1,27 @@
+#include "wgc0310/ShaderInterface.h"
+
+namespace wgc0310 {
+
+void ScreenShaderInterface::Resolve(GLFunctions *f, cw::ShaderProgram const& program) {
+  screenTexture = program.RequireUniform<GLint>(f, "screenTexture");
+}
+
+void ProceduralScreenShaderInterface::Resolve(GLFunctions *f,
+                                              cw::ShaderProgram const& program) {
+  ScreenShaderInterface::Resolve(f, program);
+  screenGeometry = program.RequireUniform<glm::vec3>(f, "screenGeometry");
+  screenColumns = program.RequireUniform<GLint>(f, "screenColumns");
+  screenRows = program.RequireUniform<GLint>(f, "screenRows");
+}
+
+void ScreenImageShaderInterface::Resolve(GLFunctions *f, cw::ShaderProgram const& program) {
+  screenImages = program.RequireUniform<GLint>(f, "screenImages");
+  screenImageLayer = program.RequireUniform<GLint>(f, "screenImageLayer");
+}
+
+void FXAAShaderInterface::Resolve(GLFunctions *f, cw::ShaderProgram const& program) {
+  sceneTexture = program.RequireUniform<GLint>(f, "sceneTexture");
+  sceneTexelSize = program.RequireUniform<glm::vec2>(f, "sceneTexelSize");
+}
+
+} // namespace wgc0310